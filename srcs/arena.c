@@ -0,0 +1,79 @@
+#include "ssu_ext2.h"
+
+/**
+ * 크기를 정렬 단위로 올림하는 함수
+ */
+static size_t	arena_align(size_t size)
+{
+	return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+/**
+ * 아레나 초기화 함수 (청크는 첫 할당 때 만듦)
+ *
+ * @param arena 초기화할 아레나 포인터
+ * @param chunk_bytes 청크 하나의 크기
+ */
+void	arena_init(Arena *arena, size_t chunk_bytes)
+{
+	memset(arena, 0, sizeof(Arena));
+	arena->chunk_bytes = chunk_bytes < ARENA_MIN_CHUNK ? ARENA_MIN_CHUNK : chunk_bytes;
+}
+
+/**
+ * 아레나에서 메모리를 할당하는 함수
+ * 현재 청크에 남은 공간이 있으면 포인터만 옮기고, 없으면 새 청크를 붙임
+ * 청크보다 큰 요청은 그 크기만큼의 전용 청크를 만듦
+ *
+ * @param arena 아레나 포인터
+ * @param size 할당할 바이트 수
+ * @return 할당된 메모리 포인터, 실패 시 NULL
+ */
+void	*arena_alloc(Arena *arena, size_t size)
+{
+	size = arena_align(size);
+
+	ArenaChunk *chunk = arena->chunks;
+	if (chunk == NULL || chunk->size - chunk->used < size) {
+		size_t data_size = size > arena->chunk_bytes ? size : arena->chunk_bytes;
+		chunk = (ArenaChunk *)malloc(sizeof(ArenaChunk) + data_size);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		chunk->size = data_size;
+		chunk->used = 0;
+		chunk->next = arena->chunks;
+		arena->chunks = chunk;
+		arena->chunk_count++;
+		arena->reserved_bytes += data_size;
+		if (arena->reserved_bytes > arena->peak_bytes) {
+			arena->peak_bytes = arena->reserved_bytes;
+		}
+	}
+
+	void *ptr = chunk->data + chunk->used;
+	chunk->used += size;
+	arena->used_bytes += size;
+	return ptr;
+}
+
+/**
+ * 아레나의 모든 청크를 해제하는 함수 (아레나에서 할당한 포인터는 모두 무효가 됨)
+ * peak_bytes는 보고용으로 남겨 둠
+ *
+ * @param arena 해제할 아레나 포인터
+ */
+void	arena_release(Arena *arena)
+{
+	ArenaChunk *chunk = arena->chunks;
+	while (chunk != NULL) {
+		ArenaChunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	arena->chunks = NULL;
+	arena->chunk_count = 0;
+	arena->reserved_bytes = 0;
+	arena->used_bytes = 0;
+}
@@ -0,0 +1,938 @@
+#include "../ssu_ext2.h"
+#include <sys/resource.h>
+
+/*
+ * tree, print, 경로 탐색 벤치마크 실행기
+ * 시나리오마다 ssu_ext2를 --stats로 새 프로세스로 띄워 명령어를 보내고, 명령어마다 표준 에러로 나오는
+ * 실행 통계에서 읽은 블록과 바이트를 (mmap 경로의 매핑 참조 포함), 끝난 프로세스(좀비 상태)의
+ * /proc/<pid>/io와 rusage로 입출력 시스템 콜 수, 최대 RSS를 잼
+ * 최대 RSS는 mmap으로 접근한 이미지 페이지를 포함하므로, --no-mmap 변형 시나리오로 힙 사용량을 따로 봄
+ * cold는 실행 전마다 이미지의 페이지 캐시를 비우고(POSIX_FADV_DONTNEED), warm은 한 번 실행해서 데운 뒤 잼
+ * 결과는 JSON으로 기록하고, 이미지별 기준 결과(baseline)로 저장해 두었다가 새 빌드와 비교할 수 있음
+ * 비교에서 중앙값 시간이나 최대 RSS가 임계값보다 나빠진 시나리오가 있으면 종료 코드 2로 실패
+ */
+
+#define BENCH_MAX_ITERATIONS 100
+#define BENCH_MAX_SSU_ARGS 16
+#define BENCH_DEEP_PATH_LEVELS 200		// path_resolve 시나리오의 경로 깊이 (deep.img는 1000단계)
+#define BENCH_REGRESSION_EXIT 2			// 비교에서 성능이 나빠졌을 때 종료 코드
+
+/**
+ * 벤치마크 시나리오 구조체
+ */
+typedef struct bench_scenario {
+	const char *name;
+	const char *image;				// 이미지 디렉토리 기준 파일 이름
+	const char *command;			// 세션에 보낼 명령어 ("%s"는 깊은 경로로 치환)
+	unsigned int repeat;			// 한 세션에서 명령어를 반복하는 횟수
+	const char *ssu_arg;			// 이 시나리오만 ssu_ext2에 더 넘길 옵션 (NULL이면 없음)
+} BenchScenario;
+
+static const BenchScenario	scenarios[] = {
+	{ "tree_flat",         "wide.img",     "tree /wide",                      1,    NULL },
+	{ "tree_flat_sp",      "wide.img",     "tree /wide -s -p",                1,    NULL },
+	{ "tree_wide_r",       "wide.img",     "tree /wide -r -s -p",             1,    NULL },
+	{ "tree_deep_r",       "deep.img",     "tree /deep -r",                   1,    NULL },
+	{ "tree_r",            "tree.img",     "tree /tree -r",                   1,    NULL },
+	{ "tree_r_sp",         "tree.img",     "tree /tree -r -s -p",             1,    NULL },
+	{ "tree_r_nommap",     "tree.img",     "tree /tree -r",                   1,    "--no-mmap" },
+	{ "tree_r_groups",     "groups.img",   "tree / -r -s -p",                 1,    NULL },
+	{ "print_small",       "indirect.img", "print /files/small.txt",          200,  NULL },
+	{ "print_huge",        "indirect.img", "print /files/big.txt",            1,    NULL },
+	{ "print_huge_nommap", "indirect.img", "print /files/big.txt",            1,    "--no-mmap" },
+	{ "print_huge_n",      "indirect.img", "print /files/big.txt -n 100000",  1,    NULL },
+	{ "print_sparse",      "indirect.img", "print /files/sparse.bin",         1,    NULL },
+	{ "path_resolve",      "deep.img",     "print %s/file0.txt -n 1",         500,  NULL },
+	{ "path_cold",         "deep.img",     "print %s/file0.txt -n 1",         1,    NULL },
+};
+
+#define BENCH_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+/**
+ * 실행 옵션 구조체
+ */
+typedef struct bench_options {
+	const char *binary;				// ssu_ext2 경로
+	const char *images;				// 이미지 디렉토리
+	const char *output;				// JSON 출력 파일 (NULL이면 표준 출력)
+	const char *label;				// 결과에 남길 빌드 설명
+	const char *filter;				// 이름에 이 문자열이 들어간 시나리오만 실행
+	unsigned int iterations;
+	bool cold;
+	bool warm;
+	const char *ssu_args[BENCH_MAX_SSU_ARGS];	// ssu_ext2에 그대로 넘길 옵션
+	int ssu_arg_count;
+	const char *baseline_dir;		// 이미지별 기준 결과 디렉토리
+	bool save_baseline;				// 결과를 기준 결과로 저장 (같은 시나리오만 교체)
+	bool compare;					// 기준 결과와 비교
+	double threshold;				// 중앙값 시간 허용 증가율 (%)
+	double rss_threshold;			// 최대 RSS 허용 증가율 (%)
+	double min_delta_ms;			// 이보다 작은 시간 차이는 증가율과 관계없이 허용 (짧은 시나리오의 잡음)
+} BenchOptions;
+
+/**
+ * 실행 한 번의 측정값 구조체
+ */
+typedef struct bench_sample {
+	unsigned long long wall_ns;
+	unsigned long long blocks;		// ssu_ext2 실행 통계의 읽은 블록 수 합 (mmap 경로의 매핑 참조 포함)
+	unsigned long long stat_kb;		// ssu_ext2 실행 통계의 읽은 KB 합
+	unsigned long long wchar;		// 쓰기 시스템 콜로 쓴 바이트 (출력)
+	unsigned long long syscr;		// 읽기 계열 시스템 콜 수
+	unsigned long long syscw;		// 쓰기 계열 시스템 콜 수
+	unsigned long long read_bytes;	// 실제 저장 장치에서 읽은 바이트
+	unsigned long long minflt;
+	unsigned long long majflt;
+	unsigned long long maxrss_kb;
+	bool ok;
+} BenchSample;
+
+/**
+ * 실행 결과 요약 구조체 (측정값별 중앙값, RSS는 최댓값)
+ */
+typedef struct bench_summary {
+	double wall_min_ms;
+	double wall_median_ms;
+	double wall_mean_ms;
+	double wall_max_ms;
+	unsigned long long blocks_read;
+	unsigned long long bytes_read;
+	unsigned long long storage_bytes_read;
+	unsigned long long output_bytes;
+	unsigned long long io_syscalls;
+	unsigned long long page_faults;
+	unsigned long long peak_rss_kb;
+	bool rss_has_map;				// 최대 RSS에 mmap으로 접근한 이미지 페이지가 포함되는지 여부
+	unsigned int failures;
+} BenchSummary;
+
+/**
+ * 시나리오 하나의 캐시 상태별 결과 구조체
+ */
+typedef struct bench_result {
+	const BenchScenario *scenario;
+	const char *cache;				// "cold" 또는 "warm"
+	unsigned int block_size;
+	BenchSummary summary;
+} BenchResult;
+
+/**
+ * 현재 시각 (나노초, 단조 시계)
+ */
+static unsigned long long	now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+/**
+ * 이미지 슈퍼블록에서 블록 크기를 읽는 함수
+ *
+ * @return 블록 크기, 실패 시 0
+ */
+static unsigned int	image_block_size(const char *path)
+{
+	struct my_ext2_super_block sb;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		return 0;
+	}
+	ssize_t n = pread(fd, &sb, sizeof(sb), 1024);
+	close(fd);
+	if (n != (ssize_t)sizeof(sb) || sb.s_magic != EXT2_SUPER_MAGIC) {
+		return 0;
+	}
+	return 1024U << sb.s_log_block_size;
+}
+
+/**
+ * 이미지의 페이지 캐시를 비우는 함수 (cold 실행 전)
+ */
+static void	drop_image_cache(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+
+	if (fd >= 0) {
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+}
+
+/**
+ * 세션에 보낼 명령어 스크립트를 임시 파일로 만드는 함수
+ *
+ * @param scenario 시나리오
+ * @return 읽기 위치가 처음으로 돌아간 파일 디스크립터, 실패 시 -1
+ */
+static int	make_script(const BenchScenario *scenario)
+{
+	char deep_path[MAX_PATH];
+	char command[MAX_PATH + 256];
+	char template[] = "/tmp/ssu_bench_XXXXXX";
+	int fd = mkstemp(template);
+
+	if (fd < 0) {
+		return -1;
+	}
+	unlink(template);
+
+	int len = snprintf(deep_path, sizeof(deep_path), "/deep");
+	for (unsigned int level = 1; level <= BENCH_DEEP_PATH_LEVELS; level++) {
+		len += snprintf(deep_path + len, sizeof(deep_path) - len, "/level%04u", level);
+	}
+	int command_len = snprintf(command, sizeof(command), scenario->command, deep_path);
+	command[command_len++] = '\n';
+
+	FILE *script = fdopen(dup(fd), "w");
+	if (script == NULL) {
+		close(fd);
+		return -1;
+	}
+	for (unsigned int i = 0; i < scenario->repeat; i++) {
+		fwrite(command, 1, (size_t)command_len, script);
+	}
+	fputs("exit\n", script);
+	fclose(script);
+
+	lseek(fd, 0, SEEK_SET);
+	return fd;
+}
+
+/**
+ * /proc/<pid>/io에서 필요한 항목을 읽는 함수 (종료했지만 아직 회수하지 않은 프로세스)
+ */
+static void	read_proc_io(pid_t pid, BenchSample *sample)
+{
+	char path[64];
+	char key[32];
+	unsigned long long value;
+
+	snprintf(path, sizeof(path), "/proc/%d/io", (int)pid);
+	FILE *fp = fopen(path, "r");
+	if (fp == NULL) {
+		return;
+	}
+	while (fscanf(fp, "%31[^:]: %llu\n", key, &value) == 2) {
+		if (strcmp(key, "wchar") == 0) sample->wchar = value;
+		else if (strcmp(key, "syscr") == 0) sample->syscr = value;
+		else if (strcmp(key, "syscw") == 0) sample->syscw = value;
+		else if (strcmp(key, "read_bytes") == 0) sample->read_bytes = value;
+	}
+	fclose(fp);
+}
+
+/**
+ * ssu_ext2가 --stats로 표준 에러에 남긴 명령어별 실행 통계에서 읽은 블록과 KB를 더하는 함수
+ * ("stats: <ms> ms (<phases>), <N> blocks, <N> KB, ..." 형식의 줄만 읽음)
+ *
+ * @param fp 표준 에러를 받은 파일 (처음으로 되감음)
+ * @param sample 측정값을 저장할 포인터
+ */
+static void	read_stats_lines(FILE *fp, BenchSample *sample)
+{
+	char line[512];
+	unsigned long long blocks;
+	unsigned long long kb;
+
+	rewind(fp);
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		const char *counters = strstr(line, "), ");
+		if (strncmp(line, "stats: ", 7) != 0 || counters == NULL) {
+			continue;
+		}
+		if (sscanf(counters + 3, "%llu blocks, %llu KB", &blocks, &kb) == 2) {
+			sample->blocks += blocks;
+			sample->stat_kb += kb;
+		}
+	}
+}
+
+/**
+ * ssu_ext2를 한 번 실행하고 측정하는 함수
+ *
+ * @param opts 실행 옵션
+ * @param scenario 시나리오 (시나리오별 옵션)
+ * @param image 이미지 경로
+ * @param script_fd 표준 입력으로 쓸 명령어 스크립트
+ * @param sample 측정값을 저장할 포인터
+ */
+static void	run_once(const BenchOptions *opts, const BenchScenario *scenario, const char *image,
+					 int script_fd, BenchSample *sample)
+{
+	const char *argv[BENCH_MAX_SSU_ARGS + 5];
+	int argc = 0;
+
+	memset(sample, 0, sizeof(BenchSample));
+	argv[argc++] = opts->binary;
+	for (int i = 0; i < opts->ssu_arg_count; i++) {
+		argv[argc++] = opts->ssu_args[i];
+	}
+	if (scenario->ssu_arg != NULL) {
+		argv[argc++] = scenario->ssu_arg;
+	}
+	argv[argc++] = "--stats";
+	argv[argc++] = image;
+	argv[argc] = NULL;
+
+	// 실행 통계 줄은 명령어 반복 수만큼 쌓이므로 파이프 대신 임시 파일로 받음
+	FILE *err = tmpfile();
+	if (err == NULL) {
+		return;
+	}
+
+	lseek(script_fd, 0, SEEK_SET);
+	unsigned long long start = now_ns();
+	pid_t pid = fork();
+	if (pid < 0) {
+		fclose(err);
+		return;
+	}
+	if (pid == 0) {
+		int null_fd = open("/dev/null", O_WRONLY);
+		dup2(script_fd, STDIN_FILENO);
+		dup2(null_fd, STDOUT_FILENO);
+		dup2(fileno(err), STDERR_FILENO);
+		execv(opts->binary, (char *const *)argv);
+		_exit(127);
+	}
+
+	// 회수하기 전에 /proc/<pid>/io를 읽어야 하므로 WNOWAIT으로 종료만 기다림
+	siginfo_t info;
+	while (waitid(P_PID, (id_t)pid, &info, WEXITED | WNOWAIT) < 0 && errno == EINTR) {
+		;
+	}
+	sample->wall_ns = now_ns() - start;
+	read_proc_io(pid, sample);
+
+	struct rusage usage;
+	int status;
+	while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+		;
+	}
+	sample->minflt = (unsigned long long)usage.ru_minflt;
+	sample->majflt = (unsigned long long)usage.ru_majflt;
+	sample->maxrss_kb = (unsigned long long)usage.ru_maxrss;
+	sample->ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	read_stats_lines(err, sample);
+	fclose(err);
+}
+
+static int	compare_ull(const void *a, const void *b)
+{
+	unsigned long long x = *(const unsigned long long *)a;
+	unsigned long long y = *(const unsigned long long *)b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * 중앙값 계산 함수 (values를 정렬함)
+ */
+static unsigned long long	median(unsigned long long *values, unsigned int count)
+{
+	qsort(values, count, sizeof(unsigned long long), compare_ull);
+	if (count % 2 == 1) {
+		return values[count / 2];
+	}
+	return (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+/**
+ * 측정값 요약 함수
+ *
+ * @param samples 측정값 배열
+ * @param count 측정값 수
+ * @param summary 결과를 저장할 포인터
+ */
+static void	summarize(const BenchSample *samples, unsigned int count, BenchSummary *summary)
+{
+	unsigned long long values[BENCH_MAX_ITERATIONS];
+	double total = 0;
+
+	memset(summary, 0, sizeof(BenchSummary));
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].wall_ns;
+		total += (double)samples[i].wall_ns;
+		if (!samples[i].ok) {
+			summary->failures++;
+		}
+		if (samples[i].maxrss_kb > summary->peak_rss_kb) {
+			summary->peak_rss_kb = samples[i].maxrss_kb;
+		}
+	}
+	summary->wall_median_ms = (double)median(values, count) / 1e6;
+	summary->wall_min_ms = (double)values[0] / 1e6;
+	summary->wall_max_ms = (double)values[count - 1] / 1e6;
+	summary->wall_mean_ms = total / count / 1e6;
+
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].blocks;
+	}
+	summary->blocks_read = median(values, count);
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].stat_kb * 1024;
+	}
+	summary->bytes_read = median(values, count);
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].read_bytes;
+	}
+	summary->storage_bytes_read = median(values, count);
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].wchar;
+	}
+	summary->output_bytes = median(values, count);
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].syscr + samples[i].syscw;
+	}
+	summary->io_syscalls = median(values, count);
+	for (unsigned int i = 0; i < count; i++) {
+		values[i] = samples[i].minflt + samples[i].majflt;
+	}
+	summary->page_faults = median(values, count);
+}
+
+/**
+ * JSON 문자열 출력 함수 (따옴표, 역슬래시, 제어 문자 이스케이프)
+ */
+static void	json_string(FILE *fp, const char *str)
+{
+	fputc('"', fp);
+	for (; *str != '\0'; str++) {
+		unsigned char c = (unsigned char)*str;
+		if (c == '"' || c == '\\') {
+			fprintf(fp, "\\%c", c);
+		} else if (c < 0x20) {
+			fprintf(fp, "\\u%04x", c);
+		} else {
+			fputc(c, fp);
+		}
+	}
+	fputc('"', fp);
+}
+
+/**
+ * 시나리오 결과 하나를 JSON 객체로 출력하는 함수
+ */
+static void	json_result(FILE *fp, const BenchResult *result, bool first)
+{
+	const BenchSummary *s = &result->summary;
+
+	fprintf(fp, "%s\n    {\"name\": ", first ? "" : ",");
+	json_string(fp, result->scenario->name);
+	fprintf(fp, ", \"cache\": \"%s\", \"image\": ", result->cache);
+	json_string(fp, result->scenario->image);
+	fprintf(fp, ", \"command\": ");
+	json_string(fp, result->scenario->command);
+	fprintf(fp, ", \"repeat\": %u, \"block_size\": %u,\n", result->scenario->repeat, result->block_size);
+	fprintf(fp, "     \"wall_ms\": {\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"max\": %.3f},\n",
+			s->wall_min_ms, s->wall_median_ms, s->wall_mean_ms, s->wall_max_ms);
+	fprintf(fp, "     \"blocks_read\": %llu, \"bytes_read\": %llu, \"storage_bytes_read\": %llu, "
+			"\"output_bytes\": %llu,\n", s->blocks_read, s->bytes_read, s->storage_bytes_read, s->output_bytes);
+	fprintf(fp, "     \"io_syscalls\": %llu, \"page_faults\": %llu, \"peak_rss_kb\": %llu, "
+			"\"rss_includes_mapped_image\": %s, \"failures\": %u}",
+			s->io_syscalls, s->page_faults, s->peak_rss_kb, s->rss_has_map ? "true" : "false", s->failures);
+}
+
+/**
+ * 시나리오 하나를 cold/warm으로 실행하는 함수
+ *
+ * @param opts 실행 옵션
+ * @param scenario 시나리오
+ * @param results 결과를 저장할 배열 (2개 이상)
+ * @return 저장한 결과 수 (이미지가 없으면 0)
+ */
+static int	run_scenario(const BenchOptions *opts, const BenchScenario *scenario, BenchResult *results)
+{
+	char image[MAX_PATH];
+	BenchSample samples[BENCH_MAX_ITERATIONS];
+	int count = 0;
+
+	snprintf(image, sizeof(image), "%s/%s", opts->images, scenario->image);
+	unsigned int block_size = image_block_size(image);
+	if (block_size == 0) {
+		fprintf(stderr, "ssu_bench: skipping %s (cannot read %s, run make images)\n", scenario->name, image);
+		return 0;
+	}
+	int script_fd = make_script(scenario);
+	if (script_fd < 0) {
+		return 0;
+	}
+
+	// --no-mmap이 없으면 이미지를 mmap으로 읽으므로 최대 RSS에 매핑된 이미지 페이지가 들어감
+	bool mapped = scenario->ssu_arg == NULL || strcmp(scenario->ssu_arg, "--no-mmap") != 0;
+	for (int i = 0; i < opts->ssu_arg_count; i++) {
+		if (strcmp(opts->ssu_args[i], "--no-mmap") == 0) {
+			mapped = false;
+		}
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		bool cold = pass == 0;
+		if ((cold && !opts->cold) || (!cold && !opts->warm)) {
+			continue;
+		}
+		if (!cold) {
+			run_once(opts, scenario, image, script_fd, &samples[0]);	// 페이지 캐시 데우기
+		}
+		for (unsigned int i = 0; i < opts->iterations; i++) {
+			if (cold) {
+				drop_image_cache(image);
+			}
+			run_once(opts, scenario, image, script_fd, &samples[i]);
+		}
+		BenchResult *result = &results[count++];
+		result->scenario = scenario;
+		result->cache = cold ? "cold" : "warm";
+		result->block_size = block_size;
+		summarize(samples, opts->iterations, &result->summary);
+		result->summary.rss_has_map = mapped;
+
+		const BenchSummary *summary = &result->summary;
+		fprintf(stderr, "%-17s %-4s %10.3f ms %10llu blocks %8llu syscalls %8llu KB rss%s%s\n",
+				scenario->name, result->cache, summary->wall_median_ms, summary->blocks_read,
+				summary->io_syscalls, summary->peak_rss_kb, mapped ? " (incl. mapped image)" : "",
+				summary->failures > 0 ? "  (FAILED)" : "");
+	}
+	close(script_fd);
+	return count;
+}
+
+/**
+ * 결과 목록을 JSON 문서로 출력하는 함수
+ *
+ * @param fp 출력 파일
+ * @param opts 실행 옵션 (빌드 설명, ssu_ext2 옵션)
+ * @param results 결과 배열
+ * @param count 결과 수
+ * @param image 이 이미지의 결과만 출력 (NULL이면 전부)
+ */
+static void	json_report(FILE *fp, const BenchOptions *opts, const BenchResult *results, int count, const char *image)
+{
+	fprintf(fp, "{\n  \"version\": 1,\n  \"binary\": ");
+	json_string(fp, opts->binary);
+	fprintf(fp, ",\n  \"label\": ");
+	json_string(fp, opts->label);
+	fprintf(fp, ",\n  \"ssu_args\": [");
+	for (int i = 0; i < opts->ssu_arg_count; i++) {
+		fprintf(fp, "%s", i > 0 ? ", " : "");
+		json_string(fp, opts->ssu_args[i]);
+	}
+	fprintf(fp, "],\n  \"iterations\": %u,\n  \"results\": [", opts->iterations);
+
+	bool first = true;
+	for (int i = 0; i < count; i++) {
+		if (image != NULL && strcmp(results[i].scenario->image, image) != 0) {
+			continue;
+		}
+		json_result(fp, &results[i], first);
+		first = false;
+	}
+	fprintf(fp, "\n  ]\n}\n");
+}
+
+/**
+ * 이미지의 기준 결과 파일 경로를 만드는 함수 (wide.img -> <dir>/wide.json)
+ */
+static void	baseline_path(const BenchOptions *opts, const char *image, char *path, size_t size)
+{
+	const char *dot = strrchr(image, '.');
+	int stem_len = dot != NULL ? (int)(dot - image) : (int)strlen(image);
+
+	snprintf(path, size, "%s/%.*s.json", opts->baseline_dir, stem_len, image);
+}
+
+/**
+ * 결과 객체 구간에서 키의 값 위치를 찾는 함수 (이 도구가 쓴 JSON만 읽으므로 "키": 형태로 찾음)
+ *
+ * @return 값의 시작 위치, 없으면 NULL
+ */
+static const char	*json_find(const char *begin, const char *end, const char *key)
+{
+	char pattern[64];
+	int len = snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+
+	for (const char *p = begin; p + len <= end; p++) {
+		if (memcmp(p, pattern, (size_t)len) == 0) {
+			return p + len;
+		}
+	}
+	return NULL;
+}
+
+static double	json_number(const char *begin, const char *end, const char *key)
+{
+	const char *value = json_find(begin, end, key);
+
+	return value != NULL ? strtod(value, NULL) : 0;
+}
+
+/**
+ * 기준 결과 파일을 읽는 함수
+ * 지금 시나리오 목록에 없거나 이미지가 바뀐 시나리오의 결과는 버림
+ *
+ * @param opts 실행 옵션
+ * @param image 이미지 파일 이름
+ * @param results 결과를 저장할 배열 (시나리오 수의 2배 이상)
+ * @return 읽은 결과 수, 파일이 없으면 0
+ */
+static int	baseline_load(const BenchOptions *opts, const char *image, BenchResult *results)
+{
+	char path[MAX_PATH];
+	char buf[1 << 16];
+	int count = 0;
+
+	baseline_path(opts, image, path, sizeof(path));
+	FILE *fp = fopen(path, "r");
+	if (fp == NULL) {
+		return 0;
+	}
+	size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+	fclose(fp);
+	buf[len] = '\0';
+
+	const char *end = buf + len;
+	const char *object = strstr(buf, "{\"name\": ");
+	while (object != NULL && count < (int)(2 * BENCH_SCENARIOS)) {
+		const char *next = strstr(object + 1, "{\"name\": ");
+		const char *object_end = next != NULL ? next : end;
+		const char *name = json_find(object, object_end, "name");
+		const char *cache = json_find(object, object_end, "cache");
+
+		for (size_t i = 0; name != NULL && cache != NULL && i < BENCH_SCENARIOS; i++) {
+			size_t name_len = strlen(scenarios[i].name);
+			if (strncmp(name + 1, scenarios[i].name, name_len) != 0 || name[name_len + 1] != '"' ||
+				strcmp(scenarios[i].image, image) != 0) {
+				continue;
+			}
+			BenchResult *result = &results[count++];
+			BenchSummary *s = &result->summary;
+			result->scenario = &scenarios[i];
+			result->cache = strncmp(cache, "\"cold\"", 6) == 0 ? "cold" : "warm";
+			result->block_size = (unsigned int)json_number(object, object_end, "block_size");
+			s->wall_min_ms = json_number(object, object_end, "min");
+			s->wall_median_ms = json_number(object, object_end, "median");
+			s->wall_mean_ms = json_number(object, object_end, "mean");
+			s->wall_max_ms = json_number(object, object_end, "max");
+			s->blocks_read = (unsigned long long)json_number(object, object_end, "blocks_read");
+			s->bytes_read = (unsigned long long)json_number(object, object_end, "bytes_read");
+			s->storage_bytes_read = (unsigned long long)json_number(object, object_end, "storage_bytes_read");
+			s->output_bytes = (unsigned long long)json_number(object, object_end, "output_bytes");
+			s->io_syscalls = (unsigned long long)json_number(object, object_end, "io_syscalls");
+			s->page_faults = (unsigned long long)json_number(object, object_end, "page_faults");
+			s->peak_rss_kb = (unsigned long long)json_number(object, object_end, "peak_rss_kb");
+			s->failures = (unsigned int)json_number(object, object_end, "failures");
+			break;
+		}
+		object = next;
+	}
+	return count;
+}
+
+/**
+ * 이미지별 기준 결과를 저장하는 함수
+ * 기존 파일의 결과 중 이번에 실행한 시나리오/캐시 상태만 새 결과로 바꾸고 나머지는 유지
+ *
+ * @return 성공 시 0, 실패 시 -1
+ */
+static int	baseline_save(const BenchOptions *opts, const BenchResult *results, int count)
+{
+	BenchResult merged[2 * BENCH_SCENARIOS];
+	char path[MAX_PATH];
+
+	mkdir(opts->baseline_dir, 0755);
+	for (int i = 0; i < count; i++) {
+		const char *image = results[i].scenario->image;
+		bool done = false;
+		for (int j = 0; j < i && !done; j++) {
+			done = strcmp(results[j].scenario->image, image) == 0;
+		}
+		if (done) {
+			continue;
+		}
+
+		// 기존 결과 중 이번에 실행하지 않은 것만 남기고 새 결과를 덧붙임
+		int merged_count = 0;
+		int old_count = baseline_load(opts, image, merged);
+		for (int j = 0; j < old_count; j++) {
+			bool replaced = false;
+			for (int k = 0; k < count && !replaced; k++) {
+				replaced = results[k].scenario == merged[j].scenario && strcmp(results[k].cache, merged[j].cache) == 0;
+			}
+			if (!replaced) {
+				merged[merged_count++] = merged[j];
+			}
+		}
+		for (int k = 0; k < count; k++) {
+			if (strcmp(results[k].scenario->image, image) == 0) {
+				merged[merged_count++] = results[k];
+			}
+		}
+
+		baseline_path(opts, image, path, sizeof(path));
+		FILE *fp = fopen(path, "w");
+		if (fp == NULL) {
+			fprintf(stderr, "ssu_bench: cannot create %s: %s\n", path, strerror(errno));
+			return -1;
+		}
+		json_report(fp, opts, merged, merged_count, image);
+		if (fclose(fp) != 0) {
+			return -1;
+		}
+		fprintf(stderr, "ssu_bench: saved %d baseline results to %s\n", merged_count, path);
+	}
+	return 0;
+}
+
+/**
+ * 증가율 계산 함수 (%)
+ */
+static double	percent_change(double base, double value)
+{
+	if (base <= 0) {
+		return value > 0 ? 100.0 : 0.0;
+	}
+	return (value - base) * 100.0 / base;
+}
+
+/**
+ * 기준 결과와 비교해서 시나리오별 차이 표를 출력하는 함수
+ * 중앙값 시간(처리량의 역수)이 threshold% 넘게 늘고 그 차이가 min_delta_ms 이상이거나,
+ * 최대 RSS가 rss_threshold% 넘게 늘거나, 새 결과에 실패한 실행이 있으면 회귀로 봄
+ *
+ * @return 회귀한 결과 수, 기준 결과가 하나도 없으면 -1
+ */
+static int	compare_baseline(const BenchOptions *opts, const BenchResult *results, int count)
+{
+	BenchResult baseline[2 * BENCH_SCENARIOS];
+	int regressions = 0;
+	int compared = 0;
+
+	fprintf(stderr, "\n%-16s %-4s %10s %10s %8s %9s %9s %8s  %s\n", "scenario", "mode",
+			"base ms", "new ms", "time", "base KB", "new KB", "rss", "result");
+	for (int i = 0; i < count; i++) {
+		const BenchResult *cur = &results[i];
+		const BenchResult *base = NULL;
+		int base_count = baseline_load(opts, cur->scenario->image, baseline);
+		for (int j = 0; j < base_count && base == NULL; j++) {
+			if (baseline[j].scenario == cur->scenario && strcmp(baseline[j].cache, cur->cache) == 0) {
+				base = &baseline[j];
+			}
+		}
+		if (base == NULL) {
+			fprintf(stderr, "%-16s %-4s %10s %10.3f %8s %9s %9llu %8s  no baseline\n", cur->scenario->name,
+					cur->cache, "-", cur->summary.wall_median_ms, "-", "-", cur->summary.peak_rss_kb, "-");
+			continue;
+		}
+		compared++;
+
+		const BenchSummary *b = &base->summary;
+		const BenchSummary *c = &cur->summary;
+		double time_change = percent_change(b->wall_median_ms, c->wall_median_ms);
+		double rss_change = percent_change((double)b->peak_rss_kb, (double)c->peak_rss_kb);
+		bool slower = time_change > opts->threshold && c->wall_median_ms - b->wall_median_ms >= opts->min_delta_ms;
+		bool bigger = rss_change > opts->rss_threshold;
+		bool failed = c->failures > 0;
+		const char *verdict = "ok";
+		if (failed) {
+			verdict = "FAILED";
+		} else if (slower && bigger) {
+			verdict = "SLOWER, MORE MEMORY";
+		} else if (slower) {
+			verdict = "SLOWER";
+		} else if (bigger) {
+			verdict = "MORE MEMORY";
+		} else if (time_change < -opts->threshold && b->wall_median_ms - c->wall_median_ms >= opts->min_delta_ms) {
+			verdict = "faster";
+		}
+		if (failed || slower || bigger) {
+			regressions++;
+		}
+
+		fprintf(stderr, "%-16s %-4s %10.3f %10.3f %+7.1f%% %9llu %9llu %+7.1f%%  %s\n", cur->scenario->name,
+				cur->cache, b->wall_median_ms, c->wall_median_ms, time_change,
+				b->peak_rss_kb, c->peak_rss_kb, rss_change, verdict);
+	}
+
+	if (compared == 0) {
+		fprintf(stderr, "ssu_bench: no baseline results in %s (run with --save-baseline first)\n", opts->baseline_dir);
+		return -1;
+	}
+	fprintf(stderr, "\n%d of %d results regressed (time > %+.1f%% and >= %.2f ms, rss > %+.1f%%)\n",
+			regressions, compared, opts->threshold, opts->min_delta_ms, opts->rss_threshold);
+	return regressions;
+}
+
+/**
+ * 사용법 출력 함수
+ */
+static void	usage(void)
+{
+	printf("Usage : ./ssu_bench [OPTION]...\n");
+	printf("  --binary=<PATH>      ssu_ext2 binary (default ./ssu_ext2)\n");
+	printf("  --images=<DIR>       image directory from make images (default bench/images)\n");
+	printf("  --iterations=<N>     timed runs per scenario and cache mode (1~%d, default 5)\n", BENCH_MAX_ITERATIONS);
+	printf("  --cache=<cold|warm|both>  page cache state (default both)\n");
+	printf("  --filter=<TEXT>      run only scenarios whose name contains TEXT\n");
+	printf("  --label=<TEXT>       build description stored in the result\n");
+	printf("  --output=<FILE>      JSON output file (default stdout)\n");
+	printf("  --ssu-arg=<ARG>      pass ARG to ssu_ext2 (repeatable)\n");
+	printf("  --baseline-dir=<DIR> per-image baseline results (default bench/baselines)\n");
+	printf("  --save-baseline      store these results as the baseline (replaces matching scenarios)\n");
+	printf("  --compare            compare with the baseline, exit %d on regression\n", BENCH_REGRESSION_EXIT);
+	printf("  --threshold=<PCT>    allowed median time increase (default 10)\n");
+	printf("  --rss-threshold=<PCT>  allowed peak RSS increase (default 10)\n");
+	printf("  --min-delta-ms=<MS>  ignore time differences smaller than MS (default 0.5)\n");
+}
+
+/**
+ * 0 이상의 실수 옵션 값을 읽는 함수
+ *
+ * @return 성공 시 true, 숫자가 아니거나 음수면 false
+ */
+static bool	parse_percent(const char *str, double *value)
+{
+	char *endptr;
+	double num = strtod(str, &endptr);
+
+	if (*str == '\0' || *endptr != '\0' || num < 0) {
+		return false;
+	}
+	*value = num;
+	return true;
+}
+
+/**
+ * 명령행 옵션 파싱 함수
+ *
+ * @return 성공 시 true, 실패 시 false
+ */
+static bool	parse_bench_options(int argc, char *argv[], BenchOptions *opts)
+{
+	memset(opts, 0, sizeof(BenchOptions));
+	opts->binary = "./ssu_ext2";
+	opts->images = "bench/images";
+	opts->label = "";
+	opts->iterations = 5;
+	opts->cold = true;
+	opts->warm = true;
+	opts->baseline_dir = "bench/baselines";
+	opts->threshold = 10;
+	opts->rss_threshold = 10;
+	opts->min_delta_ms = 0.5;
+
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--binary=", 9) == 0) {
+			opts->binary = argv[i] + 9;
+		}
+		else if (strncmp(argv[i], "--images=", 9) == 0) {
+			opts->images = argv[i] + 9;
+		}
+		else if (strncmp(argv[i], "--iterations=", 13) == 0) {
+			char *endptr;
+			long num = strtol(argv[i] + 13, &endptr, 10);
+			if (argv[i][13] == '\0' || *endptr != '\0' || num < 1 || num > BENCH_MAX_ITERATIONS) {
+				return false;
+			}
+			opts->iterations = (unsigned int)num;
+		}
+		else if (strncmp(argv[i], "--cache=", 8) == 0) {
+			const char *mode = argv[i] + 8;
+			opts->cold = strcmp(mode, "cold") == 0 || strcmp(mode, "both") == 0;
+			opts->warm = strcmp(mode, "warm") == 0 || strcmp(mode, "both") == 0;
+			if (!opts->cold && !opts->warm) {
+				return false;
+			}
+		}
+		else if (strncmp(argv[i], "--filter=", 9) == 0) {
+			opts->filter = argv[i] + 9;
+		}
+		else if (strncmp(argv[i], "--label=", 8) == 0) {
+			opts->label = argv[i] + 8;
+		}
+		else if (strncmp(argv[i], "--output=", 9) == 0) {
+			opts->output = argv[i] + 9;
+		}
+		else if (strncmp(argv[i], "--ssu-arg=", 10) == 0 && opts->ssu_arg_count < BENCH_MAX_SSU_ARGS) {
+			opts->ssu_args[opts->ssu_arg_count++] = argv[i] + 10;
+		}
+		else if (strncmp(argv[i], "--baseline-dir=", 15) == 0) {
+			opts->baseline_dir = argv[i] + 15;
+		}
+		else if (strcmp(argv[i], "--save-baseline") == 0) {
+			opts->save_baseline = true;
+		}
+		else if (strcmp(argv[i], "--compare") == 0) {
+			opts->compare = true;
+		}
+		else if (strncmp(argv[i], "--threshold=", 12) == 0) {
+			if (!parse_percent(argv[i] + 12, &opts->threshold)) {
+				return false;
+			}
+		}
+		else if (strncmp(argv[i], "--rss-threshold=", 16) == 0) {
+			if (!parse_percent(argv[i] + 16, &opts->rss_threshold)) {
+				return false;
+			}
+		}
+		else if (strncmp(argv[i], "--min-delta-ms=", 15) == 0) {
+			if (!parse_percent(argv[i] + 15, &opts->min_delta_ms)) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+int	main(int argc, char *argv[])
+{
+	BenchOptions opts;
+	BenchResult results[2 * BENCH_SCENARIOS];
+
+	if (!parse_bench_options(argc, argv, &opts)) {
+		usage();
+		return 1;
+	}
+	if (access(opts.binary, X_OK) != 0) {
+		fprintf(stderr, "ssu_bench: cannot execute %s\n", opts.binary);
+		return 1;
+	}
+
+	FILE *json = stdout;
+	if (opts.output != NULL && (json = fopen(opts.output, "w")) == NULL) {
+		fprintf(stderr, "ssu_bench: cannot create %s: %s\n", opts.output, strerror(errno));
+		return 1;
+	}
+
+	int count = 0;
+	for (size_t i = 0; i < BENCH_SCENARIOS; i++) {
+		if (opts.filter != NULL && strstr(scenarios[i].name, opts.filter) == NULL) {
+			continue;
+		}
+		count += run_scenario(&opts, &scenarios[i], &results[count]);
+	}
+	json_report(json, &opts, results, count, NULL);
+
+	if (json != stdout && fclose(json) != 0) {
+		return 1;
+	}
+	if (count == 0) {
+		return 1;
+	}
+
+	// 비교를 먼저 하고 저장 (둘 다 주면 이전 기준과 비교한 뒤 기준을 갱신)
+	int regressions = 0;
+	if (opts.compare && (regressions = compare_baseline(&opts, results, count)) < 0) {
+		return 1;
+	}
+	if (opts.save_baseline && baseline_save(&opts, results, count) < 0) {
+		return 1;
+	}
+	return regressions > 0 ? BENCH_REGRESSION_EXIT : 0;
+}
@@ -0,0 +1,1116 @@
+#include "../ssu_ext2.h"
+
+/*
+ * 벤치마크용 ext2 이미지 생성기
+ * mkfs나 루트 권한 없이 ext2.h의 구조체 배치 그대로 이미지를 직접 기록
+ * 시드가 같으면 같은 이미지가 만들어짐 (시각, UUID, 이름, 파일 내용 모두 시드에서 유도)
+ *
+ * 만들 수 있는 내용 (모두 루트 아래, 옵션으로 켬)
+ *   /wide   엔트리가 많은 단일 디렉토리 (빈 파일)
+ *   /deep   깊은 디렉토리 체인 (단계마다 작은 파일 2개)
+ *   /tree   무작위 계층 (디렉토리와 작은 파일)
+ *   /files  big.txt (이중/삼중 간접 블록이 필요한 텍스트 파일), sparse.bin (구멍이 많은 파일), small.txt
+ */
+
+#define GEN_TIMESTAMP 1600000000U		// 모든 시각 필드에 쓰는 고정 값
+#define GEN_TEXT_BYTES (1024 * 1024)	// 파일 내용으로 반복해서 쓰는 텍스트 패턴 크기
+#define GEN_WRITE_BATCH 64				// 연속 데이터 블록을 모아서 쓰는 최대 블록 수
+#define GEN_TREE_MAX_DEPTH 16			// /tree 최대 깊이
+
+#define FEATURE_INCOMPAT_FILETYPE 0x0002
+#define FEATURE_RO_COMPAT_SPARSE_SUPER 0x0001
+
+_Static_assert(sizeof(struct my_ext2_inode) == 128, "inode layout must match ext2 rev 1");
+_Static_assert(sizeof(struct my_ext2_super_block) == 1024, "superblock layout must match ext2");
+
+/**
+ * 생성 옵션 구조체
+ */
+typedef struct gen_spec {
+	unsigned int block_size;			// 블록 크기 (1024, 2048, 4096)
+	unsigned int groups;				// 블록 그룹 수 (0이면 내용에 맞춰 계산)
+	unsigned int blocks_per_group;		// 그룹당 블록 수 (0이면 block_size * 8)
+	unsigned int inodes_per_group;		// 그룹당 inode 수 (0이면 내용에 맞춰 계산)
+	unsigned long long seed;
+	unsigned int wide;					// /wide 엔트리 수
+	unsigned int deep;					// /deep 깊이
+	unsigned int tree;					// /tree 엔트리 수
+	unsigned long long big_size;		// /files/big.txt 크기 (바이트)
+	unsigned long long sparse_size;		// /files/sparse.bin 크기 (바이트)
+	unsigned int sparse_gap;			// sparse.bin 평균 구멍 길이 (블록)
+	const char *output;
+} GenSpec;
+
+/**
+ * 생성 중인 이미지 구조체
+ */
+typedef struct gen_image {
+	GenSpec spec;
+	int fd;
+	unsigned int bs;					// 블록 크기
+	unsigned int bpg;					// 그룹당 블록 수
+	unsigned int ipg;					// 그룹당 inode 수
+	unsigned int groups;
+	unsigned int first_data_block;
+	unsigned int blocks_count;
+	unsigned int inodes_count;
+	unsigned int gdt_blocks;			// 그룹 디스크립터 테이블 블록 수
+	unsigned int itable_blocks;			// 그룹당 inode 테이블 블록 수
+	unsigned char *block_bitmap;		// 그룹마다 bs 바이트
+	unsigned char *inode_bitmap;		// 그룹마다 bs 바이트
+	struct my_ext2_inode *inodes;		// 모든 inode (1번이 인덱스 0)
+	unsigned short *used_dirs;			// 그룹별 디렉토리 수
+	unsigned int next_block;			// 다음에 확인할 블록 번호
+	unsigned int next_inode;			// 다음에 할당할 inode 번호
+	unsigned long long rng;
+	unsigned char *text;				// 텍스트 패턴
+	unsigned char *batch;				// 연속 데이터 블록 쓰기 버퍼
+	unsigned int batch_start;
+	unsigned int batch_count;
+	bool failed;
+} GenImage;
+
+/**
+ * inode 하나의 블록 포인터를 논리 블록 순서대로 채우는 구조체
+ * 논리 블록은 증가하는 순서로만 추가되므로 간접 단계마다 열린 테이블은 하나뿐
+ */
+typedef struct block_writer {
+	unsigned int ino;
+	unsigned int i_block[EXT2_N_BLOCKS];	// 완성되면 inode에 복사
+	unsigned int depth;					// 현재 열린 테이블들의 간접 단계 (0: 직접 블록)
+	unsigned int tbl_blk[3];			// 단계별 열린 간접 테이블 블록 번호 (0: 없음)
+	unsigned int *tbl[3];				// 단계별 열린 간접 테이블 내용
+	unsigned int blocks;				// 할당한 블록 수 (간접 블록 포함)
+} BlockWriter;
+
+/**
+ * 디렉토리 블록을 채우는 구조체
+ */
+typedef struct dir_writer {
+	BlockWriter bw;
+	unsigned char *buf;					// 현재 디렉토리 블록
+	unsigned int used;					// 현재 블록에서 사용한 바이트
+	unsigned int last;					// 현재 블록의 마지막 엔트리 위치
+	unsigned int logical;				// 현재 블록의 논리 블록 번호
+} DirWriter;
+
+/**
+ * splitmix64 난수 생성 함수 (플랫폼과 무관하게 같은 수열)
+ */
+static unsigned long long	gen_rand(GenImage *img)
+{
+	unsigned long long z = (img->rng += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * [0, bound) 범위의 난수
+ */
+static unsigned int	gen_range(GenImage *img, unsigned int bound)
+{
+	return bound == 0 ? 0 : (unsigned int)(gen_rand(img) % bound);
+}
+
+/**
+ * 그룹에 슈퍼블록 사본이 있는지 확인하는 함수 (sparse_super: 0, 1, 3/5/7의 거듭제곱)
+ */
+static bool	group_has_super(unsigned int group)
+{
+	if (group <= 1) {
+		return true;
+	}
+	for (unsigned int base = 3; base <= 7; base += 2) {
+		unsigned long long n = base;
+		while (n < group) {
+			n *= base;
+		}
+		if (n == group) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * 그룹의 비트맵, inode 테이블 위치 계산 함수
+ *
+ * @param img 이미지 포인터
+ * @param group 그룹 번호
+ * @param block_bitmap 블록 비트맵 블록 번호를 저장할 포인터
+ * @return 그룹 메타데이터 다음 블록 번호 (첫 데이터 블록)
+ */
+static unsigned int	group_layout(const GenImage *img, unsigned int group, unsigned int *block_bitmap)
+{
+	unsigned int pos = img->first_data_block + group * img->bpg;
+
+	if (group_has_super(group)) {
+		pos += 1 + img->gdt_blocks;
+	}
+	*block_bitmap = pos;
+	return pos + 2 + img->itable_blocks;
+}
+
+/**
+ * 블록 비트맵에 블록을 사용 중으로 표시하는 함수
+ */
+static void	mark_block(GenImage *img, unsigned int block)
+{
+	unsigned int index = block - img->first_data_block;
+	unsigned int group = index / img->bpg;
+	unsigned int bit = index % img->bpg;
+
+	img->block_bitmap[(size_t)group * img->bs + bit / 8] |= (unsigned char)(1U << (bit % 8));
+}
+
+/**
+ * 블록 사용 여부 확인 함수
+ */
+static bool	block_used(const GenImage *img, unsigned int block)
+{
+	unsigned int index = block - img->first_data_block;
+	unsigned int group = index / img->bpg;
+	unsigned int bit = index % img->bpg;
+
+	return (img->block_bitmap[(size_t)group * img->bs + bit / 8] >> (bit % 8)) & 1;
+}
+
+/**
+ * 빈 블록 하나를 할당하는 함수 (앞에서부터 차례로)
+ *
+ * @param img 이미지 포인터
+ * @return 블록 번호, 이미지가 가득 차면 0
+ */
+static unsigned int	alloc_block(GenImage *img)
+{
+	while (img->next_block < img->blocks_count && block_used(img, img->next_block)) {
+		img->next_block++;
+	}
+	if (img->next_block >= img->blocks_count) {
+		if (!img->failed) {
+			fprintf(stderr, "gen_image: image full (%u blocks), use a larger --groups\n", img->blocks_count);
+		}
+		img->failed = true;
+		return 0;
+	}
+	mark_block(img, img->next_block);
+	return img->next_block++;
+}
+
+/**
+ * 블록 하나를 이미지에 쓰는 함수
+ */
+static void	write_block(GenImage *img, unsigned int block, const void *data)
+{
+	if (block == 0) {
+		return;
+	}
+	if (pwrite(img->fd, data, img->bs, (off_t)block * img->bs) != (ssize_t)img->bs) {
+		img->failed = true;
+	}
+}
+
+/**
+ * 모아 둔 연속 데이터 블록을 쓰는 함수
+ */
+static void	flush_batch(GenImage *img)
+{
+	if (img->batch_count == 0) {
+		return;
+	}
+	size_t len = (size_t)img->batch_count * img->bs;
+	if (pwrite(img->fd, img->batch, len, (off_t)img->batch_start * img->bs) != (ssize_t)len) {
+		img->failed = true;
+	}
+	img->batch_count = 0;
+}
+
+/**
+ * 데이터 블록을 쓰기 버퍼에 넣는 함수 (앞 블록과 이어지지 않거나 버퍼가 차면 먼저 씀)
+ *
+ * @return 블록 내용을 채울 버퍼 위치
+ */
+static unsigned char	*batch_block(GenImage *img, unsigned int block)
+{
+	if (img->batch_count > 0 && (block != img->batch_start + img->batch_count || img->batch_count == GEN_WRITE_BATCH)) {
+		flush_batch(img);
+	}
+	if (img->batch_count == 0) {
+		img->batch_start = block;
+	}
+	return img->batch + (size_t)img->batch_count++ * img->bs;
+}
+
+/**
+ * inode 비트맵에 inode를 사용 중으로 표시하는 함수
+ */
+static void	mark_inode(GenImage *img, unsigned int ino)
+{
+	unsigned int group = (ino - 1) / img->ipg;
+	unsigned int bit = (ino - 1) % img->ipg;
+
+	img->inode_bitmap[(size_t)group * img->bs + bit / 8] |= (unsigned char)(1U << (bit % 8));
+}
+
+/**
+ * inode 하나를 할당하는 함수
+ *
+ * @param img 이미지 포인터
+ * @param mode i_mode
+ * @return inode 번호, 모두 사용했으면 0
+ */
+static unsigned int	alloc_inode(GenImage *img, unsigned int mode)
+{
+	if (img->next_inode > img->inodes_count) {
+		if (!img->failed) {
+			fprintf(stderr, "gen_image: out of inodes (%u), use a larger --inodes-per-group\n", img->inodes_count);
+		}
+		img->failed = true;
+		return 0;
+	}
+
+	unsigned int ino = img->next_inode++;
+	struct my_ext2_inode *inode = &img->inodes[ino - 1];
+
+	mark_inode(img, ino);
+	inode->i_mode = (__u16)mode;
+	inode->i_atime = GEN_TIMESTAMP;
+	inode->i_ctime = GEN_TIMESTAMP;
+	inode->i_mtime = GEN_TIMESTAMP;
+	inode->i_links_count = 1;
+	inode->i_generation = (__u32)gen_rand(img);
+	if (S_ISDIR(mode)) {
+		img->used_dirs[(ino - 1) / img->ipg]++;
+	}
+	return ino;
+}
+
+/**
+ * 블록 포인터 작성기 초기화 함수 (간접 테이블 버퍼는 처음 필요할 때 할당)
+ */
+static void	bw_init(BlockWriter *bw, unsigned int ino)
+{
+	memset(bw, 0, sizeof(BlockWriter));
+	bw->ino = ino;
+}
+
+/**
+ * level 이하 단계의 열린 간접 테이블을 이미지에 쓰고 닫는 함수
+ */
+static void	bw_close_tables(GenImage *img, BlockWriter *bw, unsigned int level)
+{
+	for (unsigned int i = level; i < 3; i++) {
+		if (bw->tbl_blk[i] != 0) {
+			write_block(img, bw->tbl_blk[i], bw->tbl[i]);
+			bw->tbl_blk[i] = 0;
+		}
+	}
+}
+
+/**
+ * 논리 블록 하나에 데이터 블록을 할당하는 함수
+ * 필요한 간접 블록을 먼저 할당하므로 간접 블록은 자신이 가리키는 데이터 블록 바로 앞에 놓임
+ *
+ * @param img 이미지 포인터
+ * @param bw 블록 포인터 작성기
+ * @param logical 논리 블록 번호 (이전 호출보다 커야 함)
+ * @return 데이터 블록 번호, 실패 시 0
+ */
+static unsigned int	bw_alloc(GenImage *img, BlockWriter *bw, unsigned int logical)
+{
+	unsigned int ptrs = img->bs / 4;
+	unsigned int *slot;
+
+	if (logical < EXT2_NDIR_BLOCKS) {
+		slot = &bw->i_block[logical];
+	} else {
+		// 간접 단계와 단계 내 위치 계산
+		unsigned long long offset = logical - EXT2_NDIR_BLOCKS;
+		unsigned long long per_entry = 1;
+		unsigned int depth;
+		for (depth = 1; depth <= 3; depth++) {
+			if (offset < per_entry * ptrs) {
+				break;
+			}
+			offset -= per_entry * ptrs;
+			per_entry *= ptrs;
+		}
+		if (depth > 3) {
+			img->failed = true;
+			return 0;
+		}
+		if (depth != bw->depth) {
+			bw_close_tables(img, bw, 0);
+			bw->depth = depth;
+		}
+
+		slot = &bw->i_block[EXT2_IND_BLOCK + depth - 1];
+		for (unsigned int level = 0; level < depth; level++) {
+			if (*slot == 0) {
+				if ((*slot = alloc_block(img)) == 0) {
+					return 0;
+				}
+				bw->blocks++;
+			}
+			if (bw->tbl[level] == NULL && (bw->tbl[level] = (unsigned int *)malloc(img->bs)) == NULL) {
+				img->failed = true;
+				return 0;
+			}
+			if (bw->tbl_blk[level] != *slot) {
+				bw_close_tables(img, bw, level);
+				bw->tbl_blk[level] = *slot;
+				memset(bw->tbl[level], 0, img->bs);
+			}
+			unsigned int index = (unsigned int)(offset / per_entry);
+			offset %= per_entry;
+			per_entry /= ptrs;
+			slot = &bw->tbl[level][index];
+		}
+	}
+
+	if ((*slot = alloc_block(img)) == 0) {
+		return 0;
+	}
+	bw->blocks++;
+	return *slot;
+}
+
+/**
+ * 블록 포인터 작성을 마치는 함수 (남은 간접 테이블을 쓰고 i_block, i_blocks 설정)
+ */
+static void	bw_finish(GenImage *img, BlockWriter *bw)
+{
+	bw_close_tables(img, bw, 0);
+	memcpy(img->inodes[bw->ino - 1].i_block, bw->i_block, sizeof(bw->i_block));
+	img->inodes[bw->ino - 1].i_blocks = bw->blocks * (img->bs / 512);
+	for (int level = 0; level < 3; level++) {
+		free(bw->tbl[level]);
+		bw->tbl[level] = NULL;
+	}
+}
+
+/**
+ * 디렉토리 블록 하나를 마무리해서 쓰는 함수 (마지막 엔트리가 블록 끝까지 차지)
+ */
+static void	dir_flush(GenImage *img, DirWriter *dw)
+{
+	struct my_ext2_dir_entry_2 *last = (struct my_ext2_dir_entry_2 *)(dw->buf + dw->last);
+	last->rec_len = (__u16)(img->bs - dw->last);
+
+	write_block(img, bw_alloc(img, &dw->bw, dw->logical), dw->buf);
+	dw->logical++;
+	dw->used = 0;
+	dw->last = 0;
+	memset(dw->buf, 0, img->bs);
+}
+
+/**
+ * 디렉토리 엔트리 추가 함수
+ */
+static void	dir_add(GenImage *img, DirWriter *dw, const char *name, unsigned int ino, unsigned char file_type)
+{
+	size_t name_len = strlen(name);
+	unsigned int rec_len = (unsigned int)((8 + name_len + 3) & ~(size_t)3);
+
+	if (dw->used + rec_len > img->bs) {
+		dir_flush(img, dw);
+	}
+
+	struct my_ext2_dir_entry_2 *entry = (struct my_ext2_dir_entry_2 *)(dw->buf + dw->used);
+	entry->inode = ino;
+	entry->rec_len = (__u16)rec_len;
+	entry->name_len = (__u8)name_len;
+	entry->file_type = file_type;
+	memcpy(entry->name, name, name_len);
+	dw->last = dw->used;
+	dw->used += rec_len;
+}
+
+/**
+ * 디렉토리 작성 시작 함수 (".", ".." 엔트리 추가)
+ */
+static int	dir_open(GenImage *img, DirWriter *dw, unsigned int ino, unsigned int parent)
+{
+	memset(dw, 0, sizeof(DirWriter));
+	bw_init(&dw->bw, ino);
+	if ((dw->buf = (unsigned char *)calloc(1, img->bs)) == NULL) {
+		return -1;
+	}
+	img->inodes[ino - 1].i_links_count = 2;
+	dir_add(img, dw, ".", ino, EXT2_FT_DIR);
+	dir_add(img, dw, "..", parent, EXT2_FT_DIR);
+	return 0;
+}
+
+/**
+ * 디렉토리 작성 마무리 함수
+ */
+static void	dir_close(GenImage *img, DirWriter *dw)
+{
+	dir_flush(img, dw);
+	img->inodes[dw->bw.ino - 1].i_size = dw->logical * img->bs;
+	bw_finish(img, &dw->bw);
+	free(dw->buf);
+	dw->buf = NULL;
+}
+
+/**
+ * 하위 디렉토리를 만들고 작성을 시작하는 함수
+ *
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+static int	dir_mkdir(GenImage *img, DirWriter *parent, const char *name, DirWriter *child)
+{
+	unsigned int ino = alloc_inode(img, S_IFDIR | 0755);
+	if (ino == 0) {
+		return -1;
+	}
+	dir_add(img, parent, name, ino, EXT2_FT_DIR);
+	img->inodes[parent->bw.ino - 1].i_links_count++;
+	return dir_open(img, child, ino, parent->bw.ino);
+}
+
+/**
+ * 텍스트 패턴으로 데이터 블록 하나를 채우는 함수
+ *
+ * @param pos 파일 안의 바이트 위치 (패턴 위치는 파일마다 다른 시작점에서 이어짐)
+ * @param valid 블록 중 파일 크기 안에 드는 바이트 수 (나머지는 0)
+ */
+static void	fill_text(GenImage *img, unsigned char *dst, unsigned long long pos, unsigned int valid)
+{
+	unsigned int done = 0;
+
+	while (done < valid) {
+		size_t at = (size_t)((pos + done) % GEN_TEXT_BYTES);
+		size_t chunk = GEN_TEXT_BYTES - at < valid - done ? GEN_TEXT_BYTES - at : valid - done;
+		memcpy(dst + done, img->text + at, chunk);
+		done += (unsigned int)chunk;
+	}
+	memset(dst + valid, 0, img->bs - valid);
+}
+
+/**
+ * 일반 파일 작성 함수
+ * sparse_gap이 0이면 모든 블록을 할당하고, 아니면 평균 sparse_gap 블록의 구멍과 1~8블록의 데이터 구간을 번갈아 둠
+ *
+ * @param img 이미지 포인터
+ * @param dir 부모 디렉토리
+ * @param name 파일 이름
+ * @param mode 권한 비트
+ * @param size 파일 크기
+ * @param sparse_gap 평균 구멍 길이 (블록, 0이면 구멍 없음)
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+static int	make_file(GenImage *img, DirWriter *dir, const char *name, unsigned int mode,
+					  unsigned long long size, unsigned int sparse_gap)
+{
+	unsigned int ino = alloc_inode(img, S_IFREG | mode);
+	if (ino == 0) {
+		return -1;
+	}
+	dir_add(img, dir, name, ino, EXT2_FT_REG_FILE);
+
+	BlockWriter bw;
+	bw_init(&bw, ino);
+	img->inodes[ino - 1].i_size = (__u32)size;
+
+	unsigned long long base = gen_rand(img);
+	unsigned long long nblocks = (size + img->bs - 1) / img->bs;
+	unsigned long long logical = 0;
+	while (logical < nblocks && !img->failed) {
+		unsigned int run = (unsigned int)(nblocks - logical);
+		if (sparse_gap > 0) {
+			logical += gen_range(img, 2 * sparse_gap + 1);
+			run = 1 + gen_range(img, 8);
+		}
+		for (; run > 0 && logical < nblocks; run--, logical++) {
+			unsigned long long pos = logical * img->bs;
+			unsigned int valid = size - pos < img->bs ? (unsigned int)(size - pos) : img->bs;
+			unsigned int block = bw_alloc(img, &bw, (unsigned int)logical);
+			if (block == 0) {
+				break;
+			}
+			fill_text(img, batch_block(img, block), base + pos, valid);
+		}
+	}
+	flush_batch(img);
+	bw_finish(img, &bw);
+	return img->failed ? -3 : 0;
+}
+
+/**
+ * 무작위 이름 만드는 함수 (prefix + 번호 + '_' + 길이가 0~max_extra인 영숫자)
+ */
+static void	random_name(GenImage *img, char *name, const char *prefix, unsigned int index, unsigned int max_extra)
+{
+	static const char alnum[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+	int len = snprintf(name, 256, "%s%07u", prefix, index);
+	unsigned int extra = gen_range(img, max_extra + 1);
+
+	if (extra > 0) {
+		name[len++] = '_';
+		for (unsigned int i = 0; i < extra && len < 255; i++) {
+			name[len++] = alnum[gen_range(img, sizeof(alnum) - 1)];
+		}
+	}
+	name[len] = '\0';
+}
+
+/**
+ * /wide 작성 함수 (빈 파일 spec.wide개, 이름 길이는 8~48)
+ */
+static int	build_wide(GenImage *img, DirWriter *root)
+{
+	DirWriter wide;
+	char name[256];
+
+	if (dir_mkdir(img, root, "wide", &wide) < 0) {
+		return -1;
+	}
+	for (unsigned int i = 0; i < img->spec.wide && !img->failed; i++) {
+		random_name(img, name, "w", i, 40);
+		unsigned int ino = alloc_inode(img, S_IFREG | 0644);
+		if (ino != 0) {
+			dir_add(img, &wide, name, ino, EXT2_FT_REG_FILE);
+		}
+	}
+	dir_close(img, &wide);
+	return img->failed ? -2 : 0;
+}
+
+/**
+ * /deep의 한 단계를 작성하는 함수 (작은 파일 2개와 다음 단계 디렉토리)
+ */
+static int	build_deep_level(GenImage *img, DirWriter *dir, unsigned int level)
+{
+	char name[32];
+
+	for (int i = 0; i < 2; i++) {
+		snprintf(name, sizeof(name), "file%d.txt", i);
+		if (make_file(img, dir, name, 0644, gen_range(img, img->bs), 0) < 0) {
+			return -1;
+		}
+	}
+	if (level >= img->spec.deep) {
+		return 0;
+	}
+
+	DirWriter child;
+	snprintf(name, sizeof(name), "level%04u", level + 1);
+	if (dir_mkdir(img, dir, name, &child) < 0) {
+		return -2;
+	}
+	int result = build_deep_level(img, &child, level + 1);
+	dir_close(img, &child);
+	return result;
+}
+
+/**
+ * /tree의 디렉토리 하나를 작성하는 함수
+ * 자식 2~16개 중 약 1/4이 하위 디렉토리이고, 전체 엔트리 수가 remaining에 도달하면 멈춤
+ */
+static int	build_tree_dir(GenImage *img, DirWriter *dir, unsigned int depth, unsigned int *remaining)
+{
+	static const unsigned int modes[] = { 0644, 0644, 0600, 0755, 0444 };
+	unsigned int children = 2 + gen_range(img, 15);
+	char name[256];
+
+	for (unsigned int i = 0; i < children && *remaining > 0 && !img->failed; i++) {
+		(*remaining)--;
+		if (depth < GEN_TREE_MAX_DEPTH && gen_range(img, 4) == 0) {
+			DirWriter child;
+			random_name(img, name, "d", i, 12);
+			if (dir_mkdir(img, dir, name, &child) < 0) {
+				return -1;
+			}
+			int result = build_tree_dir(img, &child, depth + 1, remaining);
+			dir_close(img, &child);
+			if (result < 0) {
+				return result;
+			}
+		} else {
+			random_name(img, name, "f", i, 20);
+			unsigned int mode = modes[gen_range(img, sizeof(modes) / sizeof(modes[0]))];
+			if (make_file(img, dir, name, mode, gen_range(img, 3 * img->bs), 0) < 0) {
+				return -2;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * 루트 디렉토리와 옵션으로 켠 내용 작성 함수
+ */
+static int	build_content(GenImage *img)
+{
+	DirWriter root;
+	DirWriter sub;
+	int result = 0;
+
+	// 1~10번은 예약 inode (루트는 2번), lost+found는 11번
+	for (unsigned int ino = 1; ino <= 10; ino++) {
+		mark_inode(img, ino);
+	}
+	img->next_inode = EXT2_ROOT_INO;
+	alloc_inode(img, S_IFDIR | 0755);
+	img->next_inode = 11;
+
+	if (dir_open(img, &root, EXT2_ROOT_INO, EXT2_ROOT_INO) < 0) {
+		return -1;
+	}
+	if (dir_mkdir(img, &root, "lost+found", &sub) < 0) {
+		return -2;
+	}
+	img->inodes[sub.bw.ino - 1].i_mode = S_IFDIR | 0700;
+	dir_close(img, &sub);
+
+	if (img->spec.wide > 0) {
+		result = build_wide(img, &root);
+	}
+	if (result == 0 && img->spec.deep > 0) {
+		if ((result = dir_mkdir(img, &root, "deep", &sub)) == 0) {
+			result = build_deep_level(img, &sub, 0);
+			dir_close(img, &sub);
+		}
+	}
+	if (result == 0 && img->spec.tree > 0) {
+		unsigned int remaining = img->spec.tree;
+		if ((result = dir_mkdir(img, &root, "tree", &sub)) == 0) {
+			// 한 디렉토리의 자식 수가 모자라면 최상위에 다시 이어서 채움
+			while (result == 0 && remaining > 0 && !img->failed) {
+				result = build_tree_dir(img, &sub, 0, &remaining);
+			}
+			dir_close(img, &sub);
+		}
+	}
+	if (result == 0 && (result = dir_mkdir(img, &root, "files", &sub)) == 0) {
+		result = make_file(img, &sub, "small.txt", 0644, 3 * img->bs / 2, 0);
+		if (result == 0 && img->spec.big_size > 0) {
+			result = make_file(img, &sub, "big.txt", 0644, img->spec.big_size, 0);
+		}
+		if (result == 0 && img->spec.sparse_size > 0) {
+			result = make_file(img, &sub, "sparse.bin", 0644, img->spec.sparse_size, img->spec.sparse_gap);
+		}
+		dir_close(img, &sub);
+	}
+	dir_close(img, &root);
+	return (result < 0 || img->failed) ? -3 : 0;
+}
+
+/**
+ * 내용에 필요한 블록 수 추정 함수 (그룹 수를 자동으로 정할 때 사용)
+ */
+static unsigned long long	estimate_blocks(const GenSpec *spec)
+{
+	unsigned long long bs = spec->block_size;
+	unsigned long long ptrs = bs / 4;
+	unsigned long long blocks = 64;
+
+	blocks += (spec->big_size + bs - 1) / bs * (ptrs + 1) / ptrs + 3;
+	if (spec->sparse_size > 0) {
+		// 데이터 구간은 평균 4.5블록, 구멍은 평균 sparse_gap 블록
+		unsigned long long total = (spec->sparse_size + bs - 1) / bs;
+		blocks += total * 9 / (2 * spec->sparse_gap + 9) * (ptrs + 1) / ptrs + 2 * (total / ptrs / ptrs + 2);
+	}
+	blocks += (unsigned long long)spec->wide * 56 / bs + 2;
+	blocks += (unsigned long long)spec->deep * (1 + 2);
+	blocks += (unsigned long long)spec->tree * 2;
+	return blocks + blocks / 10;
+}
+
+/**
+ * 그룹 수, 그룹당 inode 수 등 배치 결정 함수
+ *
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+static int	plan_layout(GenImage *img)
+{
+	const GenSpec *spec = &img->spec;
+	unsigned int bs = spec->block_size;
+	unsigned int inodes_per_block = bs / sizeof(struct my_ext2_inode);
+	unsigned int inode_align = inodes_per_block > 8 ? inodes_per_block : 8;
+	unsigned long long inodes_needed = 16ULL + spec->wide + 3ULL * (spec->deep + 1) + spec->tree;
+	unsigned long long blocks_needed = estimate_blocks(spec);
+
+	img->bs = bs;
+	img->first_data_block = bs == 1024 ? 1 : 0;
+	img->bpg = spec->blocks_per_group != 0 ? spec->blocks_per_group : bs * 8;
+	if (img->bpg % 8 != 0 || img->bpg > bs * 8 || img->bpg < 64) {
+		fprintf(stderr, "gen_image: --blocks-per-group must be a multiple of 8 in [64, %u]\n", bs * 8);
+		return -1;
+	}
+
+	for (unsigned int groups = spec->groups != 0 ? spec->groups : 1; ; groups++) {
+		unsigned long long ipg = spec->inodes_per_group;
+		if (ipg == 0) {
+			ipg = (inodes_needed + inodes_needed / 8 + groups - 1) / groups;
+			ipg = (ipg + inode_align - 1) / inode_align * inode_align;
+		}
+		if ((unsigned long long)groups * img->bpg + img->first_data_block > UINT32_MAX) {
+			fprintf(stderr, "gen_image: content does not fit in a 32-bit block count\n");
+			return -2;
+		}
+
+		img->groups = groups;
+		img->ipg = (unsigned int)ipg;
+		img->gdt_blocks = (unsigned int)((groups * sizeof(struct my_ext2_group_desc) + bs - 1) / bs);
+		img->itable_blocks = (unsigned int)((ipg * sizeof(struct my_ext2_inode) + bs - 1) / bs);
+
+		unsigned long long overhead = 0;
+		for (unsigned int g = 0; g < groups; g++) {
+			overhead += 2 + img->itable_blocks + (group_has_super(g) ? 1 + img->gdt_blocks : 0);
+		}
+		bool fits = ipg <= bs * 8 && ipg % inode_align == 0 && 2 + img->itable_blocks + 1 + img->gdt_blocks < img->bpg
+					&& (unsigned long long)groups * img->bpg > overhead + blocks_needed
+					&& (spec->inodes_per_group != 0 || (unsigned long long)groups * ipg >= inodes_needed);
+		if (fits) {
+			break;
+		}
+		if (spec->groups != 0) {
+			fprintf(stderr, "gen_image: content needs more than %u groups (about %llu blocks, %llu inodes)\n",
+					groups, blocks_needed, inodes_needed);
+			return -3;
+		}
+	}
+
+	img->blocks_count = img->first_data_block + img->groups * img->bpg;
+	img->inodes_count = img->groups * img->ipg;
+	return 0;
+}
+
+/**
+ * 텍스트 패턴 생성 함수 (길이 0~120의 단어 라인)
+ */
+static void	make_text(GenImage *img)
+{
+	static const char *words[] = {
+		"ext2", "inode", "block", "group", "bitmap", "indirect", "extent", "directory",
+		"entry", "superblock", "the", "a", "of", "and", "to", "read", "write", "cache"
+	};
+	size_t pos = 0;
+
+	while (pos < GEN_TEXT_BYTES) {
+		unsigned int line_len = gen_range(img, 121);
+		size_t line_end = pos + line_len;
+		while (pos < line_end && pos < GEN_TEXT_BYTES) {
+			const char *word = words[gen_range(img, sizeof(words) / sizeof(words[0]))];
+			for (size_t i = 0; word[i] != '\0' && pos < GEN_TEXT_BYTES; i++) {
+				img->text[pos++] = (unsigned char)word[i];
+			}
+			if (pos < GEN_TEXT_BYTES) {
+				img->text[pos++] = ' ';
+			}
+		}
+		if (pos < GEN_TEXT_BYTES) {
+			img->text[pos++] = '\n';
+		}
+	}
+}
+
+/**
+ * 이미지 메모리 준비 함수 (그룹 메타데이터 블록을 비트맵에 표시)
+ */
+static int	init_image(GenImage *img)
+{
+	img->block_bitmap = (unsigned char *)calloc(img->groups, img->bs);
+	img->inode_bitmap = (unsigned char *)calloc(img->groups, img->bs);
+	img->inodes = (struct my_ext2_inode *)calloc(img->inodes_count, sizeof(struct my_ext2_inode));
+	img->used_dirs = (unsigned short *)calloc(img->groups, sizeof(unsigned short));
+	img->text = (unsigned char *)malloc(GEN_TEXT_BYTES);
+	img->batch = (unsigned char *)malloc((size_t)GEN_WRITE_BATCH * img->bs);
+	if (img->block_bitmap == NULL || img->inode_bitmap == NULL || img->inodes == NULL
+		|| img->used_dirs == NULL || img->text == NULL || img->batch == NULL) {
+		return -1;
+	}
+
+	for (unsigned int g = 0; g < img->groups; g++) {
+		unsigned int block_bitmap;
+		unsigned int data_start = group_layout(img, g, &block_bitmap);
+		for (unsigned int b = img->first_data_block + g * img->bpg; b < data_start; b++) {
+			mark_block(img, b);
+		}
+		// 비트맵 블록에서 그룹 범위를 넘는 비트는 사용 중으로 채움
+		for (unsigned int bit = img->bpg; bit < img->bs * 8; bit++) {
+			img->block_bitmap[(size_t)g * img->bs + bit / 8] |= (unsigned char)(1U << (bit % 8));
+		}
+		for (unsigned int bit = img->ipg; bit < img->bs * 8; bit++) {
+			img->inode_bitmap[(size_t)g * img->bs + bit / 8] |= (unsigned char)(1U << (bit % 8));
+		}
+	}
+	img->next_block = img->first_data_block;
+	make_text(img);
+	return 0;
+}
+
+/**
+ * 비트맵에서 그룹의 빈 칸 수를 세는 함수
+ */
+static unsigned int	count_free(const unsigned char *bitmap, unsigned int bits)
+{
+	unsigned int free_count = 0;
+
+	for (unsigned int bit = 0; bit < bits; bit++) {
+		if (((bitmap[bit / 8] >> (bit % 8)) & 1) == 0) {
+			free_count++;
+		}
+	}
+	return free_count;
+}
+
+/**
+ * 슈퍼블록, 그룹 디스크립터, 비트맵, inode 테이블 기록 함수
+ */
+static int	write_metadata(GenImage *img)
+{
+	unsigned int bs = img->bs;
+	size_t gdt_bytes = (size_t)img->gdt_blocks * bs;
+	struct my_ext2_group_desc *gd = (struct my_ext2_group_desc *)calloc(1, gdt_bytes);
+	if (gd == NULL) {
+		return -1;
+	}
+
+	unsigned int free_blocks = 0;
+	unsigned int free_inodes = 0;
+	for (unsigned int g = 0; g < img->groups; g++) {
+		unsigned int block_bitmap;
+		group_layout(img, g, &block_bitmap);
+		gd[g].bg_block_bitmap = block_bitmap;
+		gd[g].bg_inode_bitmap = block_bitmap + 1;
+		gd[g].bg_inode_table = block_bitmap + 2;
+		gd[g].bg_free_blocks_count = (__u16)count_free(img->block_bitmap + (size_t)g * bs, img->bpg);
+		gd[g].bg_free_inodes_count = (__u16)count_free(img->inode_bitmap + (size_t)g * bs, img->ipg);
+		gd[g].bg_used_dirs_count = img->used_dirs[g];
+		free_blocks += gd[g].bg_free_blocks_count;
+		free_inodes += gd[g].bg_free_inodes_count;
+
+		write_block(img, block_bitmap, img->block_bitmap + (size_t)g * bs);
+		write_block(img, block_bitmap + 1, img->inode_bitmap + (size_t)g * bs);
+		size_t itable_bytes = (size_t)img->ipg * sizeof(struct my_ext2_inode);
+		if (pwrite(img->fd, &img->inodes[(size_t)g * img->ipg], itable_bytes,
+				   (off_t)gd[g].bg_inode_table * bs) != (ssize_t)itable_bytes) {
+			img->failed = true;
+		}
+	}
+
+	struct my_ext2_super_block sb;
+	memset(&sb, 0, sizeof(sb));
+	sb.s_inodes_count = img->inodes_count;
+	sb.s_blocks_count = img->blocks_count;
+	sb.s_free_blocks_count = free_blocks;
+	sb.s_free_inodes_count = free_inodes;
+	sb.s_first_data_block = img->first_data_block;
+	sb.s_log_block_size = (__u32)__builtin_ctz(bs / 1024);
+	sb.s_log_frag_size = sb.s_log_block_size;
+	sb.s_blocks_per_group = img->bpg;
+	sb.s_frags_per_group = img->bpg;
+	sb.s_inodes_per_group = img->ipg;
+	sb.s_wtime = GEN_TIMESTAMP;
+	sb.s_lastcheck = GEN_TIMESTAMP;
+	sb.s_max_mnt_count = -1;
+	sb.s_magic = EXT2_SUPER_MAGIC;
+	sb.s_state = 1;
+	sb.s_errors = 1;
+	sb.s_rev_level = 1;
+	sb.s_first_ino = 11;
+	sb.s_inode_size = sizeof(struct my_ext2_inode);
+	sb.s_feature_incompat = FEATURE_INCOMPAT_FILETYPE;
+	sb.s_feature_ro_compat = FEATURE_RO_COMPAT_SPARSE_SUPER;
+	for (int i = 0; i < 16; i += 8) {
+		unsigned long long r = gen_rand(img);
+		memcpy(sb.s_uuid + i, &r, 8);
+	}
+	snprintf(sb.s_volume_name, sizeof(sb.s_volume_name), "ssu-bench");
+
+	// 주 슈퍼블록은 1024바이트 위치, 사본은 해당 그룹의 첫 블록
+	for (unsigned int g = 0; g < img->groups; g++) {
+		if (!group_has_super(g)) {
+			continue;
+		}
+		unsigned int start = img->first_data_block + g * img->bpg;
+		off_t sb_offset = g == 0 ? 1024 : (off_t)start * bs;
+		sb.s_block_group_nr = (__u16)g;
+		if (pwrite(img->fd, &sb, sizeof(sb), sb_offset) != (ssize_t)sizeof(sb)
+			|| pwrite(img->fd, gd, gdt_bytes, (off_t)(start + 1) * bs) != (ssize_t)gdt_bytes) {
+			img->failed = true;
+		}
+	}
+
+	free(gd);
+	return img->failed ? -2 : 0;
+}
+
+/**
+ * 이미지 메모리 해제 함수
+ */
+static void	free_image(GenImage *img)
+{
+	free(img->block_bitmap);
+	free(img->inode_bitmap);
+	free(img->inodes);
+	free(img->used_dirs);
+	free(img->text);
+	free(img->batch);
+}
+
+/**
+ * 크기 인자 파싱 함수 (숫자 뒤에 K, M, G 허용)
+ *
+ * @return 성공 시 true, 실패 시 false
+ */
+static bool	parse_size(const char *str, unsigned long long *value)
+{
+	char *endptr;
+	unsigned long long num;
+
+	if (!isdigit((unsigned char)str[0])) {
+		return false;
+	}
+	num = strtoull(str, &endptr, 10);
+	switch (*endptr) {
+		case 'K': num <<= 10; endptr++; break;
+		case 'M': num <<= 20; endptr++; break;
+		case 'G': num <<= 30; endptr++; break;
+		default: break;
+	}
+	if (*endptr != '\0') {
+		return false;
+	}
+	*value = num;
+	return true;
+}
+
+/**
+ * 사용법 출력 함수
+ */
+static void	usage(void)
+{
+	printf("Usage : ./gen_image [OPTION]... <OUTPUT_IMAGE>\n");
+	printf("  --block-size=<1024|2048|4096>  block size (default 1024)\n");
+	printf("  --groups=<N>                   block group count (default: fit content)\n");
+	printf("  --blocks-per-group=<N>         blocks per group (default: block size * 8)\n");
+	printf("  --inodes-per-group=<N>         inodes per group (default: fit content)\n");
+	printf("  --seed=<N>                     random seed (default 1)\n");
+	printf("  --wide=<N>                     /wide with N empty files\n");
+	printf("  --deep=<N>                     /deep with N nested directories\n");
+	printf("  --tree=<N>                     /tree with N random entries\n");
+	printf("  --big-file=<SIZE>              /files/big.txt of SIZE bytes (K, M, G suffix)\n");
+	printf("  --sparse-file=<SIZE>           /files/sparse.bin of SIZE bytes with holes\n");
+	printf("  --sparse-gap=<N>               average hole length in blocks (default 1024)\n");
+}
+
+/**
+ * 명령행 옵션 파싱 함수
+ *
+ * @return 성공 시 true, 실패 시 false
+ */
+static bool	parse_gen_options(int argc, char *argv[], GenSpec *spec)
+{
+	memset(spec, 0, sizeof(GenSpec));
+	spec->block_size = 1024;
+	spec->seed = 1;
+	spec->sparse_gap = 1024;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *value = strchr(arg, '=');
+		unsigned long long num = 0;
+
+		if (strncmp(arg, "--", 2) != 0) {
+			if (spec->output != NULL) {
+				return false;
+			}
+			spec->output = arg;
+			continue;
+		}
+		if (value == NULL || !parse_size(value + 1, &num)) {
+			return false;
+		}
+
+		size_t key_len = (size_t)(value - arg);
+		if (key_len == 12 && strncmp(arg, "--block-size", key_len) == 0) {
+			if (num != 1024 && num != 2048 && num != 4096) {
+				return false;
+			}
+			spec->block_size = (unsigned int)num;
+		}
+		else if (key_len == 8 && strncmp(arg, "--groups", key_len) == 0 && num <= UINT32_MAX) {
+			spec->groups = (unsigned int)num;
+		}
+		else if (key_len == 18 && strncmp(arg, "--blocks-per-group", key_len) == 0 && num <= UINT32_MAX) {
+			spec->blocks_per_group = (unsigned int)num;
+		}
+		else if (key_len == 18 && strncmp(arg, "--inodes-per-group", key_len) == 0 && num <= UINT32_MAX) {
+			spec->inodes_per_group = (unsigned int)num;
+		}
+		else if (key_len == 6 && strncmp(arg, "--seed", key_len) == 0) {
+			spec->seed = num;
+		}
+		else if (key_len == 6 && strncmp(arg, "--wide", key_len) == 0 && num <= UINT32_MAX) {
+			spec->wide = (unsigned int)num;
+		}
+		else if (key_len == 6 && strncmp(arg, "--deep", key_len) == 0 && num <= 10000) {
+			spec->deep = (unsigned int)num;
+		}
+		else if (key_len == 6 && strncmp(arg, "--tree", key_len) == 0 && num <= UINT32_MAX) {
+			spec->tree = (unsigned int)num;
+		}
+		else if (key_len == 10 && strncmp(arg, "--big-file", key_len) == 0 && num <= UINT32_MAX) {
+			spec->big_size = num;
+		}
+		else if (key_len == 13 && strncmp(arg, "--sparse-file", key_len) == 0 && num <= UINT32_MAX) {
+			spec->sparse_size = num;
+		}
+		else if (key_len == 12 && strncmp(arg, "--sparse-gap", key_len) == 0 && num >= 1 && num <= UINT32_MAX / 2) {
+			spec->sparse_gap = (unsigned int)num;
+		}
+		else {
+			return false;
+		}
+	}
+	return spec->output != NULL;
+}
+
+int	main(int argc, char *argv[])
+{
+	GenImage img;
+
+	memset(&img, 0, sizeof(GenImage));
+	if (!parse_gen_options(argc, argv, &img.spec)) {
+		usage();
+		return 1;
+	}
+	img.rng = img.spec.seed;
+
+	if (plan_layout(&img) < 0 || init_image(&img) < 0) {
+		free_image(&img);
+		return 1;
+	}
+
+	if ((img.fd = open(img.spec.output, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		fprintf(stderr, "gen_image: cannot create %s: %s\n", img.spec.output, strerror(errno));
+		free_image(&img);
+		return 1;
+	}
+
+	int result = 0;
+	if (ftruncate(img.fd, (off_t)img.blocks_count * img.bs) < 0 || build_content(&img) < 0
+		|| write_metadata(&img) < 0) {
+		result = 1;
+	}
+	if (close(img.fd) < 0) {
+		result = 1;
+	}
+	free_image(&img);
+
+	if (result != 0) {
+		fprintf(stderr, "gen_image: failed to write %s\n", img.spec.output);
+		unlink(img.spec.output);
+		return result;
+	}
+	printf("%s: %u-byte blocks, %u groups, %u blocks, %u inodes (%u used)\n", img.spec.output,
+		   img.bs, img.groups, img.blocks_count, img.inodes_count, img.next_inode - 1);
+	return 0;
+}
@@ -0,0 +1,780 @@
+#include "../ssu_ext2.h"
+
+/*
+ * 엔트리 단위 핵심 루틴 마이크로벤치마크
+ * 메모리에 만든 가짜 이미지(슈퍼블록 값, 그룹 디스크립터, inode 테이블, 디렉토리 블록)를 ctx->map에 연결해서
+ * 매핑 경로로 실행하므로 시스템 콜이나 페이지 캐시 없이 루틴 자체의 비용만 잼
+ * 블록 크기와 이름 길이 분포별로 엔트리 하나당 ns와 초당 처리 엔트리 수를 보고
+ *
+ *   dirent  dir_stream_open/next (엔트리 디코딩, 숨은 엔트리 판별, 엔트리마다 read_inode)
+ *   lookup  find_entry_in_dir (디렉토리 곳곳의 이름 찾기, 비교한 엔트리 수 기준)
+ *   inode   read_inode (inode 번호 무작위 순서)
+ *   render  print_tree_node (-s -p 한 줄 출력, 출력 버퍼는 비우기만 하고 write하지 않음)
+ */
+
+#define MICRO_INODES_PER_GROUP 8192
+#define MICRO_DIR_INODE 2
+#define MICRO_FIRST_INODE 12			// 엔트리 inode는 여기서부터 차례로 (예약 inode 다음)
+#define MICRO_DEFAULT_ENTRIES 20000
+#define MICRO_MAX_ENTRIES 200000
+#define MICRO_LOOKUPS 64				// lookup 커널이 찾는 이름 수
+#define MICRO_MAX_ROUNDS 50
+
+/**
+ * 이름 길이 분포 구조체
+ */
+typedef struct micro_names {
+	const char *name;
+	unsigned int short_min;			// 대부분(short_percent%)의 이름 길이 범위
+	unsigned int short_max;
+	unsigned int long_min;			// 나머지 이름 길이 범위
+	unsigned int long_max;
+	unsigned int short_percent;
+} MicroNames;
+
+static const MicroNames	name_dists[] = {
+	{ "short", 3,   12,  3,   12,  100 },
+	{ "mixed", 4,   20,  21,  128, 80 },
+	{ "long",  128, 255, 128, 255, 100 },
+};
+
+static const unsigned int	block_sizes[] = { 1024, 2048, 4096 };
+
+/**
+ * 실행 옵션 구조체
+ */
+typedef struct micro_options {
+	unsigned int entries;			// 디렉토리 하나의 엔트리 수 (블록 맵이 단일 간접 블록까지만 쓰도록 줄어들 수 있음)
+	unsigned int rounds;			// 측정 반복 횟수 (중앙값 보고)
+	unsigned int min_ms;			// 측정 한 번의 최소 시간
+	unsigned long long seed;
+	const char *filter;				// 이름에 이 문자열이 들어간 커널만 실행
+	const char *output;				// JSON 출력 파일 (NULL이면 기록하지 않음)
+} MicroOptions;
+
+/**
+ * 메모리 이미지 구조체 (블록 크기와 이름 분포 조합 하나)
+ */
+typedef struct micro_image {
+	Ext2Context ctx;
+	unsigned char *data;			// 이미지 전체 (ctx.map)
+	unsigned int entries;			// 실제로 넣은 엔트리 수 ("."과 ".." 제외)
+	unsigned int dir_blocks;
+	char **names;					// 엔트리 이름 (디스크 순서)
+	unsigned int *positions;		// lookup 대상 엔트리 번호
+	unsigned long long lookup_scanned;	// lookup 한 번에 비교하는 엔트리 수 합 ("."과 ".." 포함)
+	unsigned long long name_bytes;
+} MicroImage;
+
+/**
+ * 커널 하나의 측정 결과 구조체
+ */
+typedef struct micro_result {
+	double ns_per_entry_median;
+	double ns_per_entry_min;
+	double entries_per_sec;
+	unsigned long long entries;		// 실행 한 번이 처리한 엔트리 수
+	unsigned int rounds;
+} MicroResult;
+
+typedef unsigned long long	(*MicroKernel)(MicroImage *img);
+
+static volatile unsigned long long	sink;	// 컴파일러가 결과를 버리지 않도록
+
+/**
+ * 현재 시각 (나노초, 단조 시계)
+ */
+static unsigned long long	now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+/**
+ * splitmix64 난수 (시드가 같으면 같은 이미지)
+ */
+static unsigned long long	next_random(unsigned long long *state)
+{
+	unsigned long long z = (*state += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * 엔트리 번호로 중복 없는 이름을 만드는 함수
+ * 앞 세 글자는 번호의 62진수 표기, 나머지는 무작위 영숫자
+ */
+static char	*make_name(unsigned int index, const MicroNames *dist, unsigned long long *rng)
+{
+	static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	unsigned int min = dist->short_min;
+	unsigned int max = dist->short_max;
+
+	if (next_random(rng) % 100 >= dist->short_percent) {
+		min = dist->long_min;
+		max = dist->long_max;
+	}
+	unsigned int len = min + (unsigned int)(next_random(rng) % (max - min + 1));
+
+	char *name = (char *)malloc(len + 1);
+	if (name == NULL) {
+		return NULL;
+	}
+	name[0] = digits[index / (62 * 62) % 62];
+	name[1] = digits[index / 62 % 62];
+	name[2] = digits[index % 62];
+	for (unsigned int i = 3; i < len; i++) {
+		name[i] = digits[next_random(rng) % 62];
+	}
+	name[len] = '\0';
+	return name;
+}
+
+/**
+ * 디렉토리 블록에 엔트리 하나를 쓰는 함수
+ */
+static void	put_entry(unsigned char *block, unsigned int offset, unsigned int inode_num,
+					  unsigned int rec_len, const char *name, unsigned int name_len, unsigned char file_type)
+{
+	struct my_ext2_dir_entry_2 *entry = (struct my_ext2_dir_entry_2 *)(block + offset);
+
+	entry->inode = inode_num;
+	entry->rec_len = (__u16)rec_len;
+	entry->name_len = (__u8)name_len;
+	entry->file_type = file_type;
+	memcpy(entry->name, name, name_len);
+}
+
+/**
+ * 엔트리 하나가 차지하는 최소 크기 (8바이트 헤더 + 이름, 4바이트 정렬)
+ */
+static unsigned int	dirent_size(unsigned int name_len)
+{
+	return (8 + name_len + 3) & ~3U;
+}
+
+/**
+ * inode 테이블의 inode 하나를 채우는 함수
+ */
+static void	put_inode(MicroImage *img, unsigned int inode_num, unsigned int mode, unsigned int size)
+{
+	Ext2Context *ctx = &img->ctx;
+	unsigned int group = (inode_num - 1) / ctx->sb.s_inodes_per_group;
+	unsigned int index = (inode_num - 1) % ctx->sb.s_inodes_per_group;
+	struct my_ext2_inode *inode = (struct my_ext2_inode *)(img->data
+		+ (size_t)ctx->gd[group].bg_inode_table * ctx->block_size + (size_t)index * ctx->inode_size);
+
+	inode->i_mode = (__u16)mode;
+	inode->i_size = size;
+	inode->i_links_count = 1;
+}
+
+/**
+ * 메모리 이미지 해제 함수
+ */
+static void	micro_image_destroy(MicroImage *img)
+{
+	if (img->names != NULL) {
+		for (unsigned int i = 0; i < img->entries; i++) {
+			free(img->names[i]);
+		}
+	}
+	free(img->names);
+	free(img->positions);
+	free(img->ctx.gd);
+	free(img->data);
+	memset(img, 0, sizeof(MicroImage));
+}
+
+/**
+ * 메모리 이미지 생성 함수
+ * 블록 0은 비워 두고, 1번 블록부터 그룹별 inode 테이블, 디렉토리 데이터 블록, 단일 간접 블록 순서로 배치
+ * 디렉토리는 직접 블록 12개와 단일 간접 블록 하나로 표현할 수 있는 만큼만 채움
+ *
+ * @param img 초기화할 메모리 이미지 포인터
+ * @param block_size 블록 크기
+ * @param dist 이름 길이 분포
+ * @param entries 넣을 엔트리 수
+ * @param seed 난수 시드
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+static int	micro_image_init(MicroImage *img, unsigned int block_size, const MicroNames *dist,
+							 unsigned int entries, unsigned long long seed)
+{
+	Ext2Context *ctx = &img->ctx;
+	unsigned long long rng = seed ^ ((unsigned long long)block_size << 32) ^ (unsigned long long)dist->short_min;
+
+	memset(img, 0, sizeof(MicroImage));
+	img->names = (char **)calloc(entries, sizeof(char *));
+	if (img->names == NULL) {
+		return -1;
+	}
+
+	// 이름을 먼저 만들고 필요한 디렉토리 블록 수 계산 (블록 수가 한도를 넘으면 엔트리 수를 줄임)
+	unsigned int max_blocks = EXT2_NDIR_BLOCKS + block_size / sizeof(__u32);
+	unsigned int blocks = 1;
+	unsigned int used = dirent_size(1) + dirent_size(2);
+	for (unsigned int i = 0; i < entries; i++) {
+		char *name = make_name(i, dist, &rng);
+		if (name == NULL) {
+			micro_image_destroy(img);
+			return -1;
+		}
+		unsigned int size = dirent_size((unsigned int)strlen(name));
+		if (used + size > block_size) {
+			if (blocks == max_blocks) {
+				free(name);
+				break;
+			}
+			blocks++;
+			used = 0;
+		}
+		used += size;
+		img->names[img->entries++] = name;
+		img->name_bytes += strlen(name);
+	}
+	img->dir_blocks = blocks;
+
+	// 슈퍼블록에서 유도되는 값
+	unsigned int inode_count = MICRO_FIRST_INODE + img->entries;
+	unsigned int groups = (inode_count + MICRO_INODES_PER_GROUP - 1) / MICRO_INODES_PER_GROUP;
+	ctx->fd = -1;
+	ctx->uring.fd = -1;
+	ctx->block_size = block_size;
+	ctx->inode_size = 128;
+	ctx->ptrs_per_block = block_size / sizeof(__u32);
+	ctx->inodes_per_block = block_size / ctx->inode_size;
+	ctx->sb.s_log_block_size = block_size == 1024 ? 0 : block_size == 2048 ? 1 : 2;
+	ctx->sb.s_inodes_per_group = MICRO_INODES_PER_GROUP;
+	ctx->sb.s_inodes_count = groups * MICRO_INODES_PER_GROUP;
+	ctx->group_count = groups;
+	ctx->gd = (struct my_ext2_group_desc *)calloc(groups, sizeof(struct my_ext2_group_desc));
+	if (ctx->gd == NULL) {
+		micro_image_destroy(img);
+		return -1;
+	}
+
+	unsigned int table_blocks = MICRO_INODES_PER_GROUP * ctx->inode_size / block_size;
+	unsigned int next_block = 1;
+	for (unsigned int g = 0; g < groups; g++) {
+		ctx->gd[g].bg_inode_table = next_block;
+		next_block += table_blocks;
+	}
+	unsigned int first_dir_block = next_block;
+	unsigned int indirect_block = first_dir_block + blocks;
+	unsigned int total_blocks = indirect_block + 1;
+
+	img->data = (unsigned char *)calloc(total_blocks, block_size);
+	if (img->data == NULL) {
+		micro_image_destroy(img);
+		return -1;
+	}
+	ctx->map = img->data;
+	ctx->map_size = (size_t)total_blocks * block_size;
+
+	// 디렉토리 inode (직접 블록 12개 + 단일 간접 블록)
+	put_inode(img, MICRO_DIR_INODE, S_IFDIR | 0755, blocks * block_size);
+	struct my_ext2_inode *dir = (struct my_ext2_inode *)(img->data
+		+ (size_t)ctx->gd[0].bg_inode_table * block_size + (MICRO_DIR_INODE - 1) * ctx->inode_size);
+	__u32 *indirect = (__u32 *)(img->data + (size_t)indirect_block * block_size);
+	for (unsigned int b = 0; b < blocks; b++) {
+		if (b < EXT2_NDIR_BLOCKS) {
+			dir->i_block[b] = first_dir_block + b;
+		} else {
+			indirect[b - EXT2_NDIR_BLOCKS] = first_dir_block + b;
+		}
+	}
+	if (blocks > EXT2_NDIR_BLOCKS) {
+		dir->i_block[EXT2_IND_BLOCK] = indirect_block;
+	}
+
+	// 디렉토리 블록 채우기 (블록의 마지막 엔트리가 남은 공간을 rec_len으로 가짐)
+	unsigned char *block = img->data + (size_t)first_dir_block * block_size;
+	unsigned int offset = 0;
+	unsigned int last = 0;
+	put_entry(block, 0, MICRO_DIR_INODE, dirent_size(1), ".", 1, EXT2_FT_DIR);
+	put_entry(block, dirent_size(1), MICRO_DIR_INODE, dirent_size(2), "..", 2, EXT2_FT_DIR);
+	last = dirent_size(1);
+	offset = dirent_size(1) + dirent_size(2);
+	for (unsigned int i = 0; i < img->entries; i++) {
+		unsigned int name_len = (unsigned int)strlen(img->names[i]);
+		unsigned int size = dirent_size(name_len);
+		if (offset + size > block_size) {
+			((struct my_ext2_dir_entry_2 *)(block + last))->rec_len = (__u16)(block_size - last);
+			block += block_size;
+			offset = 0;
+		}
+		bool is_dir = i % 8 == 7;
+		unsigned int inode_num = MICRO_FIRST_INODE + i;
+		put_entry(block, offset, inode_num, size, img->names[i], name_len, is_dir ? EXT2_FT_DIR : EXT2_FT_REG_FILE);
+		put_inode(img, inode_num, is_dir ? (S_IFDIR | 0755) : (S_IFREG | 0644), is_dir ? block_size : i * 37);
+		last = offset;
+		offset += size;
+	}
+	((struct my_ext2_dir_entry_2 *)(block + last))->rec_len = (__u16)(block_size - last);
+
+	// lookup 대상: 디렉토리 전체에 고르게 퍼진 엔트리 (마지막 엔트리 포함)
+	unsigned int lookups = img->entries < MICRO_LOOKUPS ? img->entries : MICRO_LOOKUPS;
+	img->positions = (unsigned int *)malloc(lookups * sizeof(unsigned int));
+	if (img->positions == NULL) {
+		micro_image_destroy(img);
+		return -1;
+	}
+	for (unsigned int q = 0; q < lookups; q++) {
+		img->positions[q] = (unsigned int)((unsigned long long)(img->entries - 1) * (q + 1) / lookups);
+		img->lookup_scanned += img->positions[q] + 3;	// ".", ".." 포함
+	}
+	return 0;
+}
+
+/**
+ * 메모리 이미지를 실제 루틴으로 한 번 읽어 보는 함수 (측정 전에 이미지가 올바른지 확인)
+ *
+ * @return 엔트리 수와 찾은 inode 번호가 모두 맞으면 0, 아니면 음수 값 반환
+ */
+static int	micro_image_verify(MicroImage *img)
+{
+	DirStream ds;
+	DirStreamEntry entry;
+	struct my_ext2_inode dir;
+	unsigned int count = 0;
+
+	if (dir_stream_open(&ds, &img->ctx, MICRO_DIR_INODE) < 0) {
+		return -1;
+	}
+	while (dir_stream_next(&ds, &entry)) {
+		if (entry.inode_num != MICRO_FIRST_INODE + count) {
+			break;
+		}
+		count++;
+	}
+	dir_stream_close(&ds);
+	if (count != img->entries || read_inode(&img->ctx, MICRO_DIR_INODE, &dir) < 0) {
+		return -2;
+	}
+
+	unsigned int lookups = img->entries < MICRO_LOOKUPS ? img->entries : MICRO_LOOKUPS;
+	for (unsigned int q = 0; q < lookups; q++) {
+		unsigned int pos = img->positions[q];
+		if (find_entry_in_dir(&img->ctx, &dir, img->names[pos]) != MICRO_FIRST_INODE + pos) {
+			return -3;
+		}
+	}
+	return 0;
+}
+
+/**
+ * dirent 커널: 디렉토리 스트림으로 모든 엔트리 꺼내기
+ */
+static unsigned long long	kernel_dirent(MicroImage *img)
+{
+	DirStream ds;
+	DirStreamEntry entry;
+	unsigned long long count = 0;
+	unsigned long long sum = 0;
+
+	if (dir_stream_open(&ds, &img->ctx, MICRO_DIR_INODE) < 0) {
+		return 0;
+	}
+	while (dir_stream_next(&ds, &entry)) {
+		sum += entry.size;
+		count++;
+	}
+	dir_stream_close(&ds);
+	sink += sum;
+	return count;
+}
+
+/**
+ * lookup 커널: 디렉토리 곳곳의 이름을 find_entry_in_dir로 찾기 (비교한 엔트리 수 반환)
+ */
+static unsigned long long	kernel_lookup(MicroImage *img)
+{
+	struct my_ext2_inode dir;
+	unsigned int lookups = img->entries < MICRO_LOOKUPS ? img->entries : MICRO_LOOKUPS;
+	unsigned long long sum = 0;
+
+	if (read_inode(&img->ctx, MICRO_DIR_INODE, &dir) < 0) {
+		return 0;
+	}
+	for (unsigned int q = 0; q < lookups; q++) {
+		sum += find_entry_in_dir(&img->ctx, &dir, img->names[img->positions[q]]);
+	}
+	sink += sum;
+	return img->lookup_scanned;
+}
+
+/**
+ * inode 커널: 모든 엔트리의 inode를 무작위 순서로 읽기 (곱셈 순열, 엔트리 수와 서로소인 보폭)
+ */
+static unsigned long long	kernel_inode(MicroImage *img)
+{
+	struct my_ext2_inode inode;
+	unsigned int n = img->entries;
+	unsigned int stride = 2654435761u % n;
+	unsigned long long sum = 0;
+
+	while (true) {
+		unsigned int a = stride;
+		unsigned int b = n;
+		while (b != 0) {
+			unsigned int t = a % b;
+			a = b;
+			b = t;
+		}
+		if (a == 1) {
+			break;
+		}
+		stride++;
+	}
+	unsigned int index = 0;
+	for (unsigned int i = 0; i < n; i++) {
+		index = (unsigned int)(((unsigned long long)index + stride) % n);
+		if (read_inode(&img->ctx, MICRO_FIRST_INODE + index, &inode) == 0) {
+			sum += inode.i_size;
+		}
+	}
+	sink += sum;
+	return n;
+}
+
+/**
+ * render 커널 상태 (트리는 한 번만 만들고 출력만 반복)
+ */
+static Arena		render_arena;
+static DirTree		render_tree;
+static unsigned int	render_root = TREE_NIL;
+static OutBuf		render_out;
+static TreePrefix	render_prefix;
+
+/**
+ * render 커널용 트리 생성 함수 (루트 아래에 엔트리를 디스크 순서대로 붙임)
+ *
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+static int	render_setup(MicroImage *img)
+{
+	DirTreeCursor cursor;
+	int ret = 0;
+
+	arena_init(&render_arena, DEFAULT_ARENA_CHUNK);
+	dir_tree_init(&render_tree, &render_arena);
+	dir_tree_cursor_init(&cursor, &render_tree);
+
+	render_root = dir_tree_add(&cursor, "/micro", 6, MICRO_DIR_INODE, S_IFDIR | 0755, img->ctx.block_size);
+	if (render_root == TREE_NIL) {
+		ret = -1;
+	}
+	for (unsigned int i = 0; ret == 0 && i < img->entries; i++) {
+		bool is_dir = i % 8 == 7;
+		if (dir_tree_stage(&cursor, img->names[i], (unsigned int)strlen(img->names[i]), MICRO_FIRST_INODE + i,
+						   is_dir ? (S_IFDIR | 0755) : (S_IFREG | 0644), is_dir ? img->ctx.block_size : i * 37) < 0) {
+			ret = -1;
+		}
+	}
+	if (ret == 0 && dir_tree_commit(&cursor, render_root) == TREE_NIL) {
+		ret = -1;
+	}
+	dir_tree_cursor_destroy(&cursor);
+
+	// 한 번 출력한 내용이 모두 들어가는 버퍼 (줄마다 접두사, 권한, 크기, 이름)
+	size_t capacity = (size_t)img->entries * 64 + img->name_bytes + 4096;
+	if (ret == 0 && out_buf_init(&render_out, -1, capacity) < 0) {
+		ret = -1;
+	}
+	return ret;
+}
+
+/**
+ * render 커널용 트리와 출력 버퍼 해제 함수
+ */
+static void	render_teardown(void)
+{
+	free(render_out.data);
+	memset(&render_out, 0, sizeof(OutBuf));
+	dir_tree_destroy(&render_tree);
+	arena_release(&render_arena);
+	render_root = TREE_NIL;
+	tree_prefix_destroy(&render_prefix);
+}
+
+/**
+ * render 커널: 루트의 자식을 tree -s -p 형식으로 출력
+ */
+static unsigned long long	kernel_render(MicroImage *img)
+{
+	const DirTreeNode *root = dir_tree_node(&render_tree, render_root);
+	unsigned int first_child = root->first_child;
+	unsigned int child_count = root->child_count;
+
+	(void)img;
+	render_out.len = 0;
+	for (unsigned int i = 0; i < child_count; i++) {
+		print_tree_node(&render_out, &render_tree, first_child + i, 0, TREE_OPT_S | TREE_OPT_P,
+						(i + 1 == child_count), &render_prefix);
+	}
+	sink += render_out.len;
+	return child_count;
+}
+
+/**
+ * 마이크로벤치마크 커널 목록
+ */
+typedef struct micro_kernel_def {
+	const char *name;
+	const char *routine;			// 측정 대상 함수
+	MicroKernel run;
+} MicroKernelDef;
+
+static const MicroKernelDef	kernels[] = {
+	{ "dirent", "dir_stream_next",   kernel_dirent },
+	{ "lookup", "find_entry_in_dir", kernel_lookup },
+	{ "inode",  "read_inode",        kernel_inode },
+	{ "render", "print_tree_node",   kernel_render },
+};
+
+/**
+ * double 오름차순 비교 함수 (qsort용)
+ */
+static int	compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * 커널 하나를 측정하는 함수
+ * 한 번 데운 뒤 실행 횟수를 최소 시간에 맞추고, 측정 여러 번의 엔트리당 ns 중앙값과 최솟값을 구함
+ *
+ * @return 성공 시 0, 커널이 엔트리를 처리하지 못하면 음수 값 반환
+ */
+static int	measure(const MicroOptions *opts, MicroKernel run, MicroImage *img, MicroResult *result)
+{
+	double samples[MICRO_MAX_ROUNDS];
+	unsigned long long per_call = run(img);
+
+	if (per_call == 0) {
+		return -1;
+	}
+
+	// 측정 한 번이 최소 시간 이상 걸리도록 실행 횟수 결정
+	unsigned long long target = (unsigned long long)opts->min_ms * 1000000ULL;
+	unsigned long long reps = 1;
+	while (true) {
+		unsigned long long start = now_ns();
+		for (unsigned long long r = 0; r < reps; r++) {
+			run(img);
+		}
+		unsigned long long elapsed = now_ns() - start;
+		if (elapsed >= target || reps >= (1ULL << 30)) {
+			break;
+		}
+		reps = elapsed == 0 ? reps * 16 : reps * target / elapsed + 1;
+	}
+
+	for (unsigned int round = 0; round < opts->rounds; round++) {
+		unsigned long long start = now_ns();
+		for (unsigned long long r = 0; r < reps; r++) {
+			run(img);
+		}
+		unsigned long long elapsed = now_ns() - start;
+		samples[round] = (double)elapsed / (double)(reps * per_call);
+	}
+	qsort(samples, opts->rounds, sizeof(double), compare_double);
+
+	result->ns_per_entry_min = samples[0];
+	result->ns_per_entry_median = opts->rounds % 2 ? samples[opts->rounds / 2]
+		: (samples[opts->rounds / 2 - 1] + samples[opts->rounds / 2]) / 2;
+	result->entries_per_sec = result->ns_per_entry_median > 0 ? 1e9 / result->ns_per_entry_median : 0;
+	result->entries = per_call;
+	result->rounds = opts->rounds;
+	return 0;
+}
+
+/**
+ * 측정 결과 하나를 JSON 객체로 출력하는 함수
+ */
+static void	json_result(FILE *fp, const MicroKernelDef *kernel, unsigned int block_size, const MicroNames *dist,
+						const MicroImage *img, const MicroResult *r, bool first)
+{
+	fprintf(fp, "%s\n    {\"name\": \"%s\", \"routine\": \"%s\", \"block_size\": %u, \"names\": \"%s\",\n",
+			first ? "" : ",", kernel->name, kernel->routine, block_size, dist->name);
+	fprintf(fp, "     \"dir_entries\": %u, \"dir_blocks\": %u, \"avg_name_len\": %.1f, \"entries_per_call\": %llu,\n",
+			img->entries, img->dir_blocks, img->entries ? (double)img->name_bytes / img->entries : 0.0, r->entries);
+	fprintf(fp, "     \"ns_per_entry\": {\"median\": %.2f, \"min\": %.2f}, \"entries_per_sec\": %.0f, \"rounds\": %u}",
+			r->ns_per_entry_median, r->ns_per_entry_min, r->entries_per_sec, r->rounds);
+}
+
+/**
+ * 사용법 출력 함수
+ */
+static void	usage(void)
+{
+	printf("Usage : ./ssu_microbench [OPTION]...\n");
+	printf("  --entries=<N>    entries per directory (1~%d, default %d)\n", MICRO_MAX_ENTRIES, MICRO_DEFAULT_ENTRIES);
+	printf("  --rounds=<N>     measurements per kernel, median is reported (1~%d, default 7)\n", MICRO_MAX_ROUNDS);
+	printf("  --min-ms=<N>     minimum time of one measurement (default 50)\n");
+	printf("  --seed=<N>       name generator seed (default 42)\n");
+	printf("  --filter=<TEXT>  run only kernels whose name contains TEXT\n");
+	printf("  --output=<FILE>  also write results as JSON\n");
+}
+
+/**
+ * 명령행의 양의 정수 옵션 값을 읽는 함수
+ *
+ * @return 성공 시 true, 범위를 벗어나거나 숫자가 아니면 false
+ */
+static bool	parse_number(const char *str, unsigned long long max, unsigned long long *value)
+{
+	char *endptr;
+
+	errno = 0;
+	unsigned long long num = strtoull(str, &endptr, 10);
+	if (*str == '\0' || *str == '-' || *endptr != '\0' || errno != 0 || num < 1 || num > max) {
+		return false;
+	}
+	*value = num;
+	return true;
+}
+
+/**
+ * 명령행 옵션 파싱 함수
+ *
+ * @return 성공 시 true, 실패 시 false
+ */
+static bool	parse_micro_options(int argc, char *argv[], MicroOptions *opts)
+{
+	unsigned long long value;
+
+	memset(opts, 0, sizeof(MicroOptions));
+	opts->entries = MICRO_DEFAULT_ENTRIES;
+	opts->rounds = 7;
+	opts->min_ms = 50;
+	opts->seed = 42;
+
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--entries=", 10) == 0) {
+			if (!parse_number(argv[i] + 10, MICRO_MAX_ENTRIES, &value)) {
+				return false;
+			}
+			opts->entries = (unsigned int)value;
+		}
+		else if (strncmp(argv[i], "--rounds=", 9) == 0) {
+			if (!parse_number(argv[i] + 9, MICRO_MAX_ROUNDS, &value)) {
+				return false;
+			}
+			opts->rounds = (unsigned int)value;
+		}
+		else if (strncmp(argv[i], "--min-ms=", 9) == 0) {
+			if (!parse_number(argv[i] + 9, 60000, &value)) {
+				return false;
+			}
+			opts->min_ms = (unsigned int)value;
+		}
+		else if (strncmp(argv[i], "--seed=", 7) == 0) {
+			if (!parse_number(argv[i] + 7, ~0ULL, &value)) {
+				return false;
+			}
+			opts->seed = value;
+		}
+		else if (strncmp(argv[i], "--filter=", 9) == 0) {
+			opts->filter = argv[i] + 9;
+		}
+		else if (strncmp(argv[i], "--output=", 9) == 0) {
+			opts->output = argv[i] + 9;
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+int	main(int argc, char *argv[])
+{
+	MicroOptions opts;
+	MicroImage img;
+	MicroResult result;
+
+	if (!parse_micro_options(argc, argv, &opts)) {
+		usage();
+		return 1;
+	}
+
+	FILE *json = NULL;
+	if (opts.output != NULL && (json = fopen(opts.output, "w")) == NULL) {
+		fprintf(stderr, "ssu_microbench: cannot create %s: %s\n", opts.output, strerror(errno));
+		return 1;
+	}
+	if (json != NULL) {
+		fprintf(json, "{\n  \"version\": 1,\n  \"entries\": %u,\n  \"rounds\": %u,\n  \"min_ms\": %u,\n"
+				"  \"seed\": %llu,\n  \"results\": [", opts.entries, opts.rounds, opts.min_ms, opts.seed);
+	}
+
+	printf("%-7s %-5s %-6s %8s %8s %12s %12s %14s\n",
+		   "kernel", "block", "names", "entries", "name_avg", "ns/entry", "ns/entry_min", "entries/sec");
+
+	bool first = true;
+	int failures = 0;
+	for (size_t b = 0; b < sizeof(block_sizes) / sizeof(block_sizes[0]); b++) {
+		for (size_t d = 0; d < sizeof(name_dists) / sizeof(name_dists[0]); d++) {
+			if (micro_image_init(&img, block_sizes[b], &name_dists[d], opts.entries, opts.seed) < 0) {
+				fprintf(stderr, "ssu_microbench: out of memory building %u/%s image\n",
+						block_sizes[b], name_dists[d].name);
+				failures++;
+				continue;
+			}
+			if (micro_image_verify(&img) < 0) {
+				fprintf(stderr, "ssu_microbench: %u/%s image does not read back correctly\n",
+						block_sizes[b], name_dists[d].name);
+				micro_image_destroy(&img);
+				failures++;
+				continue;
+			}
+			for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+				const MicroKernelDef *kernel = &kernels[k];
+				if (opts.filter != NULL && strstr(kernel->name, opts.filter) == NULL) {
+					continue;
+				}
+				if (kernel->run == kernel_render && render_setup(&img) < 0) {
+					render_teardown();
+					failures++;
+					continue;
+				}
+				int ret = measure(&opts, kernel->run, &img, &result);
+				if (kernel->run == kernel_render) {
+					render_teardown();
+				}
+				if (ret < 0) {
+					fprintf(stderr, "ssu_microbench: %s returned no entries (%u/%s)\n",
+							kernel->name, block_sizes[b], name_dists[d].name);
+					failures++;
+					continue;
+				}
+				printf("%-7s %-5u %-6s %8u %8.1f %12.2f %12.2f %14.0f\n", kernel->name, block_sizes[b],
+					   name_dists[d].name, img.entries, (double)img.name_bytes / img.entries,
+					   result.ns_per_entry_median, result.ns_per_entry_min, result.entries_per_sec);
+				fflush(stdout);
+				if (json != NULL) {
+					json_result(json, kernel, block_sizes[b], &name_dists[d], &img, &result, first);
+					first = false;
+				}
+			}
+			micro_image_destroy(&img);
+		}
+	}
+
+	if (json != NULL) {
+		fprintf(json, "\n  ]\n}\n");
+		if (fclose(json) != 0) {
+			return 1;
+		}
+	}
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+#include "ssu_ext2.h"
+
+/**
+ * 블록 번호를 해시하는 함수 (샤드 선택 및 버킷 선택에 사용)
+ *
+ * @param block_num 블록 번호
+ * @return 해시 값
+ */
+static unsigned int	hash_block(unsigned int block_num)
+{
+	unsigned int h = block_num * 0x9E3779B1u;
+	return h ^ (h >> 16);
+}
+
+/**
+ * 블록 캐시 초기화 함수
+ * 바이트 예산을 slot_size 단위 슬롯으로 나누고, 여러 샤드에 고르게 분배
+ *
+ * @param cache 초기화할 캐시 포인터
+ * @param slot_size 슬롯 하나의 크기 (데이터 블록 캐시는 블록 크기)
+ * @param budget_bytes 캐시 메모리 예산 (0이면 캐시 비활성화)
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+int	block_cache_init(BlockCache *cache, unsigned int slot_size, size_t budget_bytes)
+{
+	memset(cache, 0, sizeof(BlockCache));
+	cache->slot_size = slot_size;
+
+	size_t total_slots = budget_bytes / slot_size;
+	if (total_slots == 0) {
+		return 0;  // 비활성화
+	}
+
+	// 슬롯이 적으면 샤드 수를 줄임 (샤드당 최소 1 슬롯)
+	unsigned int shard_count = BLOCK_CACHE_SHARDS;
+	while (shard_count > 1 && total_slots < shard_count) {
+		shard_count >>= 1;
+	}
+
+	cache->shards = (BlockCacheShard *)calloc(shard_count, sizeof(BlockCacheShard));
+	if (cache->shards == NULL) {
+		return -1;
+	}
+	cache->shard_count = shard_count;
+	for (unsigned int i = 0; i < shard_count; i++) {
+		pthread_mutex_init(&cache->shards[i].lock, NULL);
+	}
+
+	for (unsigned int i = 0; i < shard_count; i++) {
+		BlockCacheShard *shard = &cache->shards[i];
+		unsigned int capacity = (unsigned int)(total_slots / shard_count);
+
+		shard->capacity = capacity;
+		shard->bucket_count = 1;
+		while (shard->bucket_count < capacity) {
+			shard->bucket_count <<= 1;
+		}
+
+		shard->buckets = (int *)malloc(shard->bucket_count * sizeof(int));
+		shard->entries = (BlockCacheEntry *)calloc(capacity, sizeof(BlockCacheEntry));
+		shard->data = (unsigned char *)malloc((size_t)capacity * slot_size);
+		if (shard->buckets == NULL || shard->entries == NULL || shard->data == NULL) {
+			block_cache_destroy(cache);
+			return -1;
+		}
+		memset(shard->buckets, -1, shard->bucket_count * sizeof(int));
+	}
+
+	return 0;
+}
+
+/**
+ * 블록 캐시 메모리 해제 함수
+ *
+ * @param cache 해제할 캐시 포인터
+ */
+void	block_cache_destroy(BlockCache *cache)
+{
+	for (unsigned int i = 0; i < cache->shard_count; i++) {
+		BlockCacheShard *shard = &cache->shards[i];
+		pthread_mutex_destroy(&shard->lock);
+		free(shard->buckets);
+		free(shard->entries);
+		free(shard->data);
+	}
+	free(cache->shards);
+	cache->shards = NULL;
+	cache->shard_count = 0;
+}
+
+/**
+ * 캐시의 모든 슬롯을 비우는 함수 (메모리는 유지, 통계는 누적)
+ *
+ * @param cache 캐시 포인터
+ */
+void	block_cache_clear(BlockCache *cache)
+{
+	for (unsigned int i = 0; i < cache->shard_count; i++) {
+		BlockCacheShard *shard = &cache->shards[i];
+
+		pthread_mutex_lock(&shard->lock);
+		memset(shard->buckets, -1, shard->bucket_count * sizeof(int));
+		shard->used = 0;
+		shard->hand = 0;
+		pthread_mutex_unlock(&shard->lock);
+	}
+}
+
+/**
+ * 샤드 내에서 블록 번호에 해당하는 엔트리 인덱스를 찾는 함수 (락을 잡은 상태에서 호출)
+ *
+ * @param shard 샤드 포인터
+ * @param block_num 찾을 블록 번호
+ * @param bucket 블록이 속하는 버킷 인덱스
+ * @return 엔트리 인덱스, 없으면 -1
+ */
+static int	shard_find(BlockCacheShard *shard, unsigned int block_num, unsigned int bucket)
+{
+	int idx = shard->buckets[bucket];
+	while (idx >= 0) {
+		if (shard->entries[idx].block_num == block_num) {
+			return idx;
+		}
+		idx = shard->entries[idx].next;
+	}
+	return -1;
+}
+
+/**
+ * 엔트리를 해시 체인에서 제거하는 함수 (락을 잡은 상태에서 호출)
+ *
+ * @param shard 샤드 포인터
+ * @param idx 제거할 엔트리 인덱스
+ */
+static void	shard_unlink(BlockCacheShard *shard, int idx)
+{
+	unsigned int bucket = (hash_block(shard->entries[idx].block_num) >> 4) & (shard->bucket_count - 1);
+	int *link = &shard->buckets[bucket];
+
+	while (*link >= 0) {
+		if (*link == idx) {
+			*link = shard->entries[idx].next;
+			return;
+		}
+		link = &shard->entries[*link].next;
+	}
+}
+
+/**
+ * 캐시에서 블록을 찾아 슬롯의 [offset, offset + len) 구간을 buffer로 복사하는 함수
+ *
+ * @param cache 캐시 포인터
+ * @param block_num 찾을 블록 번호
+ * @param offset 슬롯 내 복사 시작 위치
+ * @param len 복사할 바이트 수
+ * @param buffer 내용을 복사할 버퍼
+ * @return 캐시 적중 시 true, 아니면 false
+ */
+bool	block_cache_lookup(BlockCache *cache, unsigned int block_num, 
+						   unsigned int offset, unsigned int len, void *buffer)
+{
+	if (cache->shard_count == 0) {
+		return false;
+	}
+
+	unsigned int h = hash_block(block_num);
+	BlockCacheShard *shard = &cache->shards[h & (cache->shard_count - 1)];
+	unsigned int bucket = (h >> 4) & (shard->bucket_count - 1);
+
+	pthread_mutex_lock(&shard->lock);
+	int idx = shard_find(shard, block_num, bucket);
+	if (idx < 0) {
+		shard->misses++;
+		pthread_mutex_unlock(&shard->lock);
+		return false;
+	}
+
+	shard->entries[idx].referenced = 1;
+	memcpy(buffer, shard->data + (size_t)idx * cache->slot_size + offset, len);
+	shard->hits++;
+	pthread_mutex_unlock(&shard->lock);
+	return true;
+}
+
+/**
+ * 블록을 캐시에 넣는 함수
+ * 빈 슬롯이 없으면 CLOCK 방식으로 최근 참조되지 않은 슬롯을 교체
+ *
+ * @param cache 캐시 포인터
+ * @param block_num 블록 번호
+ * @param data 슬롯 크기만큼의 내용
+ */
+void	block_cache_insert(BlockCache *cache, unsigned int block_num, const void *data)
+{
+	if (cache->shard_count == 0) {
+		return;
+	}
+
+	unsigned int h = hash_block(block_num);
+	BlockCacheShard *shard = &cache->shards[h & (cache->shard_count - 1)];
+	unsigned int bucket = (h >> 4) & (shard->bucket_count - 1);
+
+	pthread_mutex_lock(&shard->lock);
+
+	// 다른 호출이 먼저 넣었으면 그대로 둠
+	if (shard_find(shard, block_num, bucket) >= 0) {
+		pthread_mutex_unlock(&shard->lock);
+		return;
+	}
+
+	int idx;
+	if (shard->used < shard->capacity) {
+		// 아직 빈 슬롯이 있음
+		idx = (int)shard->used++;
+	} else {
+		// CLOCK: 참조 비트가 꺼진 슬롯이 나올 때까지 바늘을 돌림
+		while (shard->entries[shard->hand].referenced) {
+			shard->entries[shard->hand].referenced = 0;
+			shard->hand = (shard->hand + 1) % shard->capacity;
+		}
+		idx = (int)shard->hand;
+		shard->hand = (shard->hand + 1) % shard->capacity;
+		shard_unlink(shard, idx);
+		shard->evictions++;
+	}
+
+	BlockCacheEntry *entry = &shard->entries[idx];
+	entry->block_num = block_num;
+	entry->referenced = 0;
+	entry->next = shard->buckets[bucket];
+	shard->buckets[bucket] = idx;
+	memcpy(shard->data + (size_t)idx * cache->slot_size, data, cache->slot_size);
+
+	pthread_mutex_unlock(&shard->lock);
+}
+
+/**
+ * 캐시 적중/실패/교체 횟수를 합산하는 함수
+ *
+ * @param cache 캐시 포인터
+ * @param stats 결과를 저장할 구조체 포인터
+ */
+void	block_cache_get_stats(BlockCache *cache, BlockCacheStats *stats)
+{
+	memset(stats, 0, sizeof(BlockCacheStats));
+
+	for (unsigned int i = 0; i < cache->shard_count; i++) {
+		BlockCacheShard *shard = &cache->shards[i];
+
+		pthread_mutex_lock(&shard->lock);
+		stats->hits += shard->hits;
+		stats->misses += shard->misses;
+		stats->evictions += shard->evictions;
+		stats->cached_blocks += shard->used;
+		stats->capacity_blocks += shard->capacity;
+		pthread_mutex_unlock(&shard->lock);
+	}
+}
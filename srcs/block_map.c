@@ -0,0 +1,430 @@
+#include "ssu_ext2.h"
+
+/*
+ * 추적 구간 이름 (남은 간접 단계 수 - 1로 찾음, 삼중 간접 블록 아래는 이중, 단일 간접 블록 순)
+ */
+static const char	*indirect_names[3] = { "single_indirect_block", "double_indirect_block", "triple_indirect_block" };
+
+/**
+ * 간접 블록을 단계별 버퍼에 읽어 두는 함수 (같은 블록이면 다시 읽지 않음)
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param level 간접 단계 인덱스 (0: 최상위)
+ * @param depth 간접 단계 수 (1: 단일, 2: 이중, 3: 삼중)
+ * @param block_num 읽을 간접 블록 번호
+ * @return 블록 포인터 배열, 실패 시 NULL
+ */
+static const unsigned int	*load_indirect(BlockMapIter *it, int level, int depth, unsigned int block_num)
+{
+	if (it->ind_ptrs[level] != NULL && it->ind_num[level] == block_num) {
+		return it->ind_ptrs[level];
+	}
+
+	unsigned long long trace_start = TRACE_BEGIN();
+	it->ind_ptrs[level] = (const unsigned int *)get_data_block(it->ctx, block_num, it->ind_scratch[level]);
+	it->ind_num[level] = block_num;
+	TRACE_END(indirect_names[depth - level - 1], trace_start, "block", block_num, "level", level + 1);
+	return it->ind_ptrs[level];
+}
+
+/**
+ * 하위 간접 블록들을 미리 읽도록 요청하는 함수
+ * 간접 테이블의 [index, index + BLOCK_MAP_PREFETCH) 구간 포인터 중 연속된 것끼리 묶어서 요청
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param table 간접 블록 포인터 배열
+ * @param index 시작 위치
+ */
+static void	prefetch_children(BlockMapIter *it, const unsigned int *table, unsigned int index)
+{
+	unsigned int ptrs = it->ctx->ptrs_per_block;
+	unsigned int end = index + BLOCK_MAP_PREFETCH < ptrs ? index + BLOCK_MAP_PREFETCH : ptrs;
+	unsigned int run_start = 0;
+	unsigned int run_len = 0;
+
+	for (unsigned int i = index; i < end; i++) {
+		if (table[i] == 0) {
+			continue;
+		}
+		if (run_len > 0 && table[i] == run_start + run_len) {
+			run_len++;
+			continue;
+		}
+		if (run_len > 0) {
+			prefetch_blocks(it->ctx, run_start, run_len);
+		}
+		run_start = table[i];
+		run_len = 1;
+	}
+	if (run_len > 0) {
+		prefetch_blocks(it->ctx, run_start, run_len);
+	}
+}
+
+/**
+ * 논리 블록 번호를 물리 블록 번호로 변환하는 함수
+ * 구멍(hole)이면 같은 간접 블록 아래에서 함께 건너뛸 수 있는 블록 수를 알려줌
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param logical 논리 블록 번호
+ * @param span 구멍일 때 건너뛸 수 있는 논리 블록 수를 저장할 포인터
+ * @return 물리 블록 번호, 구멍이면 0, 간접 블록을 읽지 못하면 BLOCK_MAP_ERROR
+ */
+static unsigned int	map_logical(BlockMapIter *it, unsigned int logical, unsigned int *span)
+{
+	unsigned int ptrs = it->ctx->ptrs_per_block;
+
+	*span = 1;
+
+	// 직접 블록
+	if (logical < EXT2_NDIR_BLOCKS) {
+		return it->i_block[logical];
+	}
+	logical -= EXT2_NDIR_BLOCKS;
+
+	// 간접 단계와 단계 내 위치 계산 (단계별로 다루는 블록 수: ptrs, ptrs^2, ptrs^3)
+	unsigned long long per_entry = 1;
+	int depth;
+	for (depth = 1; depth <= 3; depth++) {
+		unsigned long long covered = per_entry * ptrs;
+		if (logical < covered) {
+			break;
+		}
+		logical -= (unsigned int)covered;
+		per_entry = covered;
+	}
+	if (depth > 3) {
+		*span = UINT32_MAX;
+		return 0;
+	}
+
+	unsigned int block_num = it->i_block[EXT2_IND_BLOCK + depth - 1];
+	unsigned long long remaining = per_entry * ptrs;	// 이 단계 전체에서 남은 범위
+	unsigned long long offset = logical;
+
+	for (int level = 0; level < depth; level++) {
+		if (block_num == 0) {
+			// 이 포인터 아래 전체가 구멍
+			unsigned long long skip = remaining - offset;
+			*span = skip > UINT32_MAX ? UINT32_MAX : (unsigned int)skip;
+			return 0;
+		}
+
+		const unsigned int *table = load_indirect(it, level, depth, block_num);
+		if (table == NULL) {
+			#ifdef DEBUG_PRINT
+				fprintf(stderr, "Failed to read indirect block %u\n", block_num);
+			#endif
+			it->failed = true;
+			return BLOCK_MAP_ERROR;
+		}
+
+		remaining /= ptrs;
+		unsigned int index = (unsigned int)(offset / remaining);
+		offset %= remaining;
+		block_num = table[index];
+
+		// 하위 항목도 간접 블록이면 데이터보다 먼저 미리 읽어 둠
+		if (level < depth - 1 && (it->prefetch_block[level] != it->ind_num[level] || index >= it->prefetch_end[level])) {
+			prefetch_children(it, table, index);
+			it->prefetch_block[level] = it->ind_num[level];
+			it->prefetch_end[level] = index + BLOCK_MAP_PREFETCH;
+		}
+	}
+
+	return block_num;
+}
+
+/**
+ * 논리 블록이 속한 리프 구간의 범위를 구하는 함수
+ * 리프 구간 0은 직접 블록 12개, k(1 이상)는 마지막 단계 간접 블록 하나가 가리키는 ptrs_per_block개의 블록
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param logical 논리 블록 번호
+ * @param start 구간 시작 논리 블록 번호를 저장할 포인터
+ * @param end 구간 끝 논리 블록 번호를 저장할 포인터 (포함하지 않음)
+ * @return 리프 구간 번호
+ */
+static unsigned int	leaf_range(BlockMapIter *it, unsigned int logical, unsigned long long *start, unsigned long long *end)
+{
+	unsigned int ptrs = it->ctx->ptrs_per_block;
+
+	if (logical < EXT2_NDIR_BLOCKS) {
+		*start = 0;
+		*end = EXT2_NDIR_BLOCKS;
+		return 0;
+	}
+	unsigned int index = (logical - EXT2_NDIR_BLOCKS) / ptrs;
+	*start = EXT2_NDIR_BLOCKS + (unsigned long long)index * ptrs;
+	*end = *start + ptrs;
+	return index + 1;
+}
+
+/**
+ * 리프 구간 하나의 익스텐트 목록을 leaf_runs에 올리는 함수
+ * 캐시에 있으면 복사해 오고, 없으면 간접 블록을 따라가며 만든 뒤 캐시에 넣음 (간접 블록을 읽지 못하면 넣지 않음)
+ * 만들 때는 block_map_seek으로 줄어든 끝이 아니라 i_size 기준 끝까지 매핑해서 구간 전체를 캐시함
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param leaf 리프 구간 번호
+ * @param start 구간 시작 논리 블록 번호
+ * @param end 구간 끝 논리 블록 번호 (포함하지 않음)
+ */
+static void	load_leaf(BlockMapIter *it, unsigned int leaf, unsigned long long start, unsigned long long end)
+{
+	ExtentCache *ec = &it->ctx->ecache;
+
+	it->leaf = leaf;
+	it->leaf_loaded = true;
+	it->leaf_hint = 0;
+	if (extent_cache_lookup(ec, it->inode_num, it->generation, leaf, it->leaf_runs, &it->leaf_run_count)) {
+		return;
+	}
+
+	unsigned int count = 0;
+	unsigned int span;
+	if (end > it->size_end) {
+		end = it->size_end;
+	}
+	for (unsigned long long logical = start; logical < end; ) {
+		unsigned int physical = map_logical(it, (unsigned int)logical, &span);
+		if (physical == BLOCK_MAP_ERROR) {
+			break;
+		}
+		if (physical == 0) {
+			logical += span;
+			continue;
+		}
+		BlockExtent *last = count > 0 ? &it->leaf_runs[count - 1] : NULL;
+		if (last != NULL && last->logical + last->length == logical && last->physical + last->length == physical) {
+			last->length++;
+		} else {
+			it->leaf_runs[count].logical = (unsigned int)logical;
+			it->leaf_runs[count].physical = physical;
+			it->leaf_runs[count].length = 1;
+			count++;
+		}
+		logical++;
+	}
+	it->leaf_run_count = count;
+
+	// 간접 블록을 읽지 못한 구간은 구멍처럼 보이므로 캐시하지 않음 (다음 명령어에서 다시 읽어 봄)
+	if (it->failed) {
+		return;
+	}
+	extent_cache_insert(ec, it->inode_num, it->generation, leaf, it->leaf_runs, count);
+}
+
+/**
+ * 논리 블록에서 시작하는 연속 구간을 구하는 함수
+ * 캐시를 쓰지 않으면 map_logical과 같고, 쓰면 리프 구간의 익스텐트 목록에서 찾음
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param logical 논리 블록 번호
+ * @param run 물리적으로 이어지는 블록 수(구멍이면 건너뛸 수 있는 블록 수)를 저장할 포인터
+ * @return 물리 블록 번호, 구멍이면 0, 간접 블록을 읽지 못했으면 BLOCK_MAP_ERROR
+ */
+static unsigned int	map_run(BlockMapIter *it, unsigned int logical, unsigned int *run)
+{
+	if (it->failed) {
+		*run = 1;
+		return BLOCK_MAP_ERROR;
+	}
+	if (it->inode_num == 0) {
+		unsigned int physical = map_logical(it, logical, run);
+		if (physical != 0) {
+			*run = 1;
+		}
+		return physical;
+	}
+
+	unsigned long long start;
+	unsigned long long end;
+	unsigned int leaf = leaf_range(it, logical, &start, &end);
+	if (!it->leaf_loaded || it->leaf != leaf) {
+		load_leaf(it, leaf, start, end);
+		if (it->failed) {
+			*run = 1;
+			return BLOCK_MAP_ERROR;
+		}
+	}
+
+	// 앞쪽으로 읽는 경우가 대부분이므로 마지막 위치부터 찾음
+	unsigned int i = it->leaf_hint;
+	if (i >= it->leaf_run_count || it->leaf_runs[i].logical > logical) {
+		i = 0;
+	}
+	while (i < it->leaf_run_count && it->leaf_runs[i].logical + it->leaf_runs[i].length <= logical) {
+		i++;
+	}
+	it->leaf_hint = i;
+
+	if (i < it->leaf_run_count && it->leaf_runs[i].logical <= logical) {
+		const BlockExtent *found = &it->leaf_runs[i];
+		*run = found->logical + found->length - logical;
+		return found->physical + (logical - found->logical);
+	}
+
+	// 다음 익스텐트(또는 리프 구간 끝)까지 구멍
+	unsigned long long hole_end = i < it->leaf_run_count ? it->leaf_runs[i].logical : end;
+	*run = (unsigned int)(hole_end - logical);
+	return 0;
+}
+
+/**
+ * 블록 맵 반복자 초기화 함수
+ * inode의 i_block을 복사해 두고, 간접 블록 단계별 임시 버퍼를 준비
+ *
+ * @param it 초기화할 반복자 포인터
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param inode 대상 inode 포인터
+ */
+void	block_map_init(BlockMapIter *it, Ext2Context *ctx, const struct my_ext2_inode *inode)
+{
+	memset(it, 0, sizeof(BlockMapIter));
+	it->ctx = ctx;
+	memcpy(it->i_block, inode->i_block, sizeof(it->i_block));
+
+	// i_size를 넘는 블록은 매핑하지 않음
+	it->end = (unsigned int)(((unsigned long long)inode->i_size + ctx->block_size - 1) / ctx->block_size);
+
+	for (int level = 0; level < 3; level++) {
+		it->ind_scratch[level] = alloc_block_scratch(ctx);
+	}
+
+	// 직접 블록 이후까지 이어지는 파일이면 최상위 간접 블록들을 미리 읽어 둠
+	for (int i = 0; i < 3 && it->end > EXT2_NDIR_BLOCKS; i++) {
+		if (it->i_block[EXT2_IND_BLOCK + i] != 0) {
+			prefetch_blocks(ctx, it->i_block[EXT2_IND_BLOCK + i], 1);
+		}
+	}
+	it->size_end = it->end;
+}
+
+/**
+ * 블록 맵 캐시를 쓰는 반복자 초기화 함수 (print처럼 같은 파일을 다시 읽을 수 있는 경우)
+ * 리프 구간 단위로 매핑 결과를 캐시에 남기고, 다음에는 간접 블록을 읽지 않고 캐시에서 가져옴
+ * 캐시가 꺼져 있거나 임시 배열을 할당하지 못하면 block_map_init과 같이 동작
+ *
+ * @param it 초기화할 반복자 포인터
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param inode_num 대상 inode 번호 (캐시 키)
+ * @param inode 대상 inode 포인터
+ */
+void	block_map_init_cached(BlockMapIter *it, Ext2Context *ctx, unsigned int inode_num, 
+							  const struct my_ext2_inode *inode)
+{
+	block_map_init(it, ctx, inode);
+	if (ctx->ecache.buckets == NULL) {
+		return;
+	}
+
+	unsigned int max_runs = ctx->ptrs_per_block > EXT2_NDIR_BLOCKS ? ctx->ptrs_per_block : EXT2_NDIR_BLOCKS;
+	it->leaf_runs = (BlockExtent *)malloc((size_t)max_runs * sizeof(BlockExtent));
+	if (it->leaf_runs == NULL) {
+		return;
+	}
+	it->inode_num = inode_num;
+	it->generation = inode->i_generation;
+}
+
+/**
+ * 블록 맵 반복자 정리 함수
+ *
+ * @param it 정리할 반복자 포인터
+ */
+void	block_map_destroy(BlockMapIter *it)
+{
+	for (int level = 0; level < 3; level++) {
+		free(it->ind_scratch[level]);
+		it->ind_scratch[level] = NULL;
+		it->ind_ptrs[level] = NULL;
+	}
+	free(it->leaf_runs);
+	it->leaf_runs = NULL;
+	it->leaf_loaded = false;
+}
+
+/**
+ * 논리 블록 하나의 물리 블록 번호를 구하는 함수 (반복자의 순차 위치는 바꾸지 않음)
+ * 직접/단일/이중/삼중 간접 중 해당하는 칸을 계산해서 바로 내려가며, 단계별로 마지막에 읽은 간접 블록은 다시 읽지 않음
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param logical 논리 블록 번호
+ * @return 물리 블록 번호, 구멍이거나 i_size 범위를 벗어나면 0, 간접 블록을 읽지 못하면 BLOCK_MAP_ERROR
+ */
+unsigned int	block_map_lookup(BlockMapIter *it, unsigned int logical)
+{
+	unsigned int run;
+
+	if (logical >= it->end) {
+		return 0;
+	}
+	return map_run(it, logical, &run);
+}
+
+/**
+ * 반복자가 [start, end) 논리 블록 구간만 돌도록 위치를 옮기는 함수
+ * 다음 block_map_next는 start 블록의 칸으로 바로 내려가며, 앞쪽 간접 블록들은 읽지 않음
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param start 시작 논리 블록 번호
+ * @param end 끝 논리 블록 번호 (포함하지 않음, i_size 범위로 잘림)
+ */
+void	block_map_seek(BlockMapIter *it, unsigned int start, unsigned int end)
+{
+	if (end < it->end) {
+		it->end = end;
+	}
+	it->next = start < it->end ? start : it->end;
+}
+
+/**
+ * 다음 익스텐트를 구하는 함수
+ * 구멍은 건너뛰고, 물리적으로 이어지는 블록들은 하나의 익스텐트로 합침
+ * 간접 블록을 읽지 못하면 그 앞까지만 돌려주고 멈춤 (false를 돌려준 뒤 it->failed로 구분)
+ *
+ * @param it 블록 맵 반복자 포인터
+ * @param extent 결과 익스텐트를 저장할 포인터
+ * @return 익스텐트가 있으면 true, 파일 끝이거나 실패하면 false
+ */
+bool	block_map_next(BlockMapIter *it, BlockExtent *extent)
+{
+	unsigned int run;
+	unsigned int physical = 0;
+
+	// 구멍 건너뛰기
+	while (it->next < it->end) {
+		physical = map_run(it, it->next, &run);
+		if (physical == BLOCK_MAP_ERROR) {
+			return false;
+		}
+		if (physical != 0) {
+			break;
+		}
+		it->next = (run >= it->end - it->next) ? it->end : it->next + run;
+	}
+	if (it->next >= it->end) {
+		return false;
+	}
+
+	extent->logical = it->next;
+	extent->physical = physical;
+	extent->length = run < it->end - it->next ? run : it->end - it->next;
+	it->next += extent->length;
+
+	// 물리적으로 이어지는 블록 합치기
+	while (it->next < it->end) {
+		unsigned int next_physical = map_run(it, it->next, &run);
+		if (next_physical == 0 || next_physical == BLOCK_MAP_ERROR || next_physical != physical + extent->length) {
+			break;
+		}
+		if (run > it->end - it->next) {
+			run = it->end - it->next;
+		}
+		extent->length += run;
+		it->next += run;
+	}
+
+	return true;
+}
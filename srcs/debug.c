@@ -29,7 +29,10 @@ void	debug_print_cmd(Command cmd)
 	printf("cmd type : %s\n", cmd.cmd_type);
 	printf("cmd path : %s\n", cmd.path);
 	printf("cmd option : \n");
-	printf("  -n : %d\n", cmd.options);
+	printf("  -n : %s\n", cmd.options & PRINT_OPT_N ? "On" : "Off");
+	printf("  -t : %s\n", cmd.options & PRINT_OPT_T ? "On" : "Off");
+	printf("  -o : %s (%llu)\n", cmd.options & PRINT_OPT_O ? "On" : "Off", cmd.range_offset);
+	printf("  -c : %s (%llu)\n", cmd.options & PRINT_OPT_C ? "On" : "Off", cmd.range_length);
 	printf("    value : %d\n", cmd.extra_param);
 }
 
@@ -40,7 +43,7 @@ void	debug_print_cmd(Command cmd)
 *@param block_buf 디렉토리 블록 데이터 버퍼
 *@param block_size 블록 크기
 */
-void	debug_directory_block(unsigned char* block_buf, unsigned int block_size)
+void	debug_directory_block(const unsigned char* block_buf, unsigned int block_size)
 {
 	printf("Full block analysis (showing entire block):\n");
 		
@@ -62,8 +65,8 @@ void	debug_directory_block(unsigned char* block_buf, unsigned int block_size)
 		
 		// 가능한 디렉토리 엔트리 구조 분석
 		if (offset + 8 <= block_size) {  // 최소 8바이트 필요
-			struct my_ext2_dir_entry_2* entry = 
-				(struct my_ext2_dir_entry_2*)(block_buf + offset);
+			const struct my_ext2_dir_entry_2* entry = 
+				(const struct my_ext2_dir_entry_2*)(block_buf + offset);
 			
 			// 유효한 inode 번호인지 확인 (0이 아니고 일반적인 범위 내)
 			if (entry->inode > 0 && entry->inode < 1000 &&
@@ -0,0 +1,174 @@
+#include "ssu_ext2.h"
+
+/**
+ * (부모 inode, 이름) 쌍을 해시하는 함수 (FNV-1a)
+ *
+ * @param parent 부모 디렉토리 inode 번호
+ * @param name 엔트리 이름
+ * @param name_len 이름 길이
+ * @return 해시 값
+ */
+static unsigned int	hash_dentry(unsigned int parent, const char *name, size_t name_len)
+{
+	unsigned int h = 2166136261u ^ parent;
+
+	for (size_t i = 0; i < name_len; i++) {
+		h ^= (unsigned char)name[i];
+		h *= 16777619u;
+	}
+	return h ^ (h >> 15);
+}
+
+/**
+ * 덴트리 캐시 초기화 함수
+ *
+ * @param dc 초기화할 덴트리 캐시 포인터
+ * @param set_count 세트 수 (2의 거듭제곱, 세트당 DENTRY_CACHE_WAYS개 엔트리)
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+int	dentry_cache_init(DentryCache *dc, unsigned int set_count)
+{
+	memset(dc, 0, sizeof(DentryCache));
+
+	dc->entries = (DentryCacheEntry *)calloc((size_t)set_count * DENTRY_CACHE_WAYS,
+											 sizeof(DentryCacheEntry));
+	dc->next_victim = (unsigned char *)calloc(set_count, sizeof(unsigned char));
+	if (dc->entries == NULL || dc->next_victim == NULL) {
+		free(dc->entries);
+		free(dc->next_victim);
+		dc->entries = NULL;
+		return -1;
+	}
+	dc->set_count = set_count;
+	pthread_mutex_init(&dc->lock, NULL);
+	return 0;
+}
+
+/**
+ * 덴트리 캐시 메모리 해제 함수
+ *
+ * @param dc 해제할 덴트리 캐시 포인터
+ */
+void	dentry_cache_destroy(DentryCache *dc)
+{
+	if (dc->entries == NULL) {
+		return;
+	}
+	pthread_mutex_destroy(&dc->lock);
+	free(dc->entries);
+	free(dc->next_victim);
+	dc->entries = NULL;
+	dc->next_victim = NULL;
+	dc->set_count = 0;
+}
+
+/**
+ * 덴트리 캐시의 모든 엔트리를 무효화하는 함수
+ *
+ * @param dc 덴트리 캐시 포인터
+ */
+void	dentry_cache_clear(DentryCache *dc)
+{
+	if (dc->entries == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&dc->lock);
+	memset(dc->entries, 0, (size_t)dc->set_count * DENTRY_CACHE_WAYS * sizeof(DentryCacheEntry));
+	pthread_mutex_unlock(&dc->lock);
+}
+
+/**
+ * 덴트리 캐시에서 (부모 inode, 이름)에 해당하는 자식 inode를 찾는 함수
+ *
+ * @param dc 덴트리 캐시 포인터
+ * @param parent 부모 디렉토리 inode 번호
+ * @param name 찾을 이름
+ * @param child 찾은 자식 inode 번호를 저장할 포인터 (0이면 없는 이름으로 캐시된 것)
+ * @return 캐시 적중 시 true, 아니면 false
+ */
+bool	dentry_cache_lookup(DentryCache *dc, unsigned int parent,
+							const char *name, unsigned int *child)
+{
+	if (dc->entries == NULL) {
+		return false;
+	}
+
+	size_t name_len = strlen(name);
+	if (name_len > MAX_FILE_NAME) {
+		return false;
+	}
+
+	unsigned int h = hash_dentry(parent, name, name_len);
+	DentryCacheEntry *set = &dc->entries[(size_t)(h & (dc->set_count - 1)) * DENTRY_CACHE_WAYS];
+
+	pthread_mutex_lock(&dc->lock);
+	for (int way = 0; way < DENTRY_CACHE_WAYS; way++) {
+		DentryCacheEntry *entry = &set[way];
+		if (entry->valid && entry->hash == h && entry->parent == parent &&
+			entry->name_len == name_len && memcmp(entry->name, name, name_len) == 0) {
+			*child = entry->child;
+			if (entry->child == 0) {
+				dc->negative_hits++;
+			} else {
+				dc->hits++;
+			}
+			pthread_mutex_unlock(&dc->lock);
+			return true;
+		}
+	}
+	dc->misses++;
+	pthread_mutex_unlock(&dc->lock);
+	return false;
+}
+
+/**
+ * 덴트리 캐시에 (부모 inode, 이름) -> 자식 inode를 넣는 함수
+ * 세트가 가득 차 있으면 세트 안에서 돌아가며 교체
+ *
+ * @param dc 덴트리 캐시 포인터
+ * @param parent 부모 디렉토리 inode 번호
+ * @param name 엔트리 이름
+ * @param child 자식 inode 번호 (0이면 없는 이름으로 기록)
+ */
+void	dentry_cache_insert(DentryCache *dc, unsigned int parent,
+							const char *name, unsigned int child)
+{
+	if (dc->entries == NULL) {
+		return;
+	}
+
+	size_t name_len = strlen(name);
+	if (name_len > MAX_FILE_NAME) {
+		return;
+	}
+
+	unsigned int h = hash_dentry(parent, name, name_len);
+	unsigned int set_idx = h & (dc->set_count - 1);
+	DentryCacheEntry *set = &dc->entries[(size_t)set_idx * DENTRY_CACHE_WAYS];
+
+	pthread_mutex_lock(&dc->lock);
+
+	// 빈 엔트리 또는 같은 키의 엔트리를 우선 사용
+	DentryCacheEntry *victim = NULL;
+	for (int way = 0; way < DENTRY_CACHE_WAYS; way++) {
+		DentryCacheEntry *entry = &set[way];
+		if (!entry->valid || (entry->hash == h && entry->parent == parent &&
+			entry->name_len == name_len && memcmp(entry->name, name, name_len) == 0)) {
+			victim = entry;
+			break;
+		}
+	}
+	if (victim == NULL) {
+		victim = &set[dc->next_victim[set_idx] % DENTRY_CACHE_WAYS];
+		dc->next_victim[set_idx]++;
+	}
+
+	victim->valid = 1;
+	victim->hash = h;
+	victim->parent = parent;
+	victim->child = child;
+	victim->name_len = (unsigned char)name_len;
+	memcpy(victim->name, name, name_len);
+
+	pthread_mutex_unlock(&dc->lock);
+}
@@ -0,0 +1,232 @@
+#include "ssu_ext2.h"
+
+/**
+ * 디렉토리의 다음 데이터 블록을 읽는 함수 (읽지 못한 블록은 건너뜀)
+ *
+ * @param ds 디렉토리 스트림 포인터
+ * @return 블록을 읽었으면 true, 디렉토리 끝이면 false
+ */
+static bool	load_next_block(DirStream *ds)
+{
+	while (true) {
+		if (ds->extent_pos >= ds->extent.length) {
+			if (!block_map_next(&ds->it, &ds->extent)) {
+				return false;
+			}
+			ds->extent_pos = 0;
+			#ifdef DEBUG_TREE
+				printf("Extent: logical %u -> physical %u, %u blocks\n",
+				  ds->extent.logical, ds->extent.physical, ds->extent.length);
+			#endif
+		}
+
+		ds->block_num = ds->extent.physical + ds->extent_pos++;
+		ds->offset = 0;
+
+		// 블록 데이터 읽기 (이미지가 매핑되어 있으면 복사 없이 매핑을 직접 참조)
+		ds->block = get_data_block(ds->ctx, ds->block_num, ds->scratch);
+		if (ds->block == NULL) {
+			#ifdef DEBUG_TREE
+				printf("Failed to read block %u\n", ds->block_num);
+			#endif
+			continue;
+		}
+
+		#ifdef DEBUG_TREE
+			printf("Reading directory block %u\n", ds->block_num);
+			debug_directory_block(ds->block, ds->ctx->block_size);
+		#endif
+		return true;
+	}
+}
+
+/**
+ * 현재 블록에서 읽은 inode들을 추적 구간 하나로 기록하는 함수 (블록을 다 읽었거나 스트림을 닫을 때)
+ *
+ * @param ds 디렉토리 스트림 포인터
+ */
+static void	trace_inode_batch(DirStream *ds)
+{
+	if (ds->trace_start != 0) {
+		trace_span("read_inode batch", ds->trace_start, "block", ds->block_num, "inodes", ds->trace_inodes);
+	}
+	ds->trace_start = 0;
+	ds->trace_inodes = 0;
+}
+
+/**
+ * 현재 엔트리 다음 엔트리의 위치를 구하는 함수
+ * rec_len 안에 삭제되지 않은 엔트리가 숨어 있으면 (실제 크기 뒤에 유효한 엔트리가 있으면) 그 위치로 이동
+ *
+ * @param ds 디렉토리 스트림 포인터
+ * @param entry 현재 엔트리
+ * @return 다음 엔트리 오프셋
+ */
+static unsigned int	next_entry_offset(const DirStream *ds, const struct my_ext2_dir_entry_2 *entry)
+{
+	unsigned int block_size = ds->ctx->block_size;
+	unsigned int offset = ds->offset;
+
+	// 디렉토리 엔트리의 실제 필요 크기 계산
+	unsigned int real_size = 8 + entry->name_len;  // 기본 헤더(8바이트) + 이름 길이
+	real_size = (real_size + 3) & ~3;  // 4바이트 정렬
+
+	// 다음 엔트리가 있는지 확인
+	if (entry->rec_len > real_size + 8 && offset + real_size < block_size) {
+		// 실제 크기 이후 위치에서 다음 엔트리 확인
+		const struct my_ext2_dir_entry_2 *next =
+			(const struct my_ext2_dir_entry_2 *)(ds->block + offset + real_size);
+
+		// 다음 위치에 유효한 엔트리가 있는지 확인
+		if (next->inode > 0 && next->inode < ds->ctx->sb.s_inodes_count &&
+			next->rec_len >= 8 && next->rec_len <= block_size - (offset + real_size) &&
+			next->name_len > 0 && next->name_len <= 255) {
+			// 다음 엔트리가 유효하면 실제 크기만큼만 이동
+			#ifdef DEBUG_TREE
+				printf("Found hidden entry after %.*s at offset %u\n",
+				  entry->name_len, entry->name, offset + real_size);
+			#endif
+			return offset + real_size;
+		}
+	}
+
+	// 다음 엔트리가 없거나 rec_len이 적절한 경우 (rec_len이 0이면 블록 끝으로)
+	if (entry->rec_len == 0) {
+		return block_size;
+	}
+	return offset + entry->rec_len;
+}
+
+/**
+ * 디렉토리 스트림을 여는 함수
+ * 디렉토리 엔트리를 블록 단위로 읽으면서 하나씩 꺼낼 수 있도록 준비 (디렉토리 전체를 메모리에 올리지 않음)
+ *
+ * @param ds 초기화할 디렉토리 스트림 포인터
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param dir_inode_num 디렉토리 inode 번호
+ * @return 성공 시 0, 디렉토리 inode를 읽지 못하면 음수 값 반환
+ */
+int	dir_stream_open(DirStream *ds, Ext2Context *ctx, unsigned int dir_inode_num)
+{
+	struct my_ext2_inode dir_inode;
+
+	memset(ds, 0, sizeof(DirStream));
+	ds->ctx = ctx;
+
+	// 디렉토리 inode 읽기
+	if (read_inode(ctx, dir_inode_num, &dir_inode) < 0) {
+		return -1;
+	}
+
+	#ifdef DEBUG_TREE
+		printf("Processing directory inode %u with %u blocks\n", dir_inode_num, dir_inode.i_blocks);
+	#endif
+
+	// 블록 맵 반복자로 직접 블록 및 간접 블록(단일, 이중, 삼중)을 모두 순회
+	block_map_init(&ds->it, ctx, &dir_inode);
+	ds->scratch = alloc_block_scratch(ctx);
+	ds->opened = true;
+	return 0;
+}
+
+/**
+ * 디렉토리 스트림 정리 함수
+ *
+ * @param ds 정리할 디렉토리 스트림 포인터
+ */
+void	dir_stream_close(DirStream *ds)
+{
+	if (__builtin_expect(trace_enabled, 0)) {
+		trace_inode_batch(ds);
+	}
+	if (ds->opened) {
+		block_map_destroy(&ds->it);
+		free(ds->scratch);
+	}
+	ds->scratch = NULL;
+	ds->block = NULL;
+	ds->opened = false;
+}
+
+/**
+ * 디렉토리의 다음 엔트리를 디스크 순서대로 꺼내는 함수
+ * ".", "..", "lost+found"와 inode를 읽지 못한 엔트리는 건너뜀
+ *
+ * @param ds 디렉토리 스트림 포인터
+ * @param out 엔트리 정보를 저장할 포인터
+ * @return 엔트리가 있으면 true, 디렉토리 끝이면 false
+ */
+bool	dir_stream_next(DirStream *ds, DirStreamEntry *out)
+{
+	if (!ds->opened) {
+		return false;
+	}
+
+	unsigned int block_size = ds->ctx->block_size;
+	while (true) {
+		if (ds->block == NULL || ds->offset >= block_size) {
+			if (__builtin_expect(trace_enabled, 0)) {
+				trace_inode_batch(ds);
+			}
+			if (!load_next_block(ds)) {
+				ds->block = NULL;
+				return false;
+			}
+			ds->trace_start = TRACE_BEGIN();
+		}
+
+		const struct my_ext2_dir_entry_2 *entry =
+			(const struct my_ext2_dir_entry_2 *)(ds->block + ds->offset);
+
+		// 엔트리 종료 확인 (블록의 나머지는 건너뜀)
+		if (entry->inode == 0 || ds->offset + 8 > block_size) {
+			ds->block = NULL;
+			continue;
+		}
+
+		// 엔트리 이름 확인
+		if (entry->name_len == 0 || entry->name_len > 255 || ds->offset + 8 + entry->name_len > block_size) {
+			// 유효하지 않은 name_len 값이면 다음 위치로 이동
+			ds->offset += 4;  // 최소 간격으로 이동
+			continue;
+		}
+
+		STAT_ADD(dirents, 1);
+		memset(out->name, 0, sizeof(out->name));
+		strncpy(out->name, entry->name, entry->name_len);
+		out->name[entry->name_len] = '\0';
+		out->name_len = entry->name_len;
+		out->inode_num = entry->inode;
+
+		#ifdef DEBUG_TREE
+			printf("Found entry in block %u at offset %u: name='%s', inode=%u, rec_len=%u, name_len=%u, file_type=%u\n",
+			  ds->block_num, ds->offset, out->name, entry->inode, entry->rec_len, entry->name_len, entry->file_type);
+		#endif
+
+		// 다음 엔트리로 이동
+		ds->offset = next_entry_offset(ds, entry);
+
+		// ".", "..", "lost+found" 제외
+		if (strcmp(out->name, ".") == 0 ||
+			strcmp(out->name, "..") == 0 ||
+			strcmp(out->name, "lost+found") == 0) {
+			continue;
+		}
+
+		// 엔트리의 inode 정보 읽기
+		struct my_ext2_inode entry_inode;
+		if (read_inode(ds->ctx, out->inode_num, &entry_inode) < 0) {
+			continue;
+		}
+		ds->trace_inodes++;
+		out->mode = entry_inode.i_mode;
+		out->size = entry_inode.i_size;
+
+		#ifdef DEBUG_TREE
+			printf("Entry %s is %s, mode: %o, size: %u\n",
+			  out->name, S_ISDIR(out->mode) ? "directory" : "file",
+			  out->mode, out->size);
+		#endif
+		return true;
+	}
+}
@@ -0,0 +1,343 @@
+#include "ssu_ext2.h"
+
+/**
+ * 세그먼트 번호와 세그먼트 내 위치를 구하는 함수
+ * 세그먼트 k는 (1 << (base_shift + k))개의 항목을 가지고, ((1 << k) - 1) << base_shift 번째 항목부터 시작
+ *
+ * @param index 전체 인덱스
+ * @param base_shift 첫 세그먼트 크기의 로그 값
+ * @param offset 세그먼트 내 위치를 저장할 포인터
+ * @return 세그먼트 번호
+ */
+static unsigned int	segment_of(unsigned int index, unsigned int base_shift, unsigned int *offset)
+{
+	unsigned int k = 31 - __builtin_clz((index >> base_shift) + 1);
+	*offset = index - (((1u << k) - 1) << base_shift);
+	return k;
+}
+
+/**
+ * 세그먼트가 할당되어 있는지 확인하고, 없으면 아레나에서 할당하는 함수
+ * 세그먼트 할당만 트리 락으로 보호하고, 할당된 세그먼트는 락 없이 읽음
+ *
+ * @param tree 트리 저장소 포인터
+ * @param slot 세그먼트 포인터 위치
+ * @param bytes 세그먼트 크기
+ * @return 세그먼트 포인터, 실패 시 NULL
+ */
+static void	*ensure_segment(DirTree *tree, void **slot, size_t bytes)
+{
+	void *seg = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+	if (seg != NULL) {
+		return seg;
+	}
+
+	pthread_mutex_lock(&tree->lock);
+	seg = *slot;
+	if (seg == NULL) {
+		seg = arena_alloc(tree->arena, bytes);
+		__atomic_store_n(slot, seg, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&tree->lock);
+	return seg;
+}
+
+/**
+ * 커서에 노드 인덱스 구간을 새로 예약하는 함수
+ * 예약 단위가 첫 세그먼트 크기의 약수이므로 구간이 세그먼트 경계를 넘지 않음
+ *
+ * @param cursor 트리 쓰기 커서 포인터
+ * @return 성공 시 0, 인덱스를 다 썼거나 메모리 부족 시 -1
+ */
+static int	claim_nodes(DirTreeCursor *cursor)
+{
+	DirTree *tree = cursor->tree;
+	unsigned long start = __atomic_fetch_add(&tree->node_count, TREE_NODE_CLAIM, __ATOMIC_RELAXED);
+	unsigned long limit = ((1UL << TREE_NODE_SEGS) - 1) << TREE_NODE_BASE_SHIFT;
+	if (start + TREE_NODE_CLAIM > limit) {
+		return -1;
+	}
+
+	unsigned int offset;
+	unsigned int k = segment_of((unsigned int)start, TREE_NODE_BASE_SHIFT, &offset);
+	size_t bytes = ((size_t)1 << (TREE_NODE_BASE_SHIFT + k)) * sizeof(DirTreeNode);
+	if (ensure_segment(tree, (void **)&tree->node_segs[k], bytes) == NULL) {
+		return -1;
+	}
+
+	cursor->node_next = (unsigned int)start;
+	cursor->node_end = (unsigned int)start + TREE_NODE_CLAIM;
+	return 0;
+}
+
+/**
+ * 커서에 이름 풀 구간을 새로 예약하는 함수 (남은 구간은 버림)
+ *
+ * @param cursor 트리 쓰기 커서 포인터
+ * @return 성공 시 0, 이름 풀을 다 썼거나 메모리 부족 시 -1
+ */
+static int	claim_names(DirTreeCursor *cursor)
+{
+	DirTree *tree = cursor->tree;
+	unsigned long start = __atomic_fetch_add(&tree->name_bytes, TREE_NAME_CLAIM, __ATOMIC_RELAXED);
+	unsigned long limit = ((1UL << TREE_NAME_SEGS) - 1) << TREE_NAME_BASE_SHIFT;
+	if (start + TREE_NAME_CLAIM > limit) {
+		return -1;
+	}
+
+	unsigned int offset;
+	unsigned int k = segment_of((unsigned int)start, TREE_NAME_BASE_SHIFT, &offset);
+	size_t bytes = (size_t)1 << (TREE_NAME_BASE_SHIFT + k);
+	if (ensure_segment(tree, (void **)&tree->name_segs[k], bytes) == NULL) {
+		return -1;
+	}
+
+	cursor->name_next = (unsigned int)start;
+	cursor->name_end = (unsigned int)start + TREE_NAME_CLAIM;
+	return 0;
+}
+
+/**
+ * 연속된 노드 인덱스 count개를 예약하는 함수
+ * 작은 요청은 커서의 예약 구간에서 떼어 주고, 예약 단위보다 큰 디렉토리는 전역 카운터에서 바로 예약
+ * (큰 예약도 예약 단위의 배수로 올려서 이후 예약 구간이 세그먼트 경계를 넘지 않게 함)
+ *
+ * @param cursor 트리 쓰기 커서 포인터
+ * @param count 예약할 노드 수 (1 이상)
+ * @return 첫 번째 노드 인덱스, 실패 시 TREE_NIL
+ */
+static unsigned int	reserve_nodes(DirTreeCursor *cursor, unsigned int count)
+{
+	if (count <= cursor->node_end - cursor->node_next) {
+		unsigned int start = cursor->node_next;
+		cursor->node_next += count;
+		return start;
+	}
+	if (count <= TREE_NODE_CLAIM) {
+		if (claim_nodes(cursor) < 0) {
+			return TREE_NIL;
+		}
+		unsigned int start = cursor->node_next;
+		cursor->node_next += count;
+		return start;
+	}
+
+	DirTree *tree = cursor->tree;
+	unsigned long rounded = ((unsigned long)count + TREE_NODE_CLAIM - 1) & ~(unsigned long)(TREE_NODE_CLAIM - 1);
+	unsigned long start = __atomic_fetch_add(&tree->node_count, rounded, __ATOMIC_RELAXED);
+	unsigned long limit = ((1UL << TREE_NODE_SEGS) - 1) << TREE_NODE_BASE_SHIFT;
+	if (start + rounded > limit) {
+		return TREE_NIL;
+	}
+
+	// 구간이 걸치는 세그먼트를 모두 준비
+	unsigned int offset;
+	unsigned int first = segment_of((unsigned int)start, TREE_NODE_BASE_SHIFT, &offset);
+	unsigned int last = segment_of((unsigned int)(start + count - 1), TREE_NODE_BASE_SHIFT, &offset);
+	for (unsigned int k = first; k <= last; k++) {
+		size_t bytes = ((size_t)1 << (TREE_NODE_BASE_SHIFT + k)) * sizeof(DirTreeNode);
+		if (ensure_segment(tree, (void **)&tree->node_segs[k], bytes) == NULL) {
+			return TREE_NIL;
+		}
+	}
+	return (unsigned int)start;
+}
+
+/**
+ * 노드 배열을 예약한 인덱스 구간에 복사하는 함수 (세그먼트 경계에서 나눠서 복사)
+ *
+ * @param tree 트리 저장소 포인터
+ * @param start 첫 번째 노드 인덱스
+ * @param nodes 복사할 노드 배열
+ * @param count 노드 수
+ */
+static void	store_nodes(DirTree *tree, unsigned int start, const DirTreeNode *nodes, unsigned int count)
+{
+	while (count > 0) {
+		unsigned int offset;
+		unsigned int k = segment_of(start, TREE_NODE_BASE_SHIFT, &offset);
+		unsigned int room = (1u << (TREE_NODE_BASE_SHIFT + k)) - offset;
+		unsigned int n = count < room ? count : room;
+
+		memcpy(&tree->node_segs[k][offset], nodes, n * sizeof(DirTreeNode));
+		start += n;
+		nodes += n;
+		count -= n;
+	}
+}
+
+/**
+ * 트리 저장소 초기화 함수 (세그먼트는 처음 쓰일 때 할당)
+ *
+ * @param tree 초기화할 트리 저장소 포인터
+ * @param arena 세그먼트를 할당할 아레나 포인터
+ * @return 성공 시 0
+ */
+int	dir_tree_init(DirTree *tree, Arena *arena)
+{
+	memset(tree, 0, sizeof(DirTree));
+	tree->arena = arena;
+	pthread_mutex_init(&tree->lock, NULL);
+	return 0;
+}
+
+/**
+ * 트리 저장소 정리 함수 (세그먼트 메모리는 아레나가 해제)
+ *
+ * @param tree 정리할 트리 저장소 포인터
+ */
+void	dir_tree_destroy(DirTree *tree)
+{
+	pthread_mutex_destroy(&tree->lock);
+}
+
+/**
+ * 트리 쓰기 커서 초기화 함수
+ *
+ * @param cursor 초기화할 커서 포인터
+ * @param tree 노드를 만들 트리 저장소 포인터
+ */
+void	dir_tree_cursor_init(DirTreeCursor *cursor, DirTree *tree)
+{
+	memset(cursor, 0, sizeof(DirTreeCursor));
+	cursor->tree = tree;
+}
+
+/**
+ * 트리 쓰기 커서 정리 함수 (임시 자식 배열 해제)
+ *
+ * @param cursor 정리할 커서 포인터
+ */
+void	dir_tree_cursor_destroy(DirTreeCursor *cursor)
+{
+	free(cursor->stage);
+	cursor->stage = NULL;
+	cursor->stage_count = 0;
+	cursor->stage_capacity = 0;
+}
+
+/**
+ * 디렉토리 하나를 읽는 동안 자식 노드를 임시 배열에 모으는 함수 (이름은 바로 이름 풀에 넣음)
+ * 디렉토리를 다 읽으면 dir_tree_commit으로 연속된 인덱스 구간에 한 번에 옮김
+ *
+ * @param cursor 트리 쓰기 커서 포인터
+ * @param name 이름 (NUL 종료 필요 없음)
+ * @param name_len 이름 길이 (TREE_NAME_CLAIM 미만)
+ * @param inode_num inode 번호
+ * @param mode i_mode
+ * @param size 파일 크기
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	dir_tree_stage(DirTreeCursor *cursor, const char *name, unsigned int name_len,
+				   unsigned int inode_num, unsigned int mode, unsigned int size)
+{
+	if (name_len >= TREE_NAME_CLAIM) {
+		return -1;
+	}
+	if (cursor->name_end - cursor->name_next < name_len && claim_names(cursor) < 0) {
+		return -1;
+	}
+	if (cursor->stage_count == cursor->stage_capacity) {
+		unsigned int capacity = cursor->stage_capacity ? cursor->stage_capacity * 2 : 64;
+		DirTreeNode *stage = (DirTreeNode *)realloc(cursor->stage, capacity * sizeof(DirTreeNode));
+		if (stage == NULL) {
+			return -1;
+		}
+		cursor->stage = stage;
+		cursor->stage_capacity = capacity;
+	}
+
+	DirTreeNode *node = &cursor->stage[cursor->stage_count++];
+	node->inode_num = inode_num;
+	node->size = size;
+	node->mode = (unsigned short)mode;
+	node->name_len = (unsigned short)name_len;
+	node->name_off = cursor->name_next;
+	node->first_child = TREE_NIL;
+	node->child_count = 0;
+
+	if (name_len > 0) {
+		memcpy((char *)dir_tree_name(cursor->tree, node), name, name_len);
+		cursor->name_next += name_len;
+	}
+	return 0;
+}
+
+/**
+ * 모아 둔 자식 노드들을 연속된 인덱스 구간에 옮기고 부모에 연결하는 함수
+ *
+ * @param cursor 트리 쓰기 커서 포인터
+ * @param parent 부모 노드 인덱스 (TREE_NIL이면 연결하지 않음)
+ * @return 첫 번째 자식 인덱스, 자식이 없거나 실패 시 TREE_NIL
+ */
+unsigned int	dir_tree_commit(DirTreeCursor *cursor, unsigned int parent)
+{
+	unsigned int count = cursor->stage_count;
+	cursor->stage_count = 0;
+	if (count == 0) {
+		return TREE_NIL;
+	}
+
+	unsigned int start = reserve_nodes(cursor, count);
+	if (start == TREE_NIL) {
+		return TREE_NIL;
+	}
+	store_nodes(cursor->tree, start, cursor->stage, count);
+	__atomic_add_fetch(&cursor->tree->live_nodes, count, __ATOMIC_RELAXED);
+	STAT_ADD(nodes, count);
+
+	if (parent != TREE_NIL) {
+		DirTreeNode *parent_node = dir_tree_node(cursor->tree, parent);
+		parent_node->first_child = start;
+		parent_node->child_count = count;
+	}
+	return start;
+}
+
+/**
+ * 부모 없는 노드를 하나 만드는 함수 (트리의 루트)
+ *
+ * @param cursor 트리 쓰기 커서 포인터 (모아 둔 자식이 없어야 함)
+ * @param name 이름 (NUL 종료 필요 없음)
+ * @param name_len 이름 길이 (TREE_NAME_CLAIM 미만)
+ * @param inode_num inode 번호
+ * @param mode i_mode
+ * @param size 파일 크기
+ * @return 만든 노드 인덱스, 실패 시 TREE_NIL
+ */
+unsigned int	dir_tree_add(DirTreeCursor *cursor, const char *name, unsigned int name_len,
+						 unsigned int inode_num, unsigned int mode, unsigned int size)
+{
+	if (dir_tree_stage(cursor, name, name_len, inode_num, mode, size) < 0) {
+		return TREE_NIL;
+	}
+	return dir_tree_commit(cursor, TREE_NIL);
+}
+
+/**
+ * 노드 인덱스로 노드 포인터를 구하는 함수
+ *
+ * @param tree 트리 저장소 포인터
+ * @param index 노드 인덱스
+ * @return 노드 포인터
+ */
+DirTreeNode	*dir_tree_node(const DirTree *tree, unsigned int index)
+{
+	unsigned int offset;
+	unsigned int k = segment_of(index, TREE_NODE_BASE_SHIFT, &offset);
+	return &tree->node_segs[k][offset];
+}
+
+/**
+ * 노드 이름의 시작 위치를 구하는 함수 (길이는 node->name_len, NUL 종료되지 않음)
+ *
+ * @param tree 트리 저장소 포인터
+ * @param node 노드 포인터
+ * @return 이름 풀 내부 포인터
+ */
+const char	*dir_tree_name(const DirTree *tree, const DirTreeNode *node)
+{
+	unsigned int offset;
+	unsigned int k = segment_of(node->name_off, TREE_NAME_BASE_SHIFT, &offset);
+	return tree->name_segs[k] + offset;
+}
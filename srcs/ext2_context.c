@@ -0,0 +1,204 @@
+#include "ssu_ext2.h"
+
+/**
+ * 블록 그룹 디스크립터 테이블을 읽는 함수
+ * 읽기에 성공했을 때만 컨텍스트의 슈퍼블록, 그룹 개수, 디스크립터 테이블을 함께 바꿈
+ *
+ * @param ctx 이미지 컨텍스트 포인터 (block_size가 채워져 있어야 함)
+ * @param sb 그룹 디스크립터 테이블을 읽을 기준 슈퍼블록
+ * @return 성공 시 0, 실패 시 음수 값 반환 (컨텍스트는 그대로)
+ */
+static int	load_group_desc(Ext2Context *ctx, const struct my_ext2_super_block *sb)
+{
+	// 블록 그룹 개수 계산 (첫 번째 데이터 블록 이전은 그룹에 속하지 않음)
+	unsigned int group_count = (sb->s_blocks_count - sb->s_first_data_block + sb->s_blocks_per_group - 1)
+								/ sb->s_blocks_per_group;
+
+	size_t gdt_size = (size_t)group_count * sizeof(struct my_ext2_group_desc);
+	struct my_ext2_group_desc *gd = (struct my_ext2_group_desc *)malloc(gdt_size);
+	if (gd == NULL) {
+		return -1;
+	}
+
+	// 블록 그룹 디스크립터 테이블 위치 (슈퍼블록 바로 다음 블록)
+	off_t gdt_offset = (off_t)(sb->s_first_data_block + 1) * ctx->block_size;
+	ssize_t bytes_read = pread(ctx->fd, gd, gdt_size, gdt_offset);
+	STAT_ADD(syscalls, 1);
+	STAT_ADD(bytes_read, bytes_read > 0 ? (size_t)bytes_read : 0);
+	if (bytes_read != (ssize_t)gdt_size) {
+		#ifdef DEBUG_FUNC
+			fprintf(stderr, "read failed in load_group_desc");
+		#endif
+		free(gd);
+		return -2;
+	}
+
+	free(ctx->gd);
+	ctx->gd = gd;
+	ctx->group_count = group_count;
+	ctx->sb = *sb;
+	return 0;
+}
+
+/**
+ * 이미지 세션 컨텍스트를 여는 함수
+ * 슈퍼블록과 그룹 디스크립터 테이블을 한 번만 읽고, 이후 모든 명령어가 재사용
+ *
+ * @param path EXT2 이미지 파일 경로
+ * @param config 실행 옵션
+ * @param ctx 초기화할 컨텍스트 포인터
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+int	open_ext2_context(const char *path, const Ext2Config *config, Ext2Context *ctx)
+{
+	memset(ctx, 0, sizeof(Ext2Context));
+	ctx->config = *config;
+	ctx->uring.fd = -1;
+
+	if ((ctx->fd = open(path, O_RDONLY)) < 0) {
+		return -1;
+	}
+
+	if (read_super_block(ctx->fd, &ctx->sb) < 0) {
+		close_ext2_context(ctx);
+		return -2;
+	}
+
+	// 슈퍼블록으로부터 유도되는 상수 계산
+	ctx->block_size = get_block_size(&ctx->sb);
+	ctx->inode_size = 128;
+	if (ctx->sb.s_rev_level > 0 && ctx->sb.s_inode_size > 0) {
+		ctx->inode_size = ctx->sb.s_inode_size;
+	}
+	ctx->ptrs_per_block = ctx->block_size / sizeof(__u32);
+	ctx->inodes_per_block = ctx->block_size / ctx->inode_size;
+
+	if (load_group_desc(ctx, &ctx->sb) < 0) {
+		close_ext2_context(ctx);
+		return -3;
+	}
+
+	// 이미지 전체를 읽기 전용으로 매핑 (실패하면 pread 경로로 동작, io_uring을 쓰면 매핑하지 않음)
+	struct stat st;
+	if (config->use_mmap && !config->use_io_uring && fstat(ctx->fd, &st) == 0 && st.st_size > 0) {
+		void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, ctx->fd, 0);
+		if (map != MAP_FAILED) {
+			ctx->map = (const unsigned char *)map;
+			ctx->map_size = (size_t)st.st_size;
+		}
+	}
+
+	// pread 경로에서만 블록 캐시 사용 (매핑은 페이지 캐시를 직접 참조하므로 불필요)
+	if (ctx->map == NULL && block_cache_init(&ctx->cache, ctx->block_size, config->cache_bytes) < 0) {
+		close_ext2_context(ctx);
+		return -4;
+	}
+
+	// inode 테이블 캐시는 inode 테이블 블록 하나를 디코딩한 결과를 슬롯 하나로 보관
+	unsigned int inode_slot_size = ctx->inodes_per_block * sizeof(struct my_ext2_inode);
+	if (ctx->map == NULL && block_cache_init(&ctx->inode_cache, inode_slot_size, config->inode_cache_bytes) < 0) {
+		close_ext2_context(ctx);
+		return -5;
+	}
+
+	if (dentry_cache_init(&ctx->dcache, DENTRY_CACHE_SETS) < 0) {
+		close_ext2_context(ctx);
+		return -6;
+	}
+
+	if (extent_cache_init(&ctx->ecache, config->extent_cache_bytes) < 0) {
+		close_ext2_context(ctx);
+		return -7;
+	}
+
+	// 출력 버퍼를 만들 수 없으면 출력마다 바로 write
+	if (out_buf_init(&ctx->out, STDOUT_FILENO, OUT_BUF_BYTES) < 0) {
+		#ifdef DEBUG_FUNC
+			fprintf(stderr, "output buffer unavailable, writing unbuffered\n");
+		#endif
+	}
+
+	// io_uring을 만들 수 없으면 (커널 미지원, 권한 제한 등) 동기 pread 경로로 동작
+	if (ctx->map == NULL && config->use_io_uring && uring_init(&ctx->uring, config->queue_depth) < 0) {
+		#ifdef DEBUG_FUNC
+			fprintf(stderr, "io_uring unavailable, falling back to pread\n");
+		#endif
+	}
+
+	return 0;
+}
+
+/**
+ * 슈퍼블록의 마지막 기록 시각(s_wtime)을 다시 확인하는 함수
+ * 이미지가 그 사이에 수정되었으면 모든 캐시를 비우고 그룹 디스크립터를 다시 읽음
+ * 다시 읽지 못하면 이전 슈퍼블록을 유지하므로 다음 확인에서 다시 시도
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ * @return 변경 없음 0, 캐시를 비웠으면 1, 실패 시 음수 값 반환
+ */
+int	refresh_ext2_context(Ext2Context *ctx)
+{
+	struct my_ext2_super_block sb;
+
+	if (ctx->map != NULL && ctx->map_size >= 1024 + sizeof(sb)) {
+		memcpy(&sb, ctx->map + 1024, sizeof(sb));
+	} else if (read_super_block(ctx->fd, &sb) < 0) {
+		return -1;
+	}
+
+	if (sb.s_wtime == ctx->sb.s_wtime) {
+		return 0;
+	}
+
+	#ifdef DEBUG_CACHE
+		fprintf(stderr, "s_wtime changed (%u -> %u), invalidating caches\n",
+				ctx->sb.s_wtime, sb.s_wtime);
+	#endif
+	block_cache_clear(&ctx->cache);
+	block_cache_clear(&ctx->inode_cache);
+	dentry_cache_clear(&ctx->dcache);
+	extent_cache_clear(&ctx->ecache);
+	if (load_group_desc(ctx, &sb) < 0) {
+		return -2;
+	}
+	return 1;
+}
+
+/**
+ * 이미지 세션 컨텍스트를 닫는 함수
+ *
+ * @param ctx 정리할 컨텍스트 포인터
+ */
+void	close_ext2_context(Ext2Context *ctx)
+{
+	#ifdef DEBUG_CACHE
+		BlockCacheStats stats;
+		block_cache_get_stats(&ctx->cache, &stats);
+		fprintf(stderr, "block cache: %lu hits, %lu misses, %lu evictions, %lu/%lu blocks\n",
+				stats.hits, stats.misses, stats.evictions, stats.cached_blocks, stats.capacity_blocks);
+		block_cache_get_stats(&ctx->inode_cache, &stats);
+		fprintf(stderr, "inode cache: %lu hits, %lu misses, %lu evictions, %lu/%lu table blocks\n",
+				stats.hits, stats.misses, stats.evictions, stats.cached_blocks, stats.capacity_blocks);
+		fprintf(stderr, "dentry cache: %lu hits, %lu negative hits, %lu misses\n",
+				ctx->dcache.hits, ctx->dcache.negative_hits, ctx->dcache.misses);
+		fprintf(stderr, "extent cache: %lu hits, %lu misses, %lu evictions, %lu entries (%zu/%zu bytes)\n",
+				ctx->ecache.hits, ctx->ecache.misses, ctx->ecache.evictions, ctx->ecache.entries,
+				ctx->ecache.bytes, ctx->ecache.budget);
+	#endif
+	block_cache_destroy(&ctx->cache);
+	block_cache_destroy(&ctx->inode_cache);
+	dentry_cache_destroy(&ctx->dcache);
+	extent_cache_destroy(&ctx->ecache);
+	uring_destroy(&ctx->uring);
+	out_buf_destroy(&ctx->out);
+	if (ctx->map != NULL) {
+		munmap((void *)ctx->map, ctx->map_size);
+		ctx->map = NULL;
+	}
+	if (ctx->fd >= 0) {
+		close(ctx->fd);
+	}
+	free(ctx->gd);
+	ctx->gd = NULL;
+	ctx->fd = -1;
+}
@@ -2,17 +2,13 @@
 
 
 /**
- * 경로 분석하여 inode 번호 찾기
+ * 경로 분석하여 inode 번호 찾기 (path_to_inode의 본체)
  * 
- * @param fd 파일 디스크립터
- * @param sb 슈퍼블록 포인터
- * @param gd 그룹 디스크립터 배열 포인터
+ * @param ctx 이미지 컨텍스트 포인터
  * @param path 검색할 경로
  * @return 경로에 해당하는 inode 번호, 없으면 0 반환
  */
-unsigned int	path_to_inode(int fd, struct my_ext2_super_block *sb, 
-						  struct my_ext2_group_desc *gd, 
-						  const char *path)
+static unsigned int	resolve_path(Ext2Context *ctx, const char *path)
 {
 	if (path == NULL || path[0] == '\0') {
 		return 0;
@@ -36,13 +32,23 @@ unsigned int	path_to_inode(int fd, struct my_ext2_super_block *sb,
 	strncpy(path_copy, path, MAX_PATH - 1);
 	path_copy[MAX_PATH - 1] = '\0';
 		
-	// 경로 구성 요소별로 처리
+	// 경로 구성 요소별로 처리 (덴트리 캐시에 있으면 디스크를 읽지 않음)
 	char *token = strtok(path_copy, "/");
 	while (token) {
 		struct my_ext2_inode inode;
+		unsigned int child;
+
+		if (dentry_cache_lookup(&ctx->dcache, current_inode, token, &child)) {
+			if (child == 0) {
+				return 0;  // 없는 이름으로 캐시됨
+			}
+			current_inode = child;
+			token = strtok(NULL, "/");
+			continue;
+		}
 		
 		// 현재 inode 정보 읽기
-		if (read_inode(fd, current_inode, sb, gd, &inode) < 0) {
+		if (read_inode(ctx, current_inode, &inode) < 0) {
 			return 0;
 		}
 		
@@ -51,8 +57,17 @@ unsigned int	path_to_inode(int fd, struct my_ext2_super_block *sb,
 			return 0;
 		}
 		
-		// 현재 디렉토리에서 다음 경로 요소 찾기
-		current_inode = find_entry_in_dir(fd, sb, &inode, token);
+		// 현재 디렉토리에서 다음 경로 요소 찾기 (없는 경우도 캐시)
+		// 읽기 오류는 다음 명령어에서 다시 찾도록 캐시하지 않음 (끝까지 읽고 없을 때만 없는 이름으로 캐시)
+		child = find_entry_in_dir(ctx, &inode, token);
+		if (child == ENTRY_LOOKUP_ERROR) {
+			#ifdef DEBUG_FUNC
+				fprintf(stderr, "failed to read directory inode %u in resolve_path", current_inode);
+			#endif
+			return 0;
+		}
+		dentry_cache_insert(&ctx->dcache, current_inode, token, child);
+		current_inode = child;
 		if (current_inode == 0) {
 			return 0;  // 찾지 못함
 		}
@@ -62,3 +77,18 @@ unsigned int	path_to_inode(int fd, struct my_ext2_super_block *sb,
 		
 	return current_inode;
 }
+
+/**
+ * 경로 분석하여 inode 번호 찾기 (걸린 시간은 실행 통계의 경로 탐색 단계에 더함)
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param path 검색할 경로
+ * @return 경로에 해당하는 inode 번호, 없으면 0 반환
+ */
+unsigned int	path_to_inode(Ext2Context *ctx, const char *path)
+{
+	unsigned long long start = stats_now();
+	unsigned int inode_num = resolve_path(ctx, path);
+	stats_phase_add(STAT_PHASE_PATH, start);
+	return inode_num;
+}
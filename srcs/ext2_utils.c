@@ -9,16 +9,10 @@
  */
 int	read_super_block(int fd, struct my_ext2_super_block *sb)
 {
-	// 슈퍼블록 위치(1024 바이트)로 이동
-	if (lseek(fd, 1024, SEEK_SET) != 1024) {
-		#ifdef DEBUG_FUNC
-			fprintf(stderr, "lseek failed");
-		#endif
-		return -1;
-	}
-		
-	// 슈퍼블록 읽기
-	ssize_t bytes_read = read(fd, sb, sizeof(struct my_ext2_super_block));
+	// 슈퍼블록 읽기 (위치 1024 바이트, 파일 오프셋을 공유하지 않도록 pread 사용)
+	ssize_t bytes_read = pread(fd, sb, sizeof(struct my_ext2_super_block), 1024);
+	STAT_ADD(syscalls, 1);
+	STAT_ADD(bytes_read, sizeof(struct my_ext2_super_block));
 	if (bytes_read != sizeof(struct my_ext2_super_block)) {
 		#ifdef DEBUG_FUNC
 			fprintf(stderr, "read failed");
@@ -49,26 +43,38 @@ unsigned int	get_block_size(struct my_ext2_super_block *sb)
 /**
  * 데이터 블록을 읽는 함수
  * 
- * @param fd 파일 디스크립터
- * @param sb 슈퍼블록 포인터
+ * @param ctx 이미지 컨텍스트 포인터
  * @param block_num 읽을 블록 번호
  * @param buffer 읽은 데이터를 저장할 버퍼
  * @return 성공 시 0, 실패 시 음수 값
  */
-int	read_data_block(int fd, struct my_ext2_super_block *sb, 
+int	read_data_block(Ext2Context *ctx, 
 					unsigned int block_num, unsigned char *buffer)
 {
-	unsigned int block_size = get_block_size(sb);
+	unsigned int block_size = ctx->block_size;
 	off_t offset = (off_t)block_num * block_size;
 		
-	if (lseek(fd, offset, SEEK_SET) != offset) {
-		#ifdef DEBUG_FUNC
-			fprintf(stderr, "lseek failed in read_data_block");
-		#endif
-		return -1;
+	// 매핑된 이미지에서는 시스템 콜 없이 복사
+	if (ctx->map != NULL) {
+		if ((size_t)offset + block_size > ctx->map_size) {
+			#ifdef DEBUG_FUNC
+				fprintf(stderr, "block out of image in read_data_block");
+			#endif
+			return -1;
+		}
+		memcpy(buffer, ctx->map + offset, block_size);
+		STAT_ADD(blocks_read, 1);
+		STAT_ADD(bytes_read, block_size);
+		return 0;
+	}
+		
+	// 블록 캐시에 있으면 시스템 콜 없이 복사
+	if (block_cache_lookup(&ctx->cache, block_num, 0, block_size, buffer)) {
+		return 0;
 	}
 		
-	ssize_t bytes_read = read(fd, buffer, block_size);
+	ssize_t bytes_read = pread(ctx->fd, buffer, block_size, offset);
+	STAT_ADD(syscalls, 1);
 	if (bytes_read != block_size) {
 		#ifdef DEBUG_FUNC
 			fprintf(stderr, "read failed in read_data_block");
@@ -76,143 +82,308 @@ int	read_data_block(int fd, struct my_ext2_super_block *sb,
 		return -2;
 	}
 		
+	STAT_ADD(blocks_read, 1);
+	STAT_ADD(bytes_read, block_size);
+	block_cache_insert(&ctx->cache, block_num, buffer);
+	return 0;
+}
+
+/**
+ * 데이터 블록 내용을 가리키는 포인터를 얻는 함수
+ * 이미지가 매핑되어 있으면 복사 없이 매핑 내부를 가리키고, 아니면 scratch에 읽어서 반환
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param block_num 읽을 블록 번호
+ * @param scratch 매핑이 없을 때 사용할 블록 크기 버퍼 (alloc_block_scratch로 할당)
+ * @return 블록 데이터 포인터, 실패 시 NULL
+ */
+const unsigned char	*get_data_block(Ext2Context *ctx, 
+								unsigned int block_num, unsigned char *scratch)
+{
+	if (ctx->map != NULL) {
+		off_t offset = (off_t)block_num * ctx->block_size;
+		if ((size_t)offset + ctx->block_size > ctx->map_size) {
+			return NULL;
+		}
+		STAT_ADD(blocks_read, 1);
+		STAT_ADD(bytes_read, ctx->block_size);
+		return ctx->map + offset;
+	}
+		
+	if (scratch == NULL || read_data_block(ctx, block_num, scratch) < 0) {
+		return NULL;
+	}
+	return scratch;
+}
+
+/**
+ * get_data_block에 넘길 scratch 버퍼를 할당하는 함수
+ * 매핑된 이미지에서는 복사가 필요 없으므로 NULL 반환
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @return 블록 크기 버퍼 또는 NULL (free 가능)
+ */
+unsigned char	*alloc_block_scratch(Ext2Context *ctx)
+{
+	if (ctx->map != NULL) {
+		return NULL;
+	}
+	return (unsigned char *)malloc(ctx->block_size);
+}
+
+/**
+ * 곧 읽을 블록들을 커널에 미리 읽도록 알리는 함수 (결과를 기다리지 않음)
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param block_num 시작 블록 번호
+ * @param count 연속 블록 수
+ */
+void	prefetch_blocks(Ext2Context *ctx, unsigned int block_num, unsigned int count)
+{
+	off_t offset = (off_t)block_num * ctx->block_size;
+	size_t len = (size_t)count * ctx->block_size;
+		
+	if (ctx->map != NULL) {
+		// madvise는 페이지 경계에 맞춘 주소가 필요
+		size_t page = (size_t)sysconf(_SC_PAGESIZE);
+		size_t start = (size_t)offset & ~(page - 1);
+		if ((size_t)offset >= ctx->map_size) {
+			return;
+		}
+		if ((size_t)offset + len > ctx->map_size) {
+			len = ctx->map_size - (size_t)offset;
+		}
+		madvise((void *)(ctx->map + start), len + ((size_t)offset - start), MADV_WILLNEED);
+		STAT_ADD(syscalls, 1);
+		return;
+	}
+		
+	posix_fadvise(ctx->fd, offset, (off_t)len, POSIX_FADV_WILLNEED);
+	STAT_ADD(syscalls, 1);
+}
+
+/**
+ * inode 테이블 블록 하나를 읽어 모든 inode를 디코딩하고 inode 테이블 캐시에 넣는 함수
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param table_block 읽을 inode 테이블 블록 번호
+ * @param slot 요청한 inode의 블록 내 순번
+ * @param inode 요청한 inode 정보를 저장할 구조체 포인터
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+static int	load_inode_table_block(Ext2Context *ctx, unsigned int table_block, 
+								   unsigned int slot, struct my_ext2_inode *inode)
+{
+	unsigned int count = ctx->inodes_per_block;
+	unsigned char *raw = (unsigned char *)malloc(ctx->block_size);
+	struct my_ext2_inode *decoded = 
+		(struct my_ext2_inode *)malloc(count * sizeof(struct my_ext2_inode));
+	if (raw == NULL || decoded == NULL) {
+		free(raw);
+		free(decoded);
+		return -4;
+	}
+		
+	// 데이터 블록 캐시와 중복되지 않도록 직접 읽음
+	off_t offset = (off_t)table_block * ctx->block_size;
+	ssize_t bytes_read = pread(ctx->fd, raw, ctx->block_size, offset);
+	STAT_ADD(syscalls, 1);
+	if (bytes_read != ctx->block_size) {
+		#ifdef DEBUG_FUNC
+			fprintf(stderr, "read failed in load_inode_table_block");
+		#endif
+		free(raw);
+		free(decoded);
+		return -3;
+	}
+	STAT_ADD(blocks_read, 1);
+	STAT_ADD(bytes_read, ctx->block_size);
+		
+	// 디스크상의 inode 크기(128/256...)와 무관하게 구조체 크기로 압축해서 보관
+	for (unsigned int i = 0; i < count; i++) {
+		memcpy(&decoded[i], raw + (size_t)i * ctx->inode_size, sizeof(struct my_ext2_inode));
+	}
+	block_cache_insert(&ctx->inode_cache, table_block, decoded);
+	*inode = decoded[slot];
+		
+	free(raw);
+	free(decoded);
 	return 0;
 }
 
 /**
  * inode 정보를 읽는 함수
  * 
- * @param fd EXT2 이미지 파일 디스크립터
+ * @param ctx 이미지 컨텍스트 포인터
  * @param inode_num 읽을 inode 번호
- * @param sb 슈퍼블록 포인터
- * @param gd 그룹 디스크립터 배열 포인터
  * @param inode inode 정보를 저장할 구조체 포인터
  * @return 성공 시 0, 실패 시 음수 값 반환
  */
-int	read_inode(int fd, int inode_num, 
-			  struct my_ext2_super_block *sb, 
-			  struct my_ext2_group_desc *gd, 
+int	read_inode(Ext2Context *ctx, unsigned int inode_num, 
 			  struct my_ext2_inode *inode)
 {
 	// inode 번호 유효성 검사
-	if (inode_num < 1 || inode_num > sb->s_inodes_count) {
+	if (inode_num < 1 || inode_num > ctx->sb.s_inodes_count) {
 		return -1;
 	}
 		
-	// 블록 크기 계산
-	int block_size = get_block_size(sb);
-		
 	// 블록 그룹 번호 계산
-	int inodes_per_group = sb->s_inodes_per_group;
-	int group_num = (inode_num - 1) / inodes_per_group;
+	unsigned int inodes_per_group = ctx->sb.s_inodes_per_group;
+	unsigned int group_num = (inode_num - 1) / inodes_per_group;
 		
 	// 블록 그룹 내 inode 인덱스 계산
-	int inode_index = (inode_num - 1) % inodes_per_group;
+	unsigned int inode_index = (inode_num - 1) % inodes_per_group;
 		
 	// 해당 블록 그룹의 디스크립터 가져오기
-	struct my_ext2_group_desc *group_desc = &gd[group_num];
+	struct my_ext2_group_desc *group_desc = &ctx->gd[group_num];
 		
 	// inode 테이블의 시작 블록 번호
 	__u32 inode_table = group_desc->bg_inode_table;
 		
-	// inode 크기 (일반적으로 128바이트)
-	__u32 inode_size = 128;
-	if (sb->s_rev_level > 0 && sb->s_inode_size > 0) {
-		inode_size = sb->s_inode_size;
+	// inode 오프셋 계산
+	off_t offset = (off_t)ctx->block_size * inode_table + (off_t)inode_index * ctx->inode_size;
+		
+	// 매핑된 이미지에서는 시스템 콜 없이 복사
+	if (ctx->map != NULL) {
+		if ((size_t)offset + sizeof(struct my_ext2_inode) > ctx->map_size) {
+			#ifdef DEBUG_FUNC
+				fprintf(stderr, "inode out of image in read_inode");
+			#endif
+			return -2;
+		}
+		memcpy(inode, ctx->map + offset, sizeof(struct my_ext2_inode));
+		STAT_ADD(inodes_read, 1);
+		return 0;
 	}
 		
-	// inode 오프셋 계산
-	off_t offset = (off_t)block_size * inode_table + (off_t)inode_index * inode_size;
+	// inode 테이블 캐시 사용 시 inode 테이블 블록 단위로 읽어서 디코딩
+	if (ctx->inode_cache.shard_count > 0) {
+		unsigned int table_block = inode_table + inode_index / ctx->inodes_per_block;
+		unsigned int slot = inode_index % ctx->inodes_per_block;
 		
-	// inode 위치로 이동
-	if (lseek(fd, offset, SEEK_SET) != offset) {
-		#ifdef DEBUG_FUNC
-			fprintf(stderr, "lseek failed in read_inode");
-		#endif
-		return -2;
+		if (block_cache_lookup(&ctx->inode_cache, table_block, 
+							   slot * sizeof(struct my_ext2_inode), 
+							   sizeof(struct my_ext2_inode), inode)) {
+			STAT_ADD(inodes_read, 1);
+			return 0;
+		}
+		int result = load_inode_table_block(ctx, table_block, slot, inode);
+		if (result == 0) {
+			STAT_ADD(inodes_read, 1);
+		}
+		return result;
 	}
 		
 	// inode 정보 읽기
-	ssize_t bytes_read = read(fd, inode, sizeof(struct my_ext2_inode));
+	ssize_t bytes_read = pread(ctx->fd, inode, sizeof(struct my_ext2_inode), offset);
+	STAT_ADD(syscalls, 1);
 	if (bytes_read != sizeof(struct my_ext2_inode)) {
 		#ifdef DEBUG_FUNC
 			fprintf(stderr, "read failed in read_inode");
 		#endif
 		return -3;
 	}
+	STAT_ADD(bytes_read, sizeof(struct my_ext2_inode));
+	STAT_ADD(inodes_read, 1);
 		
 	return 0;  // 성공
 }
 
 /**
- * 디렉토리 내에서 특정 이름의 엔트리 찾기
+ * 디렉토리 블록 하나에서 특정 이름의 엔트리 찾기
  * 
- * @param fd 파일 디스크립터
- * @param sb 슈퍼블록 포인터
- * @param dir_inode 디렉토리 inode 포인터
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param block_num 디렉토리 데이터 블록 번호
  * @param name 찾을 엔트리 이름
- * @return 찾은 엔트리의 inode 번호, 못 찾으면 0 반환
+ * @param scratch 블록 크기 임시 버퍼 (매핑 모드면 NULL)
+ * @return 찾은 엔트리의 inode 번호, 못 찾으면 0, 블록을 읽지 못하면 ENTRY_LOOKUP_ERROR 반환
  */
-unsigned int	find_entry_in_dir(int fd, struct my_ext2_super_block *sb, 
-							 struct my_ext2_inode *dir_inode, 
-							 const char *name)
+static unsigned int	find_entry_in_block(Ext2Context *ctx, unsigned int block_num,
+										const char *name, unsigned char *scratch)
 {
-	unsigned int block_size = get_block_size(sb);
-	unsigned char *block = malloc(block_size);
+	unsigned int block_size = ctx->block_size;
+	size_t name_len = strlen(name);
+		
+	const unsigned char *block = get_data_block(ctx, block_num, scratch);
 	if (block == NULL) {
-		return 0;
+		return ENTRY_LOOKUP_ERROR;
 	}
 		
-	// 직접 블록만 처리 (간소화)
-	for (int i = 0; i < EXT2_NDIR_BLOCKS; i++) {
-		if (dir_inode->i_block[i] == 0) {
-			continue;
+	unsigned int offset = 0;
+	while (offset < block_size) {
+		const struct my_ext2_dir_entry_2 *entry = 
+			(const struct my_ext2_dir_entry_2 *)(block + offset);
+		
+		if (entry->inode == 0 || entry->rec_len == 0) {
+			break;
 		}
+		STAT_ADD(dirents, 1);
 		
-		if (read_data_block(fd, sb, dir_inode->i_block[i], block) < 0) {
-			continue;
+		// 이름 비교
+		if (entry->name_len == name_len && 
+			strncmp(entry->name, name, entry->name_len) == 0) {
+			return entry->inode;
 		}
 		
-		unsigned int offset = 0;
-		while (offset < block_size) {
-			struct my_ext2_dir_entry_2 *entry = 
-				(struct my_ext2_dir_entry_2 *)(block + offset);
-			
-			if (entry->inode == 0 || entry->rec_len == 0) {
-				break;
-			}
-			
-			// 이름 비교
-			if (entry->name_len == strlen(name) && 
-				strncmp(entry->name, name, entry->name_len) == 0) {
-				unsigned int result = entry->inode;
-				free(block);
-				return result;
-			}
-			
-			// 중요: 실제 필요한 크기 계산
-			unsigned int real_size = 8 + entry->name_len;  // 8바이트 헤더 + 이름 길이
-			real_size = (real_size + 3) & ~3;  // 4바이트 정렬
+		// 중요: 실제 필요한 크기 계산
+		unsigned int real_size = 8 + entry->name_len;  // 8바이트 헤더 + 이름 길이
+		real_size = (real_size + 3) & ~3;  // 4바이트 정렬
+		
+		// lost+found의 경우 rec_len이 매우 클 수 있음
+		// 다음 위치에 유효한 엔트리가 있는지 확인
+		if (entry->rec_len > real_size + 8 && offset + real_size < block_size) {
+			const struct my_ext2_dir_entry_2 *next = 
+				(const struct my_ext2_dir_entry_2 *)(block + offset + real_size);
 			
-			// lost+found의 경우 rec_len이 매우 클 수 있음
-			// 다음 위치에 유효한 엔트리가 있는지 확인
-			if (entry->rec_len > real_size + 8 && offset + real_size < block_size) {
-				struct my_ext2_dir_entry_2 *next = 
-					(struct my_ext2_dir_entry_2 *)(block + offset + real_size);
-				
-				if (next->inode > 0 && next->inode < sb->s_inodes_count) {
-					// 다음 엔트리가 유효하면 실제 크기만 사용
-					offset += real_size;
-				} else {
-					// 그렇지 않으면 rec_len 사용
-					offset += entry->rec_len;
-				}
+			if (next->inode > 0 && next->inode < ctx->sb.s_inodes_count) {
+				// 다음 엔트리가 유효하면 실제 크기만 사용
+				offset += real_size;
 			} else {
+				// 그렇지 않으면 rec_len 사용
 				offset += entry->rec_len;
 			}
+		} else {
+			offset += entry->rec_len;
+		}
+	}
+		
+	return 0;
+}
+
+/**
+ * 디렉토리 내에서 특정 이름의 엔트리 찾기
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param dir_inode 디렉토리 inode 포인터
+ * @param name 찾을 엔트리 이름
+ * @return 찾은 엔트리의 inode 번호, 디렉토리 전체를 읽고도 못 찾으면 0,
+ *         블록을 읽지 못해 끝까지 찾지 못했으면 ENTRY_LOOKUP_ERROR 반환
+ */
+unsigned int	find_entry_in_dir(Ext2Context *ctx, 
+							 struct my_ext2_inode *dir_inode, 
+							 const char *name)
+{
+	unsigned char *scratch = alloc_block_scratch(ctx);
+	unsigned int result = 0;
+		
+	if (ctx->map == NULL && scratch == NULL) {
+		return ENTRY_LOOKUP_ERROR;
+	}
+		
+	// 직접/간접 블록을 익스텐트 단위로 순회
+	BlockMapIter it;
+	BlockExtent extent;
+	block_map_init(&it, ctx, dir_inode);
+	while (result == 0 && block_map_next(&it, &extent)) {
+		for (unsigned int i = 0; i < extent.length && result == 0; i++) {
+			result = find_entry_in_block(ctx, extent.physical + i, name, scratch);
 		}
 	}
+	if (result == 0 && it.failed) {
+		result = ENTRY_LOOKUP_ERROR;
+	}
+	block_map_destroy(&it);
+	free(scratch);
 		
-	free(block);
-	return 0;  // 찾지 못함
+	return result;  // 못 찾으면 0
 }
@@ -0,0 +1,240 @@
+#include "ssu_ext2.h"
+
+/**
+ * (inode, i_generation, 리프 구간) 키를 해시하는 함수
+ */
+static unsigned int	hash_leaf(unsigned int inode_num, unsigned int generation, unsigned int leaf)
+{
+	unsigned int h = inode_num * 2654435761u;
+
+	h ^= generation + 0x9e3779b9u + (h << 6) + (h >> 2);
+	h ^= leaf * 2246822519u;
+	return h ^ (h >> 15);
+}
+
+/**
+ * 엔트리 하나가 차지하는 바이트 수
+ */
+static size_t	entry_bytes(unsigned int run_count)
+{
+	return sizeof(ExtentCacheEntry) + (size_t)run_count * sizeof(BlockExtent);
+}
+
+/**
+ * 엔트리를 LRU 목록에서 떼어내는 함수
+ */
+static void	lru_unlink(ExtentCache *ec, ExtentCacheEntry *entry)
+{
+	if (entry->lru_prev != NULL) {
+		entry->lru_prev->lru_next = entry->lru_next;
+	} else {
+		ec->lru_head = entry->lru_next;
+	}
+	if (entry->lru_next != NULL) {
+		entry->lru_next->lru_prev = entry->lru_prev;
+	} else {
+		ec->lru_tail = entry->lru_prev;
+	}
+	entry->lru_prev = NULL;
+	entry->lru_next = NULL;
+}
+
+/**
+ * 엔트리를 LRU 목록 맨 앞(가장 최근)에 넣는 함수
+ */
+static void	lru_push_front(ExtentCache *ec, ExtentCacheEntry *entry)
+{
+	entry->lru_prev = NULL;
+	entry->lru_next = ec->lru_head;
+	if (ec->lru_head != NULL) {
+		ec->lru_head->lru_prev = entry;
+	}
+	ec->lru_head = entry;
+	if (ec->lru_tail == NULL) {
+		ec->lru_tail = entry;
+	}
+}
+
+/**
+ * 엔트리를 해시 버킷과 LRU 목록에서 빼고 해제하는 함수 (락을 잡은 상태에서 호출)
+ */
+static void	remove_entry(ExtentCache *ec, ExtentCacheEntry *entry)
+{
+	unsigned int bucket = hash_leaf(entry->inode_num, entry->generation, entry->leaf) & (ec->bucket_count - 1);
+	ExtentCacheEntry **link = &ec->buckets[bucket];
+
+	while (*link != NULL && *link != entry) {
+		link = &(*link)->hash_next;
+	}
+	if (*link == entry) {
+		*link = entry->hash_next;
+	}
+	lru_unlink(ec, entry);
+	ec->bytes -= entry_bytes(entry->run_count);
+	ec->entries--;
+	free(entry);
+}
+
+/**
+ * 블록 맵 캐시 초기화 함수
+ * 버킷 수는 예산에 엔트리가 평균 256바이트씩 들어간다고 보고 정함
+ *
+ * @param ec 초기화할 블록 맵 캐시 포인터
+ * @param budget 메모리 예산 (0이면 캐시 비활성화)
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+int	extent_cache_init(ExtentCache *ec, size_t budget)
+{
+	memset(ec, 0, sizeof(ExtentCache));
+	if (budget == 0) {
+		return 0;
+	}
+
+	unsigned int bucket_count = 64;
+	while ((size_t)bucket_count * 256 < budget && bucket_count < (1U << 20)) {
+		bucket_count <<= 1;
+	}
+
+	ec->buckets = (ExtentCacheEntry **)calloc(bucket_count, sizeof(ExtentCacheEntry *));
+	if (ec->buckets == NULL) {
+		return -1;
+	}
+	ec->bucket_count = bucket_count;
+	ec->budget = budget;
+	pthread_mutex_init(&ec->lock, NULL);
+	return 0;
+}
+
+/**
+ * 블록 맵 캐시의 모든 엔트리를 해제하는 함수 (이미지가 수정되었을 때)
+ *
+ * @param ec 블록 맵 캐시 포인터
+ */
+void	extent_cache_clear(ExtentCache *ec)
+{
+	if (ec->buckets == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&ec->lock);
+	ExtentCacheEntry *entry = ec->lru_head;
+	while (entry != NULL) {
+		ExtentCacheEntry *next = entry->lru_next;
+		free(entry);
+		entry = next;
+	}
+	memset(ec->buckets, 0, (size_t)ec->bucket_count * sizeof(ExtentCacheEntry *));
+	ec->lru_head = NULL;
+	ec->lru_tail = NULL;
+	ec->bytes = 0;
+	ec->entries = 0;
+	pthread_mutex_unlock(&ec->lock);
+}
+
+/**
+ * 블록 맵 캐시 메모리 해제 함수
+ *
+ * @param ec 해제할 블록 맵 캐시 포인터
+ */
+void	extent_cache_destroy(ExtentCache *ec)
+{
+	if (ec->buckets == NULL) {
+		return;
+	}
+	extent_cache_clear(ec);
+	pthread_mutex_destroy(&ec->lock);
+	free(ec->buckets);
+	ec->buckets = NULL;
+	ec->bucket_count = 0;
+}
+
+/**
+ * 리프 구간 하나의 익스텐트 목록을 찾는 함수 (찾으면 runs에 복사)
+ *
+ * @param ec 블록 맵 캐시 포인터
+ * @param inode_num inode 번호
+ * @param generation i_generation
+ * @param leaf 리프 구간 번호
+ * @param runs 익스텐트를 복사할 배열 (리프 구간의 블록 수 이상)
+ * @param run_count 익스텐트 수를 저장할 포인터
+ * @return 캐시 적중 시 true, 아니면 false
+ */
+bool	extent_cache_lookup(ExtentCache *ec, unsigned int inode_num, unsigned int generation,
+							unsigned int leaf, BlockExtent *runs, unsigned int *run_count)
+{
+	if (ec->buckets == NULL) {
+		return false;
+	}
+
+	unsigned int bucket = hash_leaf(inode_num, generation, leaf) & (ec->bucket_count - 1);
+
+	pthread_mutex_lock(&ec->lock);
+	for (ExtentCacheEntry *entry = ec->buckets[bucket]; entry != NULL; entry = entry->hash_next) {
+		if (entry->inode_num == inode_num && entry->generation == generation && entry->leaf == leaf) {
+			memcpy(runs, entry->runs, (size_t)entry->run_count * sizeof(BlockExtent));
+			*run_count = entry->run_count;
+			lru_unlink(ec, entry);
+			lru_push_front(ec, entry);
+			ec->hits++;
+			pthread_mutex_unlock(&ec->lock);
+			return true;
+		}
+	}
+	ec->misses++;
+	pthread_mutex_unlock(&ec->lock);
+	return false;
+}
+
+/**
+ * 리프 구간 하나의 익스텐트 목록을 캐시에 넣는 함수
+ * 예산을 넘으면 가장 오래전에 사용한 엔트리부터 내보냄 (예산보다 큰 목록은 넣지 않음)
+ *
+ * @param ec 블록 맵 캐시 포인터
+ * @param inode_num inode 번호
+ * @param generation i_generation
+ * @param leaf 리프 구간 번호
+ * @param runs 익스텐트 배열
+ * @param run_count 익스텐트 수
+ */
+void	extent_cache_insert(ExtentCache *ec, unsigned int inode_num, unsigned int generation,
+							unsigned int leaf, const BlockExtent *runs, unsigned int run_count)
+{
+	size_t bytes = entry_bytes(run_count);
+	if (ec->buckets == NULL || bytes > ec->budget) {
+		return;
+	}
+
+	ExtentCacheEntry *entry = (ExtentCacheEntry *)malloc(bytes);
+	if (entry == NULL) {
+		return;
+	}
+	entry->inode_num = inode_num;
+	entry->generation = generation;
+	entry->leaf = leaf;
+	entry->run_count = run_count;
+	memcpy(entry->runs, runs, (size_t)run_count * sizeof(BlockExtent));
+
+	unsigned int bucket = hash_leaf(inode_num, generation, leaf) & (ec->bucket_count - 1);
+
+	pthread_mutex_lock(&ec->lock);
+
+	// 다른 반복자가 먼저 넣었으면 그대로 둠
+	for (ExtentCacheEntry *old = ec->buckets[bucket]; old != NULL; old = old->hash_next) {
+		if (old->inode_num == inode_num && old->generation == generation && old->leaf == leaf) {
+			pthread_mutex_unlock(&ec->lock);
+			free(entry);
+			return;
+		}
+	}
+
+	while (ec->bytes + bytes > ec->budget && ec->lru_tail != NULL) {
+		remove_entry(ec, ec->lru_tail);
+		ec->evictions++;
+	}
+
+	entry->hash_next = ec->buckets[bucket];
+	ec->buckets[bucket] = entry;
+	lru_push_front(ec, entry);
+	ec->bytes += bytes;
+	ec->entries++;
+	pthread_mutex_unlock(&ec->lock);
+}
@@ -70,6 +70,14 @@ void	help(char *line)
 		return ;
 	}
 
+	if (!strcmp(splited[1], "stats")) {
+		#ifdef DEBUG_HELP
+			printf("help stats\n");
+		#endif
+		help_stats();
+		return ;
+	}
+
 	if (!strcmp(splited[1], "exit")) {
 		#ifdef DEBUG_HELP
 			printf("help exit\n");
@@ -95,6 +103,10 @@ void	help_all()
 	printf("    -p : display the directory structure if <PATH> is a directory, including the permissions of each directory and file\n");
 	printf("  > print <PATH> [OPTION]... : print the contents on the standard output if <PATH> is file\n");
 	printf("    -n <line_number> : print only the first <line_number> lines of its contents on the standard output if <PATH> is file\n");
+	printf("    -t <line_number> : print only the last <line_number> lines of its contents on the standard output if <PATH> is file\n");
+	printf("    -o <offset> : print its contents starting at byte <offset> if <PATH> is file\n");
+	printf("    -c <bytes> : print at most <bytes> bytes of its contents if <PATH> is file\n");
+	printf("  > stats [reset|on|off] : show I/O and timing statistics of the session and the last command\n");
 	printf("  > help [COMMAND] : show commands for progarm\n");
 	printf("  > exit : exit program\n");
 }
@@ -121,6 +133,9 @@ void	help_print()
 	printf("Usage:\n");
 	printf("  > print <PATH> [OPTION]... : print the contents on the standard output if <PATH> is file\n");
 	printf("    -n <line_number> : print only the first <line_number> lines of its contents on the standard output if <PATH> is file\n");
+	printf("    -t <line_number> : print only the last <line_number> lines of its contents on the standard output if <PATH> is file\n");
+	printf("    -o <offset> : print its contents starting at byte <offset> if <PATH> is file\n");
+	printf("    -c <bytes> : print at most <bytes> bytes of its contents if <PATH> is file\n");
 }
 
 /**
@@ -133,6 +148,19 @@ void	help_help()
 	printf("  > help [COMMAND] : show commands for progarm\n");
 }
 
+/**
+*
+*stats 명령어 도움말 출력 함수
+*/
+void	help_stats()
+{
+	printf("Usage:\n");
+	printf("  > stats [reset|on|off] : show I/O and timing statistics of the session and the last command\n");
+	printf("    reset : start counting the session statistics again\n");
+	printf("    on : print a one-line summary after every command\n");
+	printf("    off : stop printing the one-line summary\n");
+}
+
 /**
 *
 *exit 명령어 도움말 출력 함수
@@ -0,0 +1,255 @@
+#include "ssu_ext2.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD
+#endif
+
+typedef size_t	(*NewlineFindFn)(const unsigned char *data, size_t len, unsigned long long *remaining);
+
+static NewlineFindFn	newline_find_impl = NULL;
+static NewlineFindFn	newline_rfind_impl = NULL;
+static const char		*newline_impl_name = "scalar";
+static pthread_once_t	newline_once = PTHREAD_ONCE_INIT;
+
+/**
+ * 바이트 단위로 개행을 세는 함수 (SIMD를 쓸 수 없을 때, 그리고 SIMD 구현의 남은 꼬리 처리)
+ *
+ * @param data 검사할 데이터
+ * @param len 데이터 길이
+ * @param remaining 남은 라인 수 (찾은 개행 수만큼 줄어듦, 1 이상)
+ * @return remaining이 0이 된 개행 바로 다음 위치, 도달하지 못하면 len
+ */
+static size_t	newline_find_scalar(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (data[i] == '\n' && --(*remaining) == 0) {
+			return i + 1;
+		}
+	}
+	return len;
+}
+
+/**
+ * 끝에서부터 바이트 단위로 개행을 세는 함수
+ *
+ * @param data 검사할 데이터
+ * @param len 데이터 길이
+ * @param remaining 남은 라인 수 (찾은 개행 수만큼 줄어듦, 1 이상)
+ * @return remaining이 0이 된 개행 바로 다음 위치, 도달하지 못하면 0
+ */
+static size_t	newline_rfind_scalar(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	for (size_t i = len; i > 0; i--) {
+		if (data[i - 1] == '\n' && --(*remaining) == 0) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+/**
+ * 청크의 개행 비트 마스크에서 left번째 개행의 위치를 구하는 함수
+ *
+ * @param mask 바이트마다 개행이면 1인 비트 마스크
+ * @param left 찾을 개행 순번 (1 이상, 마스크의 비트 수 이하)
+ * @return 청크 안의 개행 위치
+ */
+static unsigned int	nth_set_bit(unsigned int mask, unsigned long long left)
+{
+	while (--left > 0) {
+		mask &= mask - 1;  // 가장 낮은 비트 제거
+	}
+	return (unsigned int)__builtin_ctz(mask);
+}
+
+/**
+ * 청크의 개행 비트 마스크에서 높은 쪽부터 left번째 개행의 위치를 구하는 함수
+ *
+ * @param mask 바이트마다 개행이면 1인 비트 마스크
+ * @param left 찾을 개행 순번 (1 이상, 마스크의 비트 수 이하)
+ * @return 청크 안의 개행 위치
+ */
+static unsigned int	nth_high_bit(unsigned int mask, unsigned long long left)
+{
+	unsigned int pos = 31 - (unsigned int)__builtin_clz(mask);
+	while (--left > 0) {
+		mask &= ~(1U << pos);  // 가장 높은 비트 제거
+		pos = 31 - (unsigned int)__builtin_clz(mask);
+	}
+	return pos;
+}
+
+#ifdef HAVE_X86_SIMD
+/**
+ * SSE2로 16바이트씩 비교해서 개행을 세는 함수
+ * 청크의 개행 수가 남은 라인 수보다 적으면 빼고 넘어가고, 아니면 그 청크 안에서 위치를 찾음
+ */
+__attribute__((target("sse2")))
+static size_t	newline_find_sse2(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	const __m128i newline = _mm_set1_epi8('\n');
+	size_t i = 0;
+
+	for (; i + 16 <= len; i += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+		unsigned int count = (unsigned int)__builtin_popcount(mask);
+		if (count < *remaining) {
+			*remaining -= count;
+			continue;
+		}
+		unsigned int pos = nth_set_bit(mask, *remaining);
+		*remaining = 0;
+		return i + pos + 1;
+	}
+	size_t tail = newline_find_scalar(data + i, len - i, remaining);
+	return i + tail;
+}
+
+/**
+ * SSE2로 끝에서부터 16바이트씩 비교해서 개행을 세는 함수
+ */
+__attribute__((target("sse2")))
+static size_t	newline_rfind_sse2(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	const __m128i newline = _mm_set1_epi8('\n');
+	size_t i = len;
+
+	for (; i >= 16; i -= 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(data + i - 16));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+		unsigned int count = (unsigned int)__builtin_popcount(mask);
+		if (count < *remaining) {
+			*remaining -= count;
+			continue;
+		}
+		unsigned int pos = nth_high_bit(mask, *remaining);
+		*remaining = 0;
+		return i - 16 + pos + 1;
+	}
+	return newline_rfind_scalar(data, i, remaining);
+}
+
+/**
+ * AVX2로 32바이트씩 비교해서 개행을 세는 함수 (SSE2 구현과 같은 방식)
+ */
+__attribute__((target("avx2,popcnt")))
+static size_t	newline_find_avx2(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	const __m256i newline = _mm256_set1_epi8('\n');
+	size_t i = 0;
+
+	for (; i + 32 <= len; i += 32) {
+		__m256i chunk = _mm256_loadu_si256((const __m256i *)(data + i));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline));
+		unsigned int count = (unsigned int)__builtin_popcount(mask);
+		if (count < *remaining) {
+			*remaining -= count;
+			continue;
+		}
+		unsigned int pos = nth_set_bit(mask, *remaining);
+		*remaining = 0;
+		return i + pos + 1;
+	}
+	size_t tail = newline_find_scalar(data + i, len - i, remaining);
+	return i + tail;
+}
+
+/**
+ * AVX2로 끝에서부터 32바이트씩 비교해서 개행을 세는 함수
+ */
+__attribute__((target("avx2,popcnt")))
+static size_t	newline_rfind_avx2(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	const __m256i newline = _mm256_set1_epi8('\n');
+	size_t i = len;
+
+	for (; i >= 32; i -= 32) {
+		__m256i chunk = _mm256_loadu_si256((const __m256i *)(data + i - 32));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline));
+		unsigned int count = (unsigned int)__builtin_popcount(mask);
+		if (count < *remaining) {
+			*remaining -= count;
+			continue;
+		}
+		unsigned int pos = nth_high_bit(mask, *remaining);
+		*remaining = 0;
+		return i - 32 + pos + 1;
+	}
+	return newline_rfind_scalar(data, i, remaining);
+}
+#endif
+
+/**
+ * CPU가 지원하는 가장 넓은 구현을 고르는 함수 (처음 한 번만 실행)
+ */
+static void	newline_select(void)
+{
+	newline_find_impl = newline_find_scalar;
+	newline_rfind_impl = newline_rfind_scalar;
+	newline_impl_name = "scalar";
+
+	#ifdef HAVE_X86_SIMD
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+			newline_find_impl = newline_find_avx2;
+			newline_rfind_impl = newline_rfind_avx2;
+			newline_impl_name = "avx2";
+		} else if (__builtin_cpu_supports("sse2")) {
+			newline_find_impl = newline_find_sse2;
+			newline_rfind_impl = newline_rfind_sse2;
+			newline_impl_name = "sse2";
+		}
+	#endif
+
+	#ifdef DEBUG_PRINT
+		fprintf(stderr, "newline scan: %s\n", newline_impl_name);
+	#endif
+}
+
+/**
+ * 개행을 세면서 남은 라인 수가 0이 되는 위치를 찾는 함수 (print -n의 출력 끝 위치)
+ * 실행 중인 CPU에 따라 AVX2, SSE2, 바이트 단위 구현 중 하나를 사용
+ *
+ * @param data 검사할 데이터
+ * @param len 데이터 길이
+ * @param remaining 남은 라인 수 (찾은 개행 수만큼 줄어듦, 0이면 바로 0 반환)
+ * @return remaining이 0이 된 개행 바로 다음 위치, 도달하지 못하면 len
+ */
+size_t	newline_find(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	if (*remaining == 0) {
+		return 0;
+	}
+	pthread_once(&newline_once, newline_select);
+	return newline_find_impl(data, len, remaining);
+}
+
+/**
+ * 끝에서부터 개행을 세면서 남은 라인 수가 0이 되는 위치를 찾는 함수 (print -t의 출력 시작 위치)
+ *
+ * @param data 검사할 데이터
+ * @param len 데이터 길이
+ * @param remaining 남은 라인 수 (찾은 개행 수만큼 줄어듦, 0이면 바로 len 반환)
+ * @return remaining이 0이 된 개행 바로 다음 위치, 도달하지 못하면 0
+ */
+size_t	newline_rfind(const unsigned char *data, size_t len, unsigned long long *remaining)
+{
+	if (*remaining == 0) {
+		return len;
+	}
+	pthread_once(&newline_once, newline_select);
+	return newline_rfind_impl(data, len, remaining);
+}
+
+/**
+ * 사용 중인 개행 탐색 구현 이름을 반환하는 함수 ("avx2", "sse2", "scalar")
+ *
+ * @return 구현 이름
+ */
+const char	*newline_scan_name(void)
+{
+	pthread_once(&newline_once, newline_select);
+	return newline_impl_name;
+}
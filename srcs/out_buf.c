@@ -0,0 +1,221 @@
+#include "ssu_ext2.h"
+
+/*
+ * 권한 비트(하위 9비트) -> "rwxr-xr-x" 문자열 테이블 (컴파일 시간에 생성, 문자열은 NUL 종료하지 않음)
+ */
+#define PERM3(n) ((n) & 4 ? 'r' : '-'), ((n) & 2 ? 'w' : '-'), ((n) & 1 ? 'x' : '-')
+#define PERM9(n) { PERM3((n) >> 6), PERM3((n) >> 3), PERM3(n) }
+#define PERM_ROW8(n) PERM9(n), PERM9((n) + 1), PERM9((n) + 2), PERM9((n) + 3), \
+	PERM9((n) + 4), PERM9((n) + 5), PERM9((n) + 6), PERM9((n) + 7)
+#define PERM_ROW64(n) PERM_ROW8(n), PERM_ROW8((n) + 8), PERM_ROW8((n) + 16), PERM_ROW8((n) + 24), \
+	PERM_ROW8((n) + 32), PERM_ROW8((n) + 40), PERM_ROW8((n) + 48), PERM_ROW8((n) + 56)
+
+static const char	perm_table[512][9] = {
+	PERM_ROW64(0), PERM_ROW64(64), PERM_ROW64(128), PERM_ROW64(192),
+	PERM_ROW64(256), PERM_ROW64(320), PERM_ROW64(384), PERM_ROW64(448)
+};
+
+/**
+ * 버퍼 전체를 출력할 때까지 write를 반복하는 함수
+ *
+ * @param fd 출력 파일 디스크립터
+ * @param data 출력할 데이터
+ * @param len 데이터 길이
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	write_all(int fd, const unsigned char *data, size_t len)
+{
+	unsigned long long trace_start = TRACE_BEGIN();
+	size_t total = len;
+
+	while (len > 0) {
+		ssize_t written = write(fd, data, len);
+		STAT_ADD(syscalls, 1);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		data += written;
+		len -= (size_t)written;
+	}
+	TRACE_END("output_flush", trace_start, "bytes", total, "fd", fd);
+	return 0;
+}
+
+/**
+ * 출력 버퍼 초기화 함수
+ * 버퍼를 할당하지 못하면 용량 0으로 두고 모든 출력을 바로 write (느리지만 동작은 같음)
+ *
+ * @param out 초기화할 출력 버퍼 포인터
+ * @param fd 출력 파일 디스크립터
+ * @param capacity 버퍼 크기
+ * @return 성공 시 0, 버퍼를 할당하지 못하면 -1
+ */
+int	out_buf_init(OutBuf *out, int fd, size_t capacity)
+{
+	memset(out, 0, sizeof(OutBuf));
+	out->fd = fd;
+	out->data = (char *)malloc(capacity);
+	if (out->data == NULL) {
+		return -1;
+	}
+	out->capacity = capacity;
+	return 0;
+}
+
+/**
+ * 출력 버퍼 정리 함수 (남은 내용을 출력한 뒤 해제)
+ *
+ * @param out 정리할 출력 버퍼 포인터
+ */
+void	out_buf_destroy(OutBuf *out)
+{
+	out_buf_flush(out);
+	free(out->data);
+	out->data = NULL;
+	out->capacity = 0;
+}
+
+/**
+ * 버퍼에 쌓인 내용을 출력하는 함수
+ * printf로 쌓인 출력(프롬프트, 오류 메시지 등)이 먼저 나오도록 stdout을 먼저 비움
+ *
+ * @param out 출력 버퍼 포인터
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_flush(OutBuf *out)
+{
+	fflush(stdout);
+	if (out->len == 0) {
+		return 0;
+	}
+
+	size_t len = out->len;
+	out->len = 0;
+	out->flushes++;
+	if (write_all(out->fd, (const unsigned char *)out->data, len) < 0) {
+		out->failed = true;
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * 버퍼에 데이터를 붙이는 함수
+ * 남은 공간이 모자라면 먼저 출력하고, 버퍼보다 큰 데이터는 복사하지 않고 바로 출력
+ *
+ * @param out 출력 버퍼 포인터
+ * @param data 붙일 데이터
+ * @param len 데이터 길이
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_write(OutBuf *out, const void *data, size_t len)
+{
+	if (len <= out->capacity - out->len) {
+		memcpy(out->data + out->len, data, len);
+		out->len += len;
+		return 0;
+	}
+
+	if (out_buf_flush(out) < 0) {
+		return -1;
+	}
+	if (len >= out->capacity) {
+		if (write_all(out->fd, (const unsigned char *)data, len) < 0) {
+			out->failed = true;
+			return -1;
+		}
+		return 0;
+	}
+	memcpy(out->data, data, len);
+	out->len = len;
+	return 0;
+}
+
+/**
+ * 버퍼에 문자 하나를 붙이는 함수
+ *
+ * @param out 출력 버퍼 포인터
+ * @param c 붙일 문자
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_char(OutBuf *out, char c)
+{
+	if (out->len < out->capacity) {
+		out->data[out->len++] = c;
+		return 0;
+	}
+	return out_buf_write(out, &c, 1);
+}
+
+/**
+ * 버퍼에 NUL 종료 문자열을 붙이는 함수
+ *
+ * @param out 출력 버퍼 포인터
+ * @param str 붙일 문자열
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_str(OutBuf *out, const char *str)
+{
+	return out_buf_write(out, str, strlen(str));
+}
+
+/**
+ * 버퍼에 부호 없는 정수를 10진수로 붙이는 함수 (printf("%llu")와 같은 결과)
+ *
+ * @param out 출력 버퍼 포인터
+ * @param value 붙일 값
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_uint(OutBuf *out, unsigned long long value)
+{
+	char digits[20];
+	int pos = sizeof(digits);
+
+	do {
+		digits[--pos] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	return out_buf_write(out, digits + pos, sizeof(digits) - pos);
+}
+
+/**
+ * 버퍼에 부호 있는 정수를 10진수로 붙이는 함수 (printf("%d")와 같은 결과)
+ *
+ * @param out 출력 버퍼 포인터
+ * @param value 붙일 값
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_int(OutBuf *out, long long value)
+{
+	if (value < 0) {
+		if (out_buf_char(out, '-') < 0) {
+			return -1;
+		}
+		return out_buf_uint(out, 0ULL - (unsigned long long)value);
+	}
+	return out_buf_uint(out, (unsigned long long)value);
+}
+
+/**
+ * 버퍼에 파일 타입과 권한 문자열(예: "drwxr-xr-x")을 붙이는 함수
+ * 권한 9글자는 권한 비트로 테이블을 찾아 한 번에 복사
+ *
+ * @param out 출력 버퍼 포인터
+ * @param mode 파일 모드 (i_mode)
+ * @return 성공 시 0, 실패 시 -1
+ */
+int	out_buf_mode(OutBuf *out, unsigned int mode)
+{
+	char text[10];
+
+	// 파일 타입
+	if (S_ISDIR(mode)) text[0] = 'd';
+	else if (S_ISLNK(mode)) text[0] = 'l';
+	else text[0] = '-';
+
+	memcpy(text + 1, perm_table[mode & 0777], 9);
+	return out_buf_write(out, text, sizeof(text));
+}
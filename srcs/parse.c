@@ -59,7 +59,8 @@ bool	parse_print_command(char *line, Command *cmd)
 			break ;
 		}
 
-		if (strcmp(argv[i], "-n") == 0) {
+		// -n: 앞쪽 라인 수, -t: 뒤쪽 라인 수 (둘 중 하나만 사용 가능)
+		if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "-t") == 0) {
 			if (n_flag >= 1) {
 					help_all();
 					return false;
@@ -75,12 +76,47 @@ bool	parse_print_command(char *line, Command *cmd)
 				}
 
 				cmd->extra_param = (int)num;
+				cmd->options |= (argv[i][1] == 't') ? PRINT_OPT_T : PRINT_OPT_N;
 				n_flag++;
 				i++; //숫자 인자 건너뛰기
 
 			}
 			else {
-				printf("print: option requries an argument -- \'n\'\n");
+				printf("print: option requries an argument -- \'%c\'\n", argv[i][1]);
+				free(original_line);
+				return false;
+			}
+		}
+		// -o: 시작 바이트 위치, -c: 출력할 바이트 수 (각각 한 번만 사용 가능)
+		else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-c") == 0) {
+			int flag = (argv[i][1] == 'o') ? PRINT_OPT_O : PRINT_OPT_C;
+			if (cmd->options & flag) {
+				help_all();
+				free(original_line);
+				return false;
+			}
+			if (i + 1 < argc) {
+				//숫자 인지 확인 (음수 불가, -c는 1 이상)
+				char *endptr;
+				errno = 0;
+				unsigned long long num = strtoull(argv[i + 1], &endptr, 10);
+
+				if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9' || *endptr != '\0' || errno == ERANGE ||
+					(flag == PRINT_OPT_C && num == 0)) {
+					has_error = true;
+					break ;
+				}
+
+				if (flag == PRINT_OPT_O) {
+					cmd->range_offset = num;
+				} else {
+					cmd->range_length = num;
+				}
+				cmd->options |= flag;
+				i++; //숫자 인자 건너뛰기
+			}
+			else {
+				printf("print: option requries an argument -- \'%c\'\n", argv[i][1]);
 				free(original_line);
 				return false;
 			}
@@ -91,6 +127,13 @@ bool	parse_print_command(char *line, Command *cmd)
 		}
 	}
 
+	// -t는 파일 끝 기준이므로 -o/-c와 함께 사용 불가
+	if ((cmd->options & PRINT_OPT_T) && (cmd->options & (PRINT_OPT_O | PRINT_OPT_C))) {
+		help_all();
+		free(original_line);
+		return false;
+	}
+
 	if (n_flag > 1) {
 		help_all();
 		free(original_line);
@@ -110,11 +153,12 @@ bool	parse_print_command(char *line, Command *cmd)
 *
 *tree 명령어 파싱 함수
 *
+*@param ctx 이미지 컨텍스트 포인터
 *@param line 사용자 입력 라인
 *@param cmd 파싱 결과를 저장할 명령어 구조체 포인터
 *@return 파싱 성공 시 true, 실패 시 false
 */
-bool	parse_tree_command(char *line, Command *cmd)
+bool	parse_tree_command(Ext2Context *ctx, char *line, Command *cmd)
 {
 	char	*original_line = strdup(line);
 	char	*argv[64] = {0};
@@ -146,7 +190,7 @@ bool	parse_tree_command(char *line, Command *cmd)
 
 	//리턴값 int로 조정해서 0이면 help 출력 -1이면 내부 출력 1이면 성공
 	int flag;
-	if ((flag = validate_tree_path(cmd->path)) < 1) {
+	if ((flag = validate_tree_path(ctx, cmd->path)) < 1) {
 		if (flag == 0)
 			help_all();
 		free(original_line);
@@ -209,3 +253,129 @@ bool	parse_tree_command(char *line, Command *cmd)
 	free(original_line);
 	return true;
 }
+
+/**
+*
+*프로그램 실행 옵션 파싱 함수
+*
+*@param argc 명령행 인자 개수
+*@param argv 명령행 인자 배열
+*@param config 파싱 결과를 저장할 실행 옵션 구조체 포인터
+*@param image 이미지 경로 인자를 저장할 포인터
+*@return 파싱 성공 시 true, 실패 시 false
+*/
+bool	parse_session_options(int argc, char *argv[], Ext2Config *config, char **image)
+{
+	//기본값
+	config->use_mmap = true;
+	config->cache_bytes = DEFAULT_CACHE_BYTES;
+	config->inode_cache_bytes = DEFAULT_INODE_CACHE_BYTES;
+	config->extent_cache_bytes = DEFAULT_EXTENT_CACHE_BYTES;
+	config->use_io_uring = false;
+	config->queue_depth = DEFAULT_QUEUE_DEPTH;
+	config->walk_threads = 1;
+	config->arena_chunk_bytes = DEFAULT_ARENA_CHUNK;
+	config->arena_stats = false;
+	config->tree_stream = false;
+	config->stats_summary = false;
+	config->trace_path = NULL;
+	*image = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		// 옵션이 아니면 이미지 경로 (하나만 허용)
+		if (strncmp(argv[i], "--", 2) != 0) {
+			if (*image != NULL) {
+				return false;
+			}
+			*image = argv[i];
+			continue;
+		}
+
+		if (strcmp(argv[i], "--no-mmap") == 0) {
+			config->use_mmap = false;
+		}
+		else if (strncmp(argv[i], "--cache-size=", 13) == 0) {
+			//MB 단위 숫자인지 확인
+			char *endptr;
+			long num = strtol(argv[i] + 13, &endptr, 10);
+
+			if (argv[i][13] == '\0' || *endptr != '\0' || num < 0) {
+				return false;
+			}
+			config->cache_bytes = (size_t)num * 1024 * 1024;
+		}
+		else if (strncmp(argv[i], "--inode-cache-size=", 19) == 0) {
+			//MB 단위 숫자인지 확인
+			char *endptr;
+			long num = strtol(argv[i] + 19, &endptr, 10);
+
+			if (argv[i][19] == '\0' || *endptr != '\0' || num < 0) {
+				return false;
+			}
+			config->inode_cache_bytes = (size_t)num * 1024 * 1024;
+		}
+		else if (strncmp(argv[i], "--extent-cache-size=", 20) == 0) {
+			//KB 단위 숫자인지 확인
+			char *endptr;
+			long num = strtol(argv[i] + 20, &endptr, 10);
+
+			if (argv[i][20] == '\0' || *endptr != '\0' || num < 0) {
+				return false;
+			}
+			config->extent_cache_bytes = (size_t)num * 1024;
+		}
+		else if (strcmp(argv[i], "--io-uring") == 0) {
+			config->use_io_uring = true;
+		}
+		else if (strncmp(argv[i], "--queue-depth=", 14) == 0) {
+			//1 ~ MAX_QUEUE_DEPTH 범위 숫자인지 확인
+			char *endptr;
+			long num = strtol(argv[i] + 14, &endptr, 10);
+
+			if (argv[i][14] == '\0' || *endptr != '\0' || num < 1 || num > MAX_QUEUE_DEPTH) {
+				return false;
+			}
+			config->queue_depth = (unsigned int)num;
+		}
+		else if (strncmp(argv[i], "--threads=", 10) == 0) {
+			//1 ~ MAX_WALK_THREADS 범위 숫자인지 확인
+			char *endptr;
+			long num = strtol(argv[i] + 10, &endptr, 10);
+
+			if (argv[i][10] == '\0' || *endptr != '\0' || num < 1 || num > MAX_WALK_THREADS) {
+				return false;
+			}
+			config->walk_threads = (unsigned int)num;
+		}
+		else if (strncmp(argv[i], "--arena-chunk-size=", 19) == 0) {
+			//KB 단위 숫자인지 확인 (4KB ~ 1GB)
+			char *endptr;
+			long num = strtol(argv[i] + 19, &endptr, 10);
+
+			if (argv[i][19] == '\0' || *endptr != '\0' || num < 4 || num > 1024 * 1024) {
+				return false;
+			}
+			config->arena_chunk_bytes = (size_t)num * 1024;
+		}
+		else if (strcmp(argv[i], "--arena-stats") == 0) {
+			config->arena_stats = true;
+		}
+		else if (strcmp(argv[i], "--tree-stream") == 0) {
+			config->tree_stream = true;
+		}
+		else if (strcmp(argv[i], "--stats") == 0) {
+			config->stats_summary = true;
+		}
+		else if (strncmp(argv[i], "--trace=", 8) == 0) {
+			if (argv[i][8] == '\0') {
+				return false;
+			}
+			config->trace_path = argv[i] + 8;
+		}
+		else {
+			return false;
+		}
+	}
+
+	return *image != NULL;
+}
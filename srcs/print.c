@@ -1,527 +1,282 @@
 #include "ssu_ext2.h"
 
 /**
- * 파일 내용 출력 함수
+ * 파일 내용 중 지정한 바이트 구간을 출력하는 함수
+ * 시작 논리 블록의 직접/간접 칸을 바로 찾아 내려가서 구간에 해당하는 블록만 매핑하고,
+ * 얻은 익스텐트를 출력 스트림에 넘겨 큰 단위로 읽고 출력
+ * 구멍(hole)은 0으로 채워서 출력
  * 
- * @param fd 파일 디스크립터
- * @param sb 슈퍼블록 포인터
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param inode_num 파일의 inode 번호 (블록 맵 캐시 키)
  * @param inode 파일의 inode 구조체 포인터
- * @param line_count 출력할 라인 수 (0 또는 음수면 전체 출력)
+ * @param offset 시작 바이트 위치
+ * @param length 출력할 바이트 수 (i_size를 넘는 부분은 잘라냄)
+ * @param line_count 출력할 라인 수 (0 또는 음수면 구간 전체 출력)
  * @return 성공 시 0, 실패 시 음수 값
  */
-int	print_file_content(int fd, struct my_ext2_super_block *sb, 
-					  struct my_ext2_inode *inode, 
-					  int line_count)
+int	print_file_range(Ext2Context *ctx, 
+					unsigned int inode_num, 
+					struct my_ext2_inode *inode, 
+					unsigned long long offset, 
+					unsigned long long length, 
+					int line_count)
 {
-	unsigned int block_size = get_block_size(sb);
-	unsigned char *buffer = (unsigned char *)malloc(block_size);
+	unsigned long long file_size = inode->i_size;
+	unsigned int block_size = ctx->block_size;
+	int result = 0;
 		
-	int total_printed = 0;
-	int line_printed = 0;
+	if (offset >= file_size || length == 0) {
+		return 0;
+	}
+	unsigned long long end = (length > file_size - offset) ? file_size : offset + length;
 		
-	// 직접 블록 처리 (i_block[0] ~ i_block[11])
-	for (int i = 0; i < EXT2_NDIR_BLOCKS; i++) {
-		if (inode->i_block[i] == 0 || 
-			total_printed >= inode->i_size ||
-			(line_count > 0 && line_printed >= line_count)) {
-			break;
+	// 스트림은 end를 파일 끝으로 보고 그 이후는 출력하지 않음
+	PrintStream ps;
+	if (print_stream_init(&ps, ctx, end, line_count) < 0) {
+		return -1;
+	}
+	ps.position = offset;
+		
+	BlockMapIter it;
+	BlockExtent extent;
+	block_map_init_cached(&it, ctx, inode_num, inode);
+	block_map_seek(&it, (unsigned int)(offset / block_size), 
+				   (unsigned int)((end + block_size - 1) / block_size));
+	while (result == 0 && !ps.done && block_map_next(&it, &extent)) {
+		unsigned long long extent_start = (unsigned long long)extent.logical * block_size;
+		unsigned int skip = 0;
+		
+		// 구간 시작이 첫 익스텐트 중간이면 앞부분을 건너뜀
+		if (extent_start < ps.position) {
+			skip = (unsigned int)(ps.position - extent_start);
 		}
-		
-		if (read_data_block(fd, sb, inode->i_block[i], buffer) < 0) {
-			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Failed to read data block %u\n", inode->i_block[i]);
-			#endif
-			continue;
+		// 익스텐트 앞의 구멍은 0으로 출력
+		else if (ps.position < extent_start) {
+			result = print_stream_zero(&ps, extent_start - ps.position);
 		}
 		
-		// 이 블록에서 출력할 바이트 수 계산
-		unsigned int bytes_to_print = 
-			(total_printed + block_size > inode->i_size) ? 
-			(inode->i_size - total_printed) : block_size;
-		
-		if (line_count <= 0) {
-			write(STDOUT_FILENO, buffer, bytes_to_print);
-			total_printed += bytes_to_print;
-		} else {
-			for (unsigned int j = 0; j < bytes_to_print && line_printed < line_count; j++) {
-				putchar(buffer[j]);
-				total_printed++;
-				
-				if (buffer[j] == '\n') {
-					line_printed++;
-					if (line_printed >= line_count) {
-						break;
-					}
+		if (result == 0) {
+			result = print_stream_run(&ps, extent.physical, extent.length, skip);
+			#ifdef DEBUG_PRINT
+				if (result < 0) {
+					fprintf(stderr, "Failed to read data blocks %u..%u\n", 
+					  extent.physical, extent.physical + extent.length - 1);
 				}
-			}
+			#endif
 		}
 	}
+	// 간접 블록을 읽지 못했으면 구멍과 달리 0으로 채우지 않고 실패
+	if (result == 0 && it.failed) {
+		result = -2;
+	}
+	block_map_destroy(&it);
 		
-	// 간접 블록이 필요한 경우 처리
-	if (total_printed < inode->i_size && 
-		(line_count <= 0 || line_printed < line_count) &&
-		inode->i_block[EXT2_IND_BLOCK] != 0) {
-		
-		// 간접 블록 데이터 읽기
-		unsigned int *indirect_blocks = (unsigned int *)malloc(block_size);
+	// 구간 끝의 구멍도 0으로 출력
+	if (result == 0 && !ps.done && ps.position < end) {
+		result = print_stream_zero(&ps, end - ps.position);
+	}
 		
-		if (read_data_block(fd, sb, inode->i_block[EXT2_IND_BLOCK], (unsigned char *)indirect_blocks) < 0) {
+	if (print_stream_flush(&ps) < 0 && result == 0) {
+		result = -1;
+	}
+	if (out_buf_flush(&ctx->out) < 0 && result == 0) {
+		result = -1;
+	}
+	if (ctx->config.use_io_uring) {
+		print_stream_report(&ps);
+	}
+	print_stream_destroy(&ps);
+	return result;
+}
+
+/**
+ * 파일 내용 출력 함수 (파일 전체 구간)
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param inode_num 파일의 inode 번호
+ * @param inode 파일의 inode 구조체 포인터
+ * @param line_count 출력할 라인 수 (0 또는 음수면 전체 출력)
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+int	print_file_content(Ext2Context *ctx, 
+					  unsigned int inode_num, 
+					  struct my_ext2_inode *inode, 
+					  int line_count)
+{
+	return print_file_range(ctx, inode_num, inode, 0, inode->i_size, line_count);
+}
+
+/**
+ * 파일의 논리 블록 하나를 읽는 함수 (구멍이면 0으로 채운 블록)
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param it 블록 맵 반복자 포인터
+ * @param logical 논리 블록 번호
+ * @param scratch pread 경로의 블록 버퍼
+ * @param zeros 0으로 채운 블록 버퍼
+ * @return 블록 데이터, 읽기 실패 시 NULL
+ */
+static const unsigned char	*read_file_block(Ext2Context *ctx, BlockMapIter *it, unsigned int logical,
+											unsigned char *scratch, const unsigned char *zeros)
+{
+	unsigned int physical = block_map_lookup(it, logical);
+	if (physical == BLOCK_MAP_ERROR) {
+		return NULL;
+	}
+	if (physical == 0) {
+		return zeros;
+	}
+	return get_data_block(ctx, physical, scratch);
+}
+
+/**
+ * 파일의 마지막 N줄 출력 함수 (print -t)
+ * 블록 맵으로 파일 끝 블록부터 거꾸로 읽으면서 개행을 세어 시작 위치를 찾고, 그 위치부터 끝까지 출력
+ * 읽는 블록 수는 파일 크기가 아니라 출력할 라인 수에 비례
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param inode_num 파일의 inode 번호 (블록 맵 캐시 키)
+ * @param inode 파일의 inode 구조체 포인터
+ * @param tail_lines 출력할 라인 수 (1 이상)
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+int	print_file_tail(Ext2Context *ctx,
+				   unsigned int inode_num,
+				   struct my_ext2_inode *inode,
+				   int tail_lines)
+{
+	unsigned long long file_size = inode->i_size;
+	unsigned int block_size = ctx->block_size;
+	int result = 0;
+
+	if (file_size == 0 || tail_lines <= 0) {
+		return 0;
+	}
+
+	unsigned char *scratch = alloc_block_scratch(ctx);
+	unsigned char *zeros = (unsigned char *)calloc(1, block_size);
+	if ((ctx->map == NULL && scratch == NULL) || zeros == NULL) {
+		free(scratch);
+		free(zeros);
+		return -1;
+	}
+
+	BlockMapIter it;
+	block_map_init_cached(&it, ctx, inode_num, inode);
+
+	// 끝에서부터 개행을 세어 시작 위치 찾기
+	// 마지막 바이트가 개행이면 마지막 줄의 끝이므로 세지 않음 (tail과 같은 동작)
+	unsigned int last_block = (unsigned int)((file_size - 1) / block_size);
+	unsigned long long scan_end = file_size;
+	unsigned long long start = 0;
+	unsigned long long remaining = (unsigned long long)tail_lines;
+	for (unsigned int logical = last_block; ; logical--) {
+		unsigned long long block_start = (unsigned long long)logical * block_size;
+		const unsigned char *data = read_file_block(ctx, &it, logical, scratch, zeros);
+		if (data == NULL) {
 			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Failed to read indirect block %u\n", inode->i_block[EXT2_IND_BLOCK]);
+				fprintf(stderr, "Failed to read logical block %u\n", logical);
 			#endif
-			free(indirect_blocks);
-			free(buffer);
-			return -1;
+			result = -2;
+			break;
 		}
-		
-		// 간접 블록의 각 블록 번호에 대해 처리
-		unsigned int ptrs_per_block = block_size / sizeof(unsigned int);
-		for (unsigned int i = 0; i < ptrs_per_block; i++) {
-			if (indirect_blocks[i] == 0 || 
-				total_printed >= inode->i_size ||
-				(line_count > 0 && line_printed >= line_count)) {
-				break;
-			}
-			
-			if (read_data_block(fd, sb, indirect_blocks[i], buffer) < 0) {
-				#ifdef DEBUG_PRINT
-					fprintf(stderr, "Failed to read data block %u\n", indirect_blocks[i]);
-				#endif
-				continue;
-			}
-			
-			// 이 블록에서 출력할 바이트 수 계산
-			unsigned int bytes_to_print = 
-				(total_printed + block_size > inode->i_size) ? 
-				(inode->i_size - total_printed) : block_size;
-			
-			if (line_count <= 0) {
-				write(STDOUT_FILENO, buffer, bytes_to_print);
-				total_printed += bytes_to_print;
-			} else {
-				for (unsigned int j = 0; j < bytes_to_print && line_printed < line_count; j++) {
-					putchar(buffer[j]);
-					total_printed++;
-					
-					if (buffer[j] == '\n') {
-						line_printed++;
-						if (line_printed >= line_count) {
-							break;
-						}
-					}
-				}
-			}
+
+		size_t len = (size_t)(scan_end - block_start);
+		if (logical == last_block && data[len - 1] == '\n') {
+			len--;
+			scan_end--;
 		}
-		
-		free(indirect_blocks);
-	}
-		
-	// 이중 간접 블록 처리
-	if (total_printed < inode->i_size && 
-		(line_count <= 0 || line_printed < line_count) &&
-		inode->i_block[EXT2_DIND_BLOCK] != 0) {
-		
-		// 이중 간접 블록 읽기
-		unsigned int *dind_blocks = (unsigned int *)malloc(block_size);
-		
-		if (read_data_block(fd, sb, inode->i_block[EXT2_DIND_BLOCK], (unsigned char *)dind_blocks) < 0) {
-			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Failed to read double indirect block %u\n", inode->i_block[EXT2_DIND_BLOCK]);
-			#endif
-			free(dind_blocks);
-			free(buffer);
-			return -1;
+
+		size_t pos = newline_rfind(data, len, &remaining);
+		if (remaining == 0) {
+			start = block_start + pos;
+			break;
 		}
-		
-		// 이중 간접 블록 내의 각 간접 블록 처리
-		unsigned int ptrs_per_block = block_size / sizeof(unsigned int);
-		for (unsigned int i = 0; i < ptrs_per_block; i++) {
-			if (dind_blocks[i] == 0 || 
-				total_printed >= inode->i_size ||
-				(line_count > 0 && line_printed >= line_count)) {
-				break;
-			}
-			
-			unsigned int *indirect_blocks = (unsigned int *)malloc(block_size);
-			
-			if (read_data_block(fd, sb, dind_blocks[i], (unsigned char *)indirect_blocks) < 0) {
-				#ifdef DEBUG_PRINT
-					fprintf(stderr, "Failed to read indirect block %u\n", dind_blocks[i]);
-				#endif
-				free(indirect_blocks);
-				continue;
-			}
-			
-			// 간접 블록 내의 각 데이터 블록 처리
-			for (unsigned int j = 0; j < ptrs_per_block; j++) {
-				if (indirect_blocks[j] == 0 || 
-					total_printed >= inode->i_size ||
-					(line_count > 0 && line_printed >= line_count)) {
-					break;
-				}
-				
-				if (read_data_block(fd, sb, indirect_blocks[j], buffer) < 0) {
-					#ifdef DEBUG_PRINT
-						fprintf(stderr, "Failed to read data block %u\n", indirect_blocks[j]);
-					#endif
-					continue;
-				}
-				
-				unsigned int bytes_to_print = 
-					(total_printed + block_size > inode->i_size) ? 
-					(inode->i_size - total_printed) : block_size;
-				
-				if (line_count <= 0) {
-					write(STDOUT_FILENO, buffer, bytes_to_print);
-					total_printed += bytes_to_print;
-				} else {
-					for (unsigned int k = 0; k < bytes_to_print && line_printed < line_count; k++) {
-						putchar(buffer[k]);
-						total_printed++;
-						
-						if (buffer[k] == '\n') {
-							line_printed++;
-							if (line_printed >= line_count) {
-								break;
-							}
-						}
-					}
-				}
-			}
-			
-			free(indirect_blocks);
+		if (logical == 0) {
+			break;
 		}
-		
-		free(dind_blocks);
+		scan_end = block_start;
 	}
-		
-	// 삼중 간접 블록 처리
-	if (total_printed < inode->i_size && 
-		(line_count <= 0 || line_printed < line_count) &&
-		inode->i_block[EXT2_TIND_BLOCK] != 0) {
-		
-		// 삼중 간접 블록 읽기
-		unsigned int *tind_blocks = (unsigned int *)malloc(block_size);
-		
-		if (read_data_block(fd, sb, inode->i_block[EXT2_TIND_BLOCK], (unsigned char *)tind_blocks) < 0) {
-			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Failed to read triple indirect block %u\n", inode->i_block[EXT2_TIND_BLOCK]);
-			#endif
-			free(tind_blocks);
-			free(buffer);
-			return -1;
-		}
-		
-		// 삼중 간접 블록 내의 각 이중 간접 블록 처리
-		unsigned int ptrs_per_block = block_size / sizeof(unsigned int);
-		for (unsigned int i = 0; i < ptrs_per_block; i++) {
-			if (tind_blocks[i] == 0 || 
-				total_printed >= inode->i_size ||
-				(line_count > 0 && line_printed >= line_count)) {
+
+	// 시작 위치부터 파일 끝까지 앞쪽으로 출력
+	if (result == 0) {
+		out_buf_flush(&ctx->out);
+		for (unsigned int logical = (unsigned int)(start / block_size); logical <= last_block; logical++) {
+			unsigned long long block_start = (unsigned long long)logical * block_size;
+			const unsigned char *data = read_file_block(ctx, &it, logical, scratch, zeros);
+			if (data == NULL) {
+				result = -3;
 				break;
 			}
-			
-			// 이중 간접 블록 읽기
-			unsigned int *dind_blocks = (unsigned int *)malloc(block_size);
-			
-			if (read_data_block(fd, sb, tind_blocks[i], (unsigned char *)dind_blocks) < 0) {
-				#ifdef DEBUG_PRINT
-					fprintf(stderr, "Failed to read double indirect block %u\n", tind_blocks[i]);
-				#endif
-				free(dind_blocks);
-				continue;
-			}
-			
-			// 이중 간접 블록 내의 각 간접 블록 처리
-			for (unsigned int j = 0; j < ptrs_per_block; j++) {
-				if (dind_blocks[j] == 0 || 
-					total_printed >= inode->i_size ||
-					(line_count > 0 && line_printed >= line_count)) {
-					break;
-				}
-				
-				// 간접 블록 읽기
-				unsigned int *indirect_blocks = (unsigned int *)malloc(block_size);
-				
-				if (read_data_block(fd, sb, dind_blocks[j], (unsigned char *)indirect_blocks) < 0) {
-					#ifdef DEBUG_PRINT
-						fprintf(stderr, "Failed to read indirect block %u\n", dind_blocks[j]);
-					#endif
-					free(indirect_blocks);
-					continue;
-				}
-				
-				// 간접 블록 내의 각 데이터 블록 처리
-				for (unsigned int k = 0; k < ptrs_per_block; k++) {
-					if (indirect_blocks[k] == 0 || 
-						total_printed >= inode->i_size ||
-						(line_count > 0 && line_printed >= line_count)) {
-						break;
-					}
-					
-					// 데이터 블록 읽기
-					if (read_data_block(fd, sb, indirect_blocks[k], buffer) < 0) {
-						#ifdef DEBUG_PRINT
-							fprintf(stderr, "Failed to read data block %u\n", indirect_blocks[k]);
-						#endif
-						continue;
-					}
-					
-					// 이 블록에서 출력할 바이트 수 계산
-					unsigned int bytes_to_print = 
-						(total_printed + block_size > inode->i_size) ? 
-						(inode->i_size - total_printed) : block_size;
-					
-					if (line_count <= 0) {
-						// 라인 수 제한 없이 모든 내용 출력
-						write(STDOUT_FILENO, buffer, bytes_to_print);
-						total_printed += bytes_to_print;
-					} else {
-						// 특정 라인 수만 출력
-						for (unsigned int m = 0; m < bytes_to_print && line_printed < line_count; m++) {
-							putchar(buffer[m]);
-							total_printed++;
-							
-							if (buffer[m] == '\n') {
-								line_printed++;
-								if (line_printed >= line_count) {
-									break;
-								}
-							}
-						}
-					}
-				}
-				
-				free(indirect_blocks);
+
+			size_t from = start > block_start ? (size_t)(start - block_start) : 0;
+			size_t to = file_size - block_start < block_size ? (size_t)(file_size - block_start) : block_size;
+			if (out_buf_write(&ctx->out, data + from, to - from) < 0) {
+				result = -4;
+				break;
 			}
-			
-			free(dind_blocks);
 		}
-		
-		free(tind_blocks);
 	}
-		
-	free(buffer);
-	return 0;
+	if (out_buf_flush(&ctx->out) < 0 && result == 0) {
+		result = -5;
+	}
+
+	block_map_destroy(&it);
+	free(scratch);
+	free(zeros);
+	return result;
 }
 
 /**
  * print 명령어 구현 함수
  * 
+ * @param ctx 이미지 컨텍스트 포인터
  * @param cmd 명령어 구조체 포인터
  */
-void	print(Command *cmd)
+void	print(Ext2Context *ctx, Command *cmd)
 {
-	int fd = open(img_path, O_RDONLY);
-		
-	struct my_ext2_super_block sb;
-	if (read_super_block(fd, &sb) < 0) {
-		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error reading superblock\n");
-		#endif
-		close(fd);
-		return;
-	}
-		
-	// 블록 그룹 디스크립터 읽기
-	int block_size = get_block_size(&sb);
-	int block_groups_count = (sb.s_blocks_count + sb.s_blocks_per_group - 1) 
-							/ sb.s_blocks_per_group;
-		
-	int gdt_size = block_groups_count * sizeof(struct my_ext2_group_desc);
-	struct my_ext2_group_desc *gd = (struct my_ext2_group_desc *)malloc(gdt_size);
-	if (!gd) {
-		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error allocating memory for group descriptors\n");
-		#endif
-		close(fd);
-		return;
-	}
-		
-	off_t gdt_offset = (sb.s_first_data_block + 1) * block_size;
-	if (lseek(fd, gdt_offset, SEEK_SET) != gdt_offset) {
+	// 경로 상의 디렉토리만 읽어 inode를 찾음 (".", ".."는 디스크의 엔트리를 따라감)
+	unsigned int inode_num = path_to_inode(ctx, cmd->path);
+	if (inode_num == 0) {
 		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error seeking to group descriptor table\n");
+			fprintf(stderr, "Error: '%s' not found\n", cmd->path);
 		#endif
-		free(gd);
-		close(fd);
+		help_all();
 		return;
 	}
 		
-	if (read(fd, gd, gdt_size) != gdt_size) {
-		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error reading group descriptor table\n");
-		#endif
-		free(gd);
-		close(fd);
-		return;
-	}
-		
-	// 루트 디렉토리부터 시작하는 디렉토리 트리 구축
-	DirTreeNode *root = create_tree_node(".", EXT2_ROOT_INO, S_IFDIR, 0, 0755);
-	if (!root) {
-		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error creating directory tree\n");
-		#endif
-		free(gd);
-		close(fd);
-		return;
-	}
-		
-	// 루트 디렉토리 inode 정보 읽기
-	struct my_ext2_inode root_inode;
-	if (read_inode(fd, EXT2_ROOT_INO, &sb, gd, &root_inode) < 0) {
+	// 파일 inode 정보 읽기
+	struct my_ext2_inode file_inode;
+	if (read_inode(ctx, inode_num, &file_inode) < 0) {
 		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error reading root directory inode\n");
+			fprintf(stderr, "Error: Failed to read file inode\n");
 		#endif
-		free_tree_node(root);
-		free(gd);
-		close(fd);
 		return;
 	}
 		
-	//디렉토리 트리 구축 (재귀적으로)
-	read_directory_entries(fd, &sb, gd, EXT2_ROOT_INO, root, 1); // 1은 재귀적으로 구축
-		
-	char path_copy[MAX_PATH];
-	strncpy(path_copy, cmd->path, MAX_PATH - 1);
-	path_copy[MAX_PATH - 1] = '\0';
-		
-	// 경로 끝의 슬래시 제거
-	size_t path_len = strlen(path_copy);
-	if (path_len > 1 && path_copy[path_len - 1] == '/') {
-		path_copy[path_len - 1] = '\0';
-	}
-		
-	// 경로 탐색을 위한 노드 스택 (최대 깊이를 1024으로 가정)
-	DirTreeNode *node_stack[1024];
-	int stack_top = 0;
-		
-	// 시작 노드 설정 (절대 경로는 루트부터, 상대 경로는 현재 디렉토리부터)
-	DirTreeNode *current = root;
-	node_stack[stack_top++] = current; // 루트 노드 스택에 푸시
-		
-	// 경로 정규화
-	char *path_ptr = path_copy;
-		
-	// 절대 경로인 경우
-	if (path_copy[0] == '/') {
-		path_ptr++; // '/' 건너뛰기
-	} 
-	// "./"로 시작하는 경우 (현재 디렉토리)
-	else if (strncmp(path_copy, "./", 2) == 0) {
-		path_ptr += 2; // "./" 건너뛰기
-	}
-		
-	// 경로 토큰 먼저 추출 (처리 전에 모든 토큰 확인)
-	char *tokens[MAX_PATH] = {0};
-	int token_count = 0;
-	char *saveptr;
-	char *token = strtok_r(path_ptr, "/", &saveptr);
-		
-	while (token != NULL && token_count < MAX_PATH) {
-		tokens[token_count++] = token;
-		token = strtok_r(NULL, "/", &saveptr);
-	}
-		
-	// 토큰 처리
-	for (int i = 0; i < token_count; i++) {
-		token = tokens[i];
-		
-		// "." 토큰은 현재 디렉토리를 의미하므로 무시
-		if (strcmp(token, ".") == 0) {
-			continue;
-		}
-		
-		// ".." 토큰은 상위 디렉토리를 의미
-		if (strcmp(token, "..") == 0) {
-			// 스택이 비어있지 않고, 현재 노드가 루트가 아닌 경우에만 상위로 이동
-			if (stack_top > 1) {
-				stack_top--; // 현재 노드를 스택에서 팝
-				current = node_stack[stack_top - 1]; // 이전 노드가 현재 노드가 됨
-			}
-			// 루트 디렉토리에서의 ".."는 여전히 루트를 가리킴
-			continue;
-		}
-		
-		// 마지막 토큰이 아니라면 현재 노드가 디렉토리인지 확인
-		if (i < token_count - 1 && !S_ISDIR(current->file_type)) {
-			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Error: '%s' is not a directory in the path\n", current->name);
-			#endif
-			help_all();
-			free_tree_node(root);
-			free(gd);
-			close(fd);
-			return;
-		}
-		
-		int found = 0;
-		
-		// 현재 디렉토리의 자식 노드 중에서 찾기
-		DirTreeNode *child = current->first_child;
-		while (child != NULL) {
-			if (strcmp(child->name, token) == 0) {
-				current = child;
-				node_stack[stack_top++] = current; // 새 노드를 스택에 푸시
-				found = 1;
-				break;
-			}
-			child = child->next_sibling;
-		}
-		
-		if (!found) {
-			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Error: '%s' not found in '%s'\n", token, path_copy);
-			#endif
-			help_all();
-			free_tree_node(root);
-			free(gd);
-			close(fd);
-			return;
-		}
-		
-		// 마지막 토큰이 아니라면 찾은 노드가 디렉토리인지 확인
-		if (i < token_count - 1 && !S_ISDIR(current->file_type)) {
-			#ifdef DEBUG_PRINT
-				fprintf(stderr, "Error: '%s' is not a directory\n", token);
-			#endif
-			help_all();
-			free_tree_node(root);
-			free(gd);
-			close(fd);
-			return;
-		}
-	}
-		
 	// 파일인지 확인
-	if (S_ISDIR(current->file_type)) {
+	if (S_ISDIR(file_inode.i_mode)) {
 		fprintf(stdout, "Error: '%s' is not file\n", cmd->path);
-		free_tree_node(root);
-		free(gd);
-		close(fd);
 		return;
 	}
 		
-	// 파일 inode 정보 읽기
-	struct my_ext2_inode file_inode;
-	if (read_inode(fd, current->inode_num, &sb, gd, &file_inode) < 0) {
-		#ifdef DEBUG_PRINT
-			fprintf(stderr, "Error: Failed to read file inode\n");
-		#endif
-		free_tree_node(root);
-		free(gd);
-		close(fd);
-		return;
+	// 파일 내용 출력 (-t면 마지막 라인들만, -o/-c면 지정한 바이트 구간만, 내용 읽기도 render 단계로 잡음)
+	unsigned long long phase_start = stats_now();
+	int result;
+	if (cmd->options & PRINT_OPT_T) {
+		result = print_file_tail(ctx, inode_num, &file_inode, cmd->extra_param);
+	} else if (cmd->options & (PRINT_OPT_O | PRINT_OPT_C)) {
+		unsigned long long length = (cmd->options & PRINT_OPT_C) ? cmd->range_length : file_inode.i_size;
+		result = print_file_range(ctx, inode_num, &file_inode, cmd->range_offset, length, cmd->extra_param);
+	} else {
+		result = print_file_content(ctx, inode_num, &file_inode, cmd->extra_param);
+	}
+	stats_phase_add(STAT_PHASE_RENDER, phase_start);
+
+	// 내용 일부는 이미 출력되었을 수 있으므로 오류는 표준 에러로 알림
+	if (result < 0) {
+		fprintf(stderr, "Error: failed to read '%s'\n", cmd->path);
 	}
-		
-	// 파일 내용 출력
-	print_file_content(fd, &sb, &file_inode, cmd->extra_param);
-		
-	// 메모리 해제
-	free_tree_node(root);
-	free(gd);
-	close(fd);
 }
 
 // /**
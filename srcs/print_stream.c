@@ -0,0 +1,591 @@
+#include "ssu_ext2.h"
+
+/**
+ * 라인 수 제한이 있는 출력 함수
+ * 벡터화된 개행 탐색으로 제한에 도달하는 위치를 찾고, 그 위치까지를 한 번에 공유 출력 버퍼로 복사
+ *
+ * @param ps 출력 스트림 포인터
+ * @param data 출력할 데이터
+ * @param len 데이터 길이
+ * @return 성공 시 0, 실패 시 -1
+ */
+static int	emit_lines(PrintStream *ps, const unsigned char *data, size_t len)
+{
+	unsigned long long remaining = (unsigned long long)(ps->line_count - ps->line_printed);
+	size_t cut = newline_find(data, len, &remaining);
+
+	ps->line_printed = ps->line_count - (int)remaining;
+	if (remaining == 0) {
+		ps->done = true;
+	}
+	return out_buf_write(&ps->ctx->out, data, cut);
+}
+
+/**
+ * 데이터를 바로 출력하는 함수 (링을 거치지 않음, 매핑된 이미지에서 사용)
+ *
+ * @param ps 출력 스트림 포인터
+ * @param data 출력할 데이터
+ * @param len 데이터 길이
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+static int	emit_direct(PrintStream *ps, const unsigned char *data, size_t len)
+{
+	if (ps->line_count > 0) {
+		return emit_lines(ps, data, len);
+	}
+	return write_all(STDOUT_FILENO, data, len) < 0 ? -1 : 0;
+}
+
+/**
+ * 링 슬롯 포인터를 구하는 함수
+ *
+ * @param ps 출력 스트림 포인터
+ * @param slot 슬롯 인덱스 (슬롯 수로 나눈 나머지를 사용)
+ * @return 슬롯 시작 주소
+ */
+static unsigned char	*ring_slot(PrintStream *ps, unsigned int slot)
+{
+	return ps->ring + (size_t)(slot % ps->slot_count) * ps->slot_bytes;
+}
+
+/**
+ * 링에서 다음에 채울 수 있는 공간을 iovec 배열로 만드는 함수
+ * 마지막으로 채운 슬롯에 남은 공간부터 시작해서 빈 슬롯들을 순서대로 이어 붙임
+ *
+ * @param ps 출력 스트림 포인터
+ * @param iov 결과 iovec 배열 (슬롯 수 + 1개 이상)
+ * @param max_bytes 최대 바이트 수
+ * @return iovec 개수
+ */
+static int	ring_reserve(PrintStream *ps, struct iovec *iov, size_t max_bytes)
+{
+	int iov_count = 0;
+	unsigned int slot = ps->head + ps->count;
+
+	// 마지막 슬롯에 남은 공간
+	if (ps->count > 0) {
+		unsigned int last = slot - 1;
+		size_t used = ps->slot_len[last % ps->slot_count];
+		if (used < ps->slot_bytes && max_bytes > 0) {
+			size_t len = ps->slot_bytes - used;
+			if (len > max_bytes) {
+				len = max_bytes;
+			}
+			iov[iov_count].iov_base = ring_slot(ps, last) + used;
+			iov[iov_count].iov_len = len;
+			iov_count++;
+			max_bytes -= len;
+		}
+	}
+
+	// 빈 슬롯
+	for (unsigned int i = ps->count; i < ps->slot_count && max_bytes > 0; i++, slot++) {
+		size_t len = ps->slot_bytes < max_bytes ? ps->slot_bytes : max_bytes;
+		iov[iov_count].iov_base = ring_slot(ps, slot);
+		iov[iov_count].iov_len = len;
+		iov_count++;
+		max_bytes -= len;
+	}
+
+	return iov_count;
+}
+
+/**
+ * 링에 bytes 바이트가 채워졌음을 기록하는 함수 (ring_reserve로 얻은 공간 순서대로)
+ *
+ * @param ps 출력 스트림 포인터
+ * @param bytes 채워진 바이트 수
+ */
+static void	ring_commit(PrintStream *ps, size_t bytes)
+{
+	// 마지막 슬롯의 남은 공간부터 채움
+	if (ps->count > 0) {
+		unsigned int last = (ps->head + ps->count - 1) % ps->slot_count;
+		size_t room = ps->slot_bytes - ps->slot_len[last];
+		size_t len = room < bytes ? room : bytes;
+		ps->slot_len[last] += len;
+		bytes -= len;
+	}
+
+	while (bytes > 0) {
+		unsigned int slot = (ps->head + ps->count) % ps->slot_count;
+		size_t len = ps->slot_bytes < bytes ? ps->slot_bytes : bytes;
+		ps->slot_len[slot] = len;
+		ps->slot_state[slot] = SLOT_READY;
+		ps->count++;
+		bytes -= len;
+	}
+}
+
+/**
+ * 링에 남은 공간이 있는지 확인하는 함수
+ *
+ * @param ps 출력 스트림 포인터
+ * @return 남은 바이트 수
+ */
+static size_t	ring_room(PrintStream *ps)
+{
+	size_t room = (size_t)(ps->slot_count - ps->count) * ps->slot_bytes;
+
+	if (ps->count > 0) {
+		unsigned int last = (ps->head + ps->count - 1) % ps->slot_count;
+		room += ps->slot_bytes - ps->slot_len[last];
+	}
+	return room;
+}
+
+/**
+ * 링 앞쪽부터 연속으로 준비된(SLOT_READY) 슬롯들을 출력하고 비우는 함수
+ * 전체 출력이면 준비된 슬롯을 writev 한 번으로 출력
+ *
+ * @param ps 출력 스트림 포인터
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+static int	ring_drain(PrintStream *ps)
+{
+	unsigned int ready = 0;
+	while (ready < ps->count && ps->slot_state[(ps->head + ready) % ps->slot_count] == SLOT_READY) {
+		ready++;
+	}
+	if (ready == 0) {
+		return 0;
+	}
+
+	if (ps->line_count > 0) {
+		for (unsigned int i = 0; i < ready && !ps->done; i++) {
+			unsigned int slot = ps->head + i;
+			if (emit_lines(ps, ring_slot(ps, slot), ps->slot_len[slot % ps->slot_count]) < 0) {
+				return -1;
+			}
+		}
+	} else {
+		struct iovec *iov = ps->iov;
+		size_t total = 0;
+		for (unsigned int i = 0; i < ready; i++) {
+			unsigned int slot = ps->head + i;
+			iov[i].iov_base = ring_slot(ps, slot);
+			iov[i].iov_len = ps->slot_len[slot % ps->slot_count];
+			total += iov[i].iov_len;
+		}
+
+		ssize_t written = writev(STDOUT_FILENO, iov, (int)ready);
+		if (written < 0 && errno != EINTR) {
+			return -1;
+		}
+		if (written < 0) {
+			written = 0;
+		}
+
+		// 일부만 출력되었으면 나머지를 이어서 출력
+		if ((size_t)written < total) {
+			size_t skip = (size_t)written;
+			for (unsigned int i = 0; i < ready; i++) {
+				if (skip >= iov[i].iov_len) {
+					skip -= iov[i].iov_len;
+					continue;
+				}
+				if (write_all(STDOUT_FILENO, (const unsigned char *)iov[i].iov_base + skip,
+							  iov[i].iov_len - skip) < 0) {
+					return -1;
+				}
+				skip = 0;
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < ready; i++) {
+		ps->slot_state[(ps->head + i) % ps->slot_count] = SLOT_FREE;
+		ps->slot_len[(ps->head + i) % ps->slot_count] = 0;
+	}
+	ps->head = (ps->head + ready) % ps->slot_count;
+	ps->count -= ready;
+	return 0;
+}
+
+/**
+ * io_uring 완료 큐에서 완료된 읽기 하나를 처리하는 함수
+ *
+ * @param ps 출력 스트림 포인터
+ * @param wait 완료된 읽기가 없으면 기다릴지 여부
+ * @return 처리했으면 1, 없으면 0, 실패 시 음수 값
+ */
+static int	uring_complete_one(PrintStream *ps, bool wait)
+{
+	unsigned long long slot;
+	int res;
+
+	int reaped = uring_reap(&ps->ctx->uring, wait, &slot, &res);
+	if (reaped <= 0) {
+		return reaped;
+	}
+
+	ps->inflight--;
+	ps->slot_state[slot] = SLOT_READY;
+	if (res < 0 || (size_t)res != ps->slot_len[slot]) {
+		#ifdef DEBUG_PRINT
+			fprintf(stderr, "io_uring read failed (res=%d, expected %zu)\n", res, ps->slot_len[slot]);
+		#endif
+		ps->failed = true;
+		return -1;
+	}
+	return 1;
+}
+
+/**
+ * 비어 있는 슬롯 하나를 링 뒤쪽에 확보하는 함수
+ * 링이 가득 차 있으면 가장 앞 슬롯의 읽기가 끝날 때까지 기다렸다가 출력해서 비움
+ *
+ * @param ps 출력 스트림 포인터
+ * @return 슬롯 인덱스, 실패 시 음수 값
+ */
+static int	ring_acquire(PrintStream *ps)
+{
+	while (ps->count == ps->slot_count) {
+		if (ring_drain(ps) < 0) {
+			return -1;
+		}
+		// 가장 앞 슬롯이 아직 읽는 중이면 완료를 기다림
+		if (ps->count == ps->slot_count && ps->use_uring) {
+			if (uring_submit(&ps->ctx->uring) < 0 || uring_complete_one(ps, true) < 0) {
+				return -2;
+			}
+		}
+	}
+
+	unsigned int slot = (ps->head + ps->count) % ps->slot_count;
+	ps->count++;
+	return (int)slot;
+}
+
+/**
+ * 출력 스트림 초기화 함수
+ * pread 경로에서는 정렬된 링 버퍼를 할당 (매핑된 이미지는 매핑을 직접 출력하므로 링 불필요)
+ * 세션에 io_uring이 준비되어 있으면 큐 깊이만큼 슬롯을 만들고 슬롯마다 읽기 요청 하나를 띄움
+ *
+ * @param ps 초기화할 출력 스트림 포인터
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param file_size 파일 크기 (i_size)
+ * @param line_count 출력할 라인 수 (0 또는 음수면 전체 출력)
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+int	print_stream_init(PrintStream *ps, Ext2Context *ctx,
+					  unsigned long long file_size, int line_count)
+{
+	memset(ps, 0, sizeof(PrintStream));
+	ps->ctx = ctx;
+	ps->file_size = file_size;
+	ps->line_count = line_count;
+	ps->use_uring = (ctx->map == NULL && ctx->uring.fd >= 0);
+	ps->slot_count = ps->use_uring ? ctx->config.queue_depth : PRINT_RING_SLOTS;
+	clock_gettime(CLOCK_MONOTONIC, &ps->start);
+
+	// 슬롯 크기는 블록 크기의 배수
+	ps->slot_bytes = PRINT_SLOT_BYTES - (PRINT_SLOT_BYTES % ctx->block_size);
+	if (ps->slot_bytes == 0) {
+		ps->slot_bytes = ctx->block_size;
+	}
+
+	if (ctx->map == NULL) {
+		void *ring = NULL;
+		if (posix_memalign(&ring, PRINT_RING_ALIGN, (size_t)ps->slot_count * ps->slot_bytes) != 0) {
+			return -1;
+		}
+		ps->ring = (unsigned char *)ring;
+		ps->slot_len = (size_t *)calloc(ps->slot_count, sizeof(size_t));
+		ps->slot_state = (unsigned char *)calloc(ps->slot_count, sizeof(unsigned char));
+		ps->slot_iov = (struct iovec *)calloc(ps->slot_count, sizeof(struct iovec));
+		ps->iov = (struct iovec *)calloc(ps->slot_count + 1, sizeof(struct iovec));
+		if (ps->slot_len == NULL || ps->slot_state == NULL || ps->slot_iov == NULL || ps->iov == NULL) {
+			print_stream_destroy(ps);
+			return -2;
+		}
+	}
+
+	// 이전에 쌓인 출력(프롬프트 등)을 먼저 내보냄 (전체 출력은 버퍼를 거치지 않고 바로 write)
+	out_buf_flush(&ctx->out);
+	return 0;
+}
+
+/**
+ * 출력 스트림 정리 함수
+ * 아직 끝나지 않은 io_uring 읽기가 있으면 버퍼를 해제하기 전에 모두 기다림
+ *
+ * @param ps 정리할 출력 스트림 포인터
+ */
+void	print_stream_destroy(PrintStream *ps)
+{
+	if (ps->use_uring) {
+		uring_submit(&ps->ctx->uring);
+		while (ps->inflight > 0 && uring_complete_one(ps, true) != 0) {
+			;
+		}
+	}
+	free(ps->ring);
+	free(ps->slot_len);
+	free(ps->slot_state);
+	free(ps->slot_iov);
+	free(ps->iov);
+	ps->ring = NULL;
+	ps->slot_len = NULL;
+	ps->slot_state = NULL;
+	ps->slot_iov = NULL;
+	ps->iov = NULL;
+}
+
+/**
+ * 링에 쌓인 데이터를 모두 출력하는 함수 (진행 중인 io_uring 읽기는 끝날 때까지 기다림)
+ *
+ * @param ps 출력 스트림 포인터
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+int	print_stream_flush(PrintStream *ps)
+{
+	if (ps->ring == NULL) {
+		return 0;
+	}
+
+	if (ps->use_uring && uring_submit(&ps->ctx->uring) < 0) {
+		return -1;
+	}
+
+	while (ps->count > 0 && !ps->done) {
+		if (ring_drain(ps) < 0) {
+			return -2;
+		}
+		if (ps->count > 0 && ps->use_uring && uring_complete_one(ps, true) < 0) {
+			return -3;
+		}
+	}
+	return ps->failed ? -4 : 0;
+}
+
+/**
+ * 물리적으로 연속된 블록 구간을 io_uring으로 읽는 함수
+ * 구간을 슬롯 크기로 나눠 슬롯마다 읽기 요청을 준비하고, 링이 가득 차면 한꺼번에 제출
+ * 이후에는 앞 슬롯이 완료되는 대로 출력하고 빈 슬롯에 다음 읽기를 채움
+ *
+ * @param ps 출력 스트림 포인터
+ * @param offset 이미지 내 시작 위치
+ * @param bytes 읽을 바이트 수
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+static int	uring_run(PrintStream *ps, off_t offset, unsigned long long bytes)
+{
+	while (bytes > 0 && !ps->done) {
+		int slot = ring_acquire(ps);
+		if (slot < 0) {
+			return -1;
+		}
+
+		size_t len = bytes < ps->slot_bytes ? (size_t)bytes : ps->slot_bytes;
+		ps->slot_len[slot] = len;
+		ps->slot_state[slot] = SLOT_INFLIGHT;
+		ps->slot_iov[slot].iov_base = ring_slot(ps, (unsigned int)slot);
+		ps->slot_iov[slot].iov_len = len;
+		if (uring_prep_readv(&ps->ctx->uring, ps->ctx->fd, &ps->slot_iov[slot], offset, (unsigned long long)slot) < 0) {
+			// 제출 큐가 가득 찼으면 먼저 제출하고 다시 시도
+			if (uring_submit(&ps->ctx->uring) < 0 ||
+				uring_prep_readv(&ps->ctx->uring, ps->ctx->fd, &ps->slot_iov[slot], offset, (unsigned long long)slot) < 0) {
+				return -2;
+			}
+		}
+
+		ps->inflight++;
+		ps->reads++;
+		ps->inflight_sum += ps->inflight;
+		if (ps->inflight > ps->inflight_max) {
+			ps->inflight_max = ps->inflight;
+		}
+		ps->bytes_read += len;
+		ps->position += len;
+		STAT_ADD(blocks_read, (len + ps->ctx->block_size - 1) / ps->ctx->block_size);
+		STAT_ADD(bytes_read, len);
+		offset += (off_t)len;
+		bytes -= len;
+	}
+
+	// 제출은 링이 가득 찼을 때 (ring_acquire) 또는 print_stream_flush에서 한꺼번에 함
+	// 라인 수 제한이 있어도 링은 가득 채운 채로 두고, ring_acquire가 앞 슬롯이 끝나는 순서대로 개행을 확인
+	// 제한에 도달하면 (done) 더 이상 읽기를 요청하지 않음
+	return 0;
+}
+
+/**
+ * 물리적으로 연속된 블록 구간을 출력하는 함수
+ * pread 경로에서는 링의 빈 공간을 iovec으로 묶어 preadv 한 번으로 읽고, 링이 차면 출력
+ * 출력 끝(i_size 또는 지정한 구간의 끝)을 넘는 부분은 출력하지 않음
+ *
+ * @param ps 출력 스트림 포인터
+ * @param physical 시작 물리 블록 번호
+ * @param count 연속 블록 수
+ * @param skip 구간 앞에서 건너뛸 바이트 수 (출력 구간이 블록 중간에서 시작할 때)
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+int	print_stream_run(PrintStream *ps, unsigned int physical, unsigned int count, unsigned int skip)
+{
+	Ext2Context *ctx = ps->ctx;
+	unsigned long long bytes = (unsigned long long)count * ctx->block_size - skip;
+	off_t offset = (off_t)physical * ctx->block_size + skip;
+
+	if (ps->position + bytes > ps->file_size) {
+		bytes = ps->file_size - ps->position;
+	}
+
+	// 매핑된 이미지는 복사 없이 매핑을 직접 출력
+	if (ctx->map != NULL) {
+		if ((unsigned long long)offset + bytes > ctx->map_size) {
+			return -1;
+		}
+		ps->position += bytes;
+		ps->bytes_read += bytes;
+		STAT_ADD(blocks_read, (bytes + ctx->block_size - 1) / ctx->block_size);
+		STAT_ADD(bytes_read, bytes);
+		return emit_direct(ps, ctx->map + offset, (size_t)bytes);
+	}
+
+	if (ps->use_uring) {
+		return uring_run(ps, offset, bytes) < 0 ? -2 : 0;
+	}
+
+	while (bytes > 0 && !ps->done) {
+		if (ring_room(ps) == 0 && ring_drain(ps) < 0) {
+			return -2;
+		}
+
+		size_t want = bytes < ring_room(ps) ? (size_t)bytes : ring_room(ps);
+		if (ps->line_count > 0 && want > ps->slot_bytes) {
+			want = ps->slot_bytes;  // 라인 수 제한이 있으면 필요한 만큼만 읽도록 슬롯 단위로 진행
+		}
+		int iov_count = ring_reserve(ps, ps->iov, want);
+
+		ssize_t got = preadv(ctx->fd, ps->iov, iov_count, offset);
+		STAT_ADD(syscalls, 1);
+		if (got <= 0) {
+			if (got < 0 && errno == EINTR) {
+				continue;
+			}
+			#ifdef DEBUG_PRINT
+				fprintf(stderr, "preadv failed at offset %lld\n", (long long)offset);
+			#endif
+			return -3;
+		}
+
+		ring_commit(ps, (size_t)got);
+		offset += got;
+		bytes -= (unsigned long long)got;
+		ps->position += (unsigned long long)got;
+		ps->bytes_read += (unsigned long long)got;
+		ps->reads++;
+		STAT_ADD(blocks_read, ((size_t)got + ctx->block_size - 1) / ctx->block_size);
+		STAT_ADD(bytes_read, (size_t)got);
+		ps->inflight_sum++;
+		ps->inflight_max = 1;
+
+		if (ps->line_count > 0 && ring_drain(ps) < 0) {
+			return -4;
+		}
+	}
+	return 0;
+}
+
+/**
+ * 구멍(hole)을 0으로 채워 출력하는 함수
+ *
+ * @param ps 출력 스트림 포인터
+ * @param len 출력할 0 바이트 수 (i_size를 넘는 부분은 잘라냄)
+ * @return 성공 시 0, 실패 시 음수 값
+ */
+int	print_stream_zero(PrintStream *ps, unsigned long long len)
+{
+	if (ps->position + len > ps->file_size) {
+		len = ps->file_size - ps->position;
+	}
+
+	// 매핑된 이미지는 링이 없으므로 0 버퍼를 반복 출력
+	if (ps->ring == NULL) {
+		unsigned char *zeros = (unsigned char *)calloc(1, ps->slot_bytes);
+		if (zeros == NULL) {
+			return -1;
+		}
+		while (len > 0 && !ps->done) {
+			size_t chunk = len < ps->slot_bytes ? (size_t)len : ps->slot_bytes;
+			if (emit_direct(ps, zeros, chunk) < 0) {
+				free(zeros);
+				return -2;
+			}
+			ps->position += chunk;
+			len -= chunk;
+		}
+		free(zeros);
+		return 0;
+	}
+
+	// io_uring 모드에서는 슬롯 하나를 통째로 0으로 채워 순서를 유지
+	if (ps->use_uring) {
+		while (len > 0 && !ps->done) {
+			int slot = ring_acquire(ps);
+			if (slot < 0) {
+				return -3;
+			}
+			size_t chunk = len < ps->slot_bytes ? (size_t)len : ps->slot_bytes;
+			memset(ring_slot(ps, (unsigned int)slot), 0, chunk);
+			ps->slot_len[slot] = chunk;
+			ps->slot_state[slot] = SLOT_READY;
+			ps->position += chunk;
+			len -= chunk;
+		}
+		return 0;
+	}
+
+	while (len > 0 && !ps->done) {
+		if (ring_room(ps) == 0 && ring_drain(ps) < 0) {
+			return -5;
+		}
+
+		size_t want = len < ring_room(ps) ? (size_t)len : ring_room(ps);
+		int iov_count = ring_reserve(ps, ps->iov, want);
+		for (int i = 0; i < iov_count; i++) {
+			memset(ps->iov[i].iov_base, 0, ps->iov[i].iov_len);
+		}
+
+		ring_commit(ps, want);
+		ps->position += want;
+		len -= want;
+	}
+	return 0;
+}
+
+/**
+ * 읽기 백엔드, 평균/최대 동시 읽기 수, 처리량을 한 줄로 출력하는 함수 (표준 에러)
+ *
+ * @param ps 출력 스트림 포인터
+ */
+void	print_stream_report(PrintStream *ps)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	out_buf_flush(&ps->ctx->out);  // 라인 수 제한 출력이 통계 줄보다 먼저 나오도록
+
+	double seconds = (double)(now.tv_sec - ps->start.tv_sec) +
+					 (double)(now.tv_nsec - ps->start.tv_nsec) / 1e9;
+	double megabytes = (double)ps->bytes_read / (1024.0 * 1024.0);
+	double avg_depth = ps->reads > 0 ? (double)ps->inflight_sum / (double)ps->reads : 0.0;
+
+	const char *backend = "pread";
+	if (ps->ctx->map != NULL) {
+		backend = "mmap";
+	} else if (ps->use_uring) {
+		backend = "io_uring";
+	} else if (ps->ctx->config.use_io_uring) {
+		backend = "pread (io_uring unavailable)";
+	}
+
+	fprintf(stderr, "io: %s, queue depth %.1f avg / %u max, %.2f MB in %.3f s, %.1f MB/s",
+			backend, avg_depth, ps->inflight_max, megabytes, seconds,
+			seconds > 0 ? megabytes / seconds : 0.0);
+	if (ps->line_count > 0) {
+		fprintf(stderr, ", newline scan %s", newline_scan_name());
+	}
+	fprintf(stderr, "\n");
+}
@@ -54,13 +54,13 @@ bool	check_super_magic(char *str)
 		exit(1);
 	}
 
-	lseek(fd, 1024, SEEK_SET);
-
-	if (read(fd, &sb, sizeof(struct my_ext2_super_block)) != sizeof(struct my_ext2_super_block)) {
+	if (pread(fd, &sb, sizeof(struct my_ext2_super_block), 1024) != sizeof(struct my_ext2_super_block)) {
 		fprintf(stdout, "read error\n");
 		exit(1);
 	}
 
+	close(fd);
+
 	//super block 확인
 	if (sb.s_magic == EXT2_SUPER_MAGIC) {
 		return true;
@@ -116,16 +116,17 @@ int	main(int argc, char *argv[])
 {
 	char	*line;
 	char	*imgfile_path;
+	char	*image_arg;
+	Ext2Config config;
 
-	//todo : 에러 처리 
-	if (argc != 2) {
-		printf("Usage Error : ./ssu_ext2 <EXT2_IMAGE>\n");
+	if (!parse_session_options(argc, argv, &config, &image_arg)) {
+		printf("Usage Error : ./ssu_ext2 [OPTION]... <EXT2_IMAGE>\n");
 		exit(0);
 	}
 
-	imgfile_path = get_absolute_path(argv[1]);
+	imgfile_path = get_absolute_path(image_arg);
 	if (!imgfile_path) {
-		printf("Usage Error : ./ssu_ext2 <EXT2_IMAGE>\n");
+		printf("Usage Error : ./ssu_ext2 [OPTION]... <EXT2_IMAGE>\n");
 		exit(0);
 	}
 
@@ -135,24 +136,54 @@ int	main(int argc, char *argv[])
 	}
 	img_path = strdup(imgfile_path);
 
+	// 추적 파일은 프로그램이 끝날 때 기록 (세션의 모든 명령어 포함)
+	if (config.trace_path != NULL && trace_open(config.trace_path) < 0) {
+		printf("Error : cannot open trace file %s\n", config.trace_path);
+		exit(0);
+	}
+
+	//이미지 세션 컨텍스트 생성 (슈퍼블록, 그룹 디스크립터를 한 번만 읽음)
+	Ext2Context ctx;
+	unsigned long long load_start = stats_now();
+	if (open_ext2_context(img_path, &config, &ctx) < 0) {
+		printf("Error : bad file system\n");
+		exit(0);
+	}
+	stats_phase_add(STAT_PHASE_LOAD, load_start);
+
 	Command cmd;
 	while (true) {
 		memset(&cmd, 0, sizeof(Command));
 		line = get_input_line();
 
+		// 명령어 사이에 이미지가 수정되었으면 캐시를 비움 (슈퍼블록 확인 시간도 명령어 통계에 포함)
+		stats_command_begin(&ctx);
+		load_start = stats_now();
+		int refreshed = refresh_ext2_context(&ctx);
+		stats_phase_add(STAT_PHASE_LOAD, load_start);
+
 		if (!strncmp(line, "help", 4)) {
 			help(line);
 		}
 		else if (!strcmp(line, "exit")) {
 			free(line);
+			close_ext2_context(&ctx);
+			if (config.trace_path != NULL && trace_close() < 0) {
+				fprintf(stderr, "trace: failed to write %s\n", config.trace_path);
+			}
 			exit(0);
 		}
+		else if (refreshed < 0 && (!strncmp(line, "tree", 4) || !strncmp(line, "print", 5))) {
+			// 수정된 이미지의 메타데이터를 다시 읽지 못하면 이전 상태로 실행하지 않음
+			fprintf(stderr, "Error: failed to reload the modified image metadata\n");
+		}
 		else if (!strncmp(line, "tree", 4)) {
-			if (parse_tree_command(line, &cmd)) {
+			if (parse_tree_command(&ctx, line, &cmd)) {
 				#ifdef DEBUG_CMD
 					debug_tree_cmd(cmd);
 				#endif
-				tree(&cmd);
+				tree(&ctx, &cmd);
+				stats_command_end(&ctx);
 			}
 		}
 		else if (!strncmp(line, "print", 5)) {
@@ -160,9 +191,13 @@ int	main(int argc, char *argv[])
 				#ifdef DEBUG_CMD
 					debug_print_cmd(cmd);
 				#endif
-				print(&cmd);
+				print(&ctx, &cmd);
+				stats_command_end(&ctx);
 			}
 		}
+		else if (!strncmp(line, "stats", 5)) {
+			stats_command(&ctx, line);
+		}
 		else {
 			help_all();
 		}
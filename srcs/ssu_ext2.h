@@ -13,60 +13,650 @@
 #include <fcntl.h>
 #include <signal.h>
 #include <dirent.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/uio.h>
 
 #include "ext2.h"
 
+// 커널 헤더가 있으면 io_uring 백엔드를 빌드 (liburing 없이 시스템 콜 직접 사용)
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HAVE_IO_URING
+#endif
+#endif
+
 #define MAX_PATH 4096
 #define MAX_FILE_NAME 255
 #define BUFFER_SIZE 4096
 
+#define BLOCK_CACHE_SHARDS 16					// 블록 캐시 샤드 수 (2의 거듭제곱, 16 이하)
+#define DEFAULT_CACHE_BYTES (64UL * 1024 * 1024)	// 기본 블록 캐시 예산
+#define DEFAULT_INODE_CACHE_BYTES (16UL * 1024 * 1024)	// 기본 inode 테이블 캐시 예산
+#define DEFAULT_EXTENT_CACHE_BYTES (4UL * 1024 * 1024)	// 기본 블록 맵(익스텐트) 캐시 예산
+
+#define PRINT_RING_SLOTS 8						// print 출력 링 슬롯 수
+#define PRINT_SLOT_BYTES (512 * 1024)			// print 출력 링 슬롯 하나의 크기
+#define PRINT_RING_ALIGN 4096					// print 출력 링 정렬 단위
+#define DEFAULT_QUEUE_DEPTH 16					// io_uring 기본 큐 깊이
+#define MAX_QUEUE_DEPTH 256						// io_uring 최대 큐 깊이
+#define BLOCK_MAP_PREFETCH 32					// 간접 블록을 미리 읽을 때 한 번에 요청하는 포인터 수
+#define BLOCK_MAP_ERROR 0xFFFFFFFFu				// 블록 맵 조회 실패 (간접 블록을 읽지 못함, 구멍 0과 구분)
+#define ENTRY_LOOKUP_ERROR 0xFFFFFFFFu			// 디렉토리 엔트리 찾기 실패 (읽기 오류, 못 찾음 0과 구분)
+#define OUT_BUF_BYTES (256 * 1024)				// tree/print 공유 출력 버퍼 크기
+#define DENTRY_CACHE_WAYS 4						// 덴트리 캐시 세트당 엔트리 수
+#define DENTRY_CACHE_SETS 4096					// 덴트리 캐시 세트 수 (2의 거듭제곱)
+#define MAX_WALK_THREADS 64						// tree 탐색 최대 스레드 수
+#define WALK_DEQUE_INIT 64						// 작업 덱 초기 용량
+#define DEFAULT_ARENA_CHUNK (1024 * 1024)		// 트리 노드 아레나 기본 청크 크기
+#define ARENA_MIN_CHUNK 4096					// 아레나 최소 청크 크기
+#define ARENA_ALIGN 16							// 아레나 할당 정렬 단위
+#define TREE_NIL 0xFFFFFFFFu					// 없는 노드 인덱스
+#define TREE_NODE_BASE_SHIFT 10					// 노드 세그먼트 k의 크기: 1024 << k 노드
+#define TREE_NODE_SEGS 22						// 노드 세그먼트 수 (32비트 인덱스 전체)
+#define TREE_NAME_BASE_SHIFT 12					// 이름 세그먼트 k의 크기: 4096 << k 바이트
+#define TREE_NAME_SEGS 20						// 이름 세그먼트 수 (32비트 오프셋 전체)
+#define TREE_NODE_CLAIM 256						// 스레드가 한 번에 예약하는 노드 인덱스 수
+#define TREE_NAME_CLAIM 4096					// 스레드가 한 번에 예약하는 이름 풀 바이트 수
+#define TREE_STREAM_INIT_DEPTH 16				// 스트리밍 tree 출력의 깊이별 상태 배열 초기 크기
+#define TREE_PREFIX_INIT_DEPTH 64				// tree 출력 접두사 배열 초기 크기
+
 #define TREE_OPT_R 0x01
 #define TREE_OPT_S 0x02
 #define TREE_OPT_P 0x04
 
+#define STAT_PHASE_LOAD 0						// 슈퍼블록/그룹 디스크립터 읽기
+#define STAT_PHASE_PATH 1						// 경로 탐색 (path_to_inode)
+#define STAT_PHASE_WALK 2						// 디렉토리 읽기, 트리 구축
+#define STAT_PHASE_RENDER 3						// 출력 (print는 내용 읽기 포함)
+#define STAT_PHASES 4
+
+#define STAT_CACHE_BLOCK 0
+#define STAT_CACHE_INODE 1
+#define STAT_CACHE_DENTRY 2
+#define STAT_CACHE_EXTENT 3
+#define STAT_CACHES 4
+
+#define TRACE_BUF_INIT 4096						// 스레드별 추적 버퍼 초기 구간 수
+#define TRACE_MAX_EVENTS (1 << 20)				// 스레드별 최대 추적 구간 수 (넘으면 버리고 개수만 셈)
+
+#define PRINT_OPT_N 0x01
+#define PRINT_OPT_T 0x02
+#define PRINT_OPT_O 0x04
+#define PRINT_OPT_C 0x08
+
 typedef struct command {
 	char	cmd_type[10];
 	char	path[4096];
 	int		options;
 	int		extra_param;
+	unsigned long long	range_offset;	// print -o 시작 바이트 위치
+	unsigned long long	range_length;	// print -c 출력할 바이트 수
 } Command;
 
 /**
- * 디렉토리 트리 노드 구조체 (링크드 리스트 구현)
+ * 디렉토리 트리 노드 구조체 (24바이트, 인덱스로 연결)
+ * 이름은 트리의 이름 풀에 (오프셋, 길이)로 보관하고, 한 디렉토리의 자식들은 연속된 32비트 노드 인덱스 구간에 놓임
  */
 typedef struct dir_tree_node {
-	char name[MAX_FILE_NAME + 1];	  // 파일/디렉토리 이름
-	int inode_num;					 // inode 번호
-	int file_type;					 // 파일 타입 (S_IFDIR, S_IFREG 등)
-	unsigned int size;				 // 파일 크기
-	unsigned int permissions;		  // 권한 정보
-		
-	struct dir_tree_node *first_child; // 첫 번째 자식 노드 (디렉토리인 경우)
-	struct dir_tree_node *next_sibling; // 다음 형제 노드
+	unsigned int inode_num;			// inode 번호
+	unsigned int size;				// 파일 크기
+	unsigned short mode;			// i_mode (파일 타입 + 권한)
+	unsigned short name_len;		// 이름 길이 (루트는 입력 경로 전체)
+	unsigned int name_off;			// 이름 풀 오프셋
+	unsigned int first_child;		// 첫 번째 자식 노드 인덱스 (없으면 TREE_NIL)
+	unsigned int child_count;		// 자식 수 (자식은 first_child부터 연속된 인덱스)
 } DirTreeNode;
 
+/**
+ * 실행 옵션 구조체 (프로그램 인자로 설정)
+ */
+typedef struct ext2_config {
+	bool	use_mmap;			// 이미지를 mmap으로 접근할지 여부
+	size_t	cache_bytes;		// pread 경로의 블록 캐시 예산 (0이면 비활성화)
+	size_t	inode_cache_bytes;	// pread 경로의 inode 테이블 캐시 예산 (0이면 비활성화)
+	size_t	extent_cache_bytes;	// print 블록 맵 캐시 예산 (0이면 비활성화)
+	bool	use_io_uring;		// print 내용 읽기에 io_uring 사용 여부
+	unsigned int queue_depth;	// io_uring 동시 읽기 요청 수
+	unsigned int walk_threads;	// tree -r 디렉토리 탐색 스레드 수 (1이면 단일 스레드)
+	size_t	arena_chunk_bytes;	// tree 노드 아레나 청크 크기
+	bool	arena_stats;		// tree 명령어마다 아레나 최대 사용량 출력 여부
+	bool	tree_stream;		// tree를 트리 구축 없이 엔트리를 읽는 대로 출력할지 여부
+	bool	stats_summary;		// 명령어마다 실행 통계 한 줄 출력 여부
+	const char	*trace_path;	// 추적 이벤트를 기록할 파일 경로 (NULL이면 추적하지 않음)
+} Ext2Config;
+
+/**
+ * 실행 통계 카운터 구조체 (스레드마다 하나, 락 없이 증가)
+ */
+typedef struct stat_counters {
+	unsigned long long blocks_read;		// 이미지에서 가져온 블록 수 (pread, 매핑 참조, io_uring, 캐시 적중 제외)
+	unsigned long long bytes_read;		// 이미지에서 가져온 바이트 수
+	unsigned long long inodes_read;		// read_inode 성공 횟수
+	unsigned long long syscalls;		// 입출력 시스템 콜 수 (pread, preadv, io_uring_enter, madvise/fadvise, write)
+	unsigned long long dirents;			// 디코딩한 디렉토리 엔트리 수
+	unsigned long long nodes;			// 만든 트리 노드 수
+	unsigned long long commands;		// 실행한 명령어 수
+	unsigned long long command_ns;		// 명령어 실행 시간 합
+	unsigned long long phase_ns[STAT_PHASES];	// 단계별 시간 합
+} StatCounters;
+
+/**
+ * 실행 통계 스냅샷 구조체 (모든 스레드의 카운터 합 + 캐시 적중/실패)
+ */
+typedef struct ext2_stats {
+	StatCounters c;
+	unsigned long long cache_hits[STAT_CACHES];
+	unsigned long long cache_misses[STAT_CACHES];
+} Ext2Stats;
+
+/**
+ * 세션 실행 통계 상태 구조체
+ */
+typedef struct stats_session {
+	Ext2Stats base;					// 세션 합계의 기준 (stats reset 시점)
+	Ext2Stats mark;					// 현재 명령어 시작 시점
+	Ext2Stats last;					// 마지막 명령어 (끝 - 시작)
+	unsigned long long mark_ns;		// 현재 명령어 시작 시각
+	bool has_last;
+} StatsSession;
+
+/**
+ * 추적 구간 구조체 (Chrome trace-event의 "X" 이벤트 하나)
+ */
+typedef struct trace_event {
+	const char *name;				// 구간 이름 (정적 문자열)
+	const char *arg_names[2];		// 인자 이름 (NULL이면 인자 없음)
+	unsigned long long args[2];
+	unsigned long long start;		// 시작 시각 (stats_now)
+	unsigned long long dur;			// 길이 (나노초)
+} TraceEvent;
+
+/**
+ * 스레드별 추적 버퍼 구조체 (스레드가 끝나면 공유 목록으로 넘김)
+ */
+typedef struct trace_buf {
+	TraceEvent *events;
+	size_t count;
+	size_t capacity;
+	unsigned long long dropped;		// 버퍼가 가득 차서 버린 구간 수
+	unsigned int tid;				// 추적 파일의 스레드 번호 (0이면 아직 정하지 않음)
+	const char *thread_name;
+	struct trace_buf *next;			// 넘겨진 버퍼 목록
+} TraceBuf;
+
+/**
+ * 출력 버퍼 구조체 (tree, print 출력을 모았다가 정해진 지점에서 write 한 번으로 출력)
+ */
+typedef struct out_buf {
+	int fd;							// 출력 파일 디스크립터
+	char *data;						// 버퍼 (NULL이면 모든 출력을 바로 write)
+	size_t len;						// 쌓인 바이트 수
+	size_t capacity;				// 버퍼 크기
+	unsigned long flushes;			// write 횟수
+	bool failed;					// write 실패 여부
+} OutBuf;
+
+/**
+ * io_uring 인스턴스 구조체 (커널과 공유하는 큐 매핑)
+ */
+typedef struct uring {
+	int fd;
+	unsigned int entries;			// 제출 큐 크기
+	unsigned int pending;			// 아직 제출하지 않은 요청 수
+	unsigned int *sq_head;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_array;
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	void *sqes;						// struct io_uring_sqe 배열
+	void *cqes;						// struct io_uring_cqe 배열
+	void *sq_map;
+	void *cq_map;
+	size_t sq_map_len;
+	size_t cq_map_len;
+	size_t sqes_len;
+} Uring;
+
+/**
+ * 블록 캐시 엔트리 구조체
+ */
+typedef struct block_cache_entry {
+	unsigned int block_num;		// 캐시된 블록 번호
+	int next;					// 같은 해시 버킷의 다음 엔트리 (-1이면 끝)
+	unsigned char referenced;	// CLOCK 참조 비트
+} BlockCacheEntry;
+
+/**
+ * 블록 캐시 샤드 구조체 (샤드마다 독립된 락과 CLOCK 바늘을 가짐)
+ */
+typedef struct block_cache_shard {
+	pthread_mutex_t lock;
+	int *buckets;				// 해시 버킷 (엔트리 인덱스, -1이면 비어 있음)
+	unsigned int bucket_count;
+	BlockCacheEntry *entries;
+	unsigned char *data;		// 엔트리별 슬롯 데이터 (capacity * slot_size)
+	unsigned int capacity;		// 최대 엔트리 수
+	unsigned int used;			// 사용 중인 엔트리 수
+	unsigned int hand;			// CLOCK 바늘 위치
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+} BlockCacheShard;
+
+/**
+ * 블록 캐시 구조체 (블록 번호를 키로 하는 샤드 CLOCK 캐시)
+ * 데이터 블록 캐시와 inode 테이블 캐시가 같은 구조를 사용
+ */
+typedef struct block_cache {
+	BlockCacheShard *shards;
+	unsigned int shard_count;	// 0이면 캐시 비활성화
+	unsigned int slot_size;		// 슬롯 하나의 크기
+} BlockCache;
+
+/**
+ * 블록 캐시 통계 구조체
+ */
+typedef struct block_cache_stats {
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+	unsigned long cached_blocks;
+	unsigned long capacity_blocks;
+} BlockCacheStats;
+
+/**
+ * 덴트리 캐시 엔트리 구조체 ((부모 inode, 이름) -> 자식 inode)
+ */
+typedef struct dentry_cache_entry {
+	unsigned int hash;				// (부모, 이름) 해시
+	unsigned int parent;			// 부모 디렉토리 inode 번호
+	unsigned int child;				// 자식 inode 번호 (0이면 없는 이름)
+	unsigned char valid;
+	unsigned char name_len;
+	char name[MAX_FILE_NAME + 1];
+} DentryCacheEntry;
+
+/**
+ * 덴트리 캐시 구조체 (세트 연관 해시 테이블, 세션 동안 명령어 간 공유)
+ */
+typedef struct dentry_cache {
+	pthread_mutex_t lock;
+	DentryCacheEntry *entries;		// set_count * DENTRY_CACHE_WAYS
+	unsigned char *next_victim;		// 세트별 다음 교체 위치
+	unsigned int set_count;
+	unsigned long hits;
+	unsigned long negative_hits;
+	unsigned long misses;
+} DentryCache;
+
+/**
+ * 익스텐트 구조체 (논리 블록 -> 물리 블록 연속 구간)
+ */
+typedef struct block_extent {
+	unsigned int logical;			// 파일 내 시작 논리 블록 번호
+	unsigned int physical;			// 시작 물리 블록 번호
+	unsigned int length;			// 연속 블록 수
+} BlockExtent;
+
+/**
+ * 블록 맵 캐시 엔트리 구조체
+ * 파일의 리프 구간 하나(직접 블록 12개, 또는 마지막 단계 간접 블록 하나가 가리키는 블록들)를 익스텐트 목록으로 보관
+ */
+typedef struct extent_cache_entry {
+	unsigned int inode_num;					// inode 번호
+	unsigned int generation;				// i_generation (inode 재사용 구분)
+	unsigned int leaf;						// 리프 구간 번호 (0: 직접 블록)
+	unsigned int run_count;					// 익스텐트 수 (0이면 구간 전체가 구멍)
+	struct extent_cache_entry *hash_next;	// 같은 해시 버킷의 다음 엔트리
+	struct extent_cache_entry *lru_prev;	// 더 최근에 사용한 엔트리
+	struct extent_cache_entry *lru_next;	// 더 오래전에 사용한 엔트리
+	BlockExtent runs[];						// 논리 블록 순서의 익스텐트
+} ExtentCacheEntry;
+
+/**
+ * 블록 맵 캐시 구조체 ((inode, i_generation, 리프 구간) -> 익스텐트 목록, 메모리 예산 안에서 LRU 교체)
+ */
+typedef struct extent_cache {
+	pthread_mutex_t lock;
+	ExtentCacheEntry **buckets;		// NULL이면 캐시 비활성화
+	unsigned int bucket_count;		// 2의 거듭제곱
+	ExtentCacheEntry *lru_head;		// 가장 최근에 사용한 엔트리
+	ExtentCacheEntry *lru_tail;		// 가장 오래전에 사용한 엔트리
+	size_t bytes;					// 엔트리들이 차지하는 바이트 수
+	size_t budget;					// 메모리 예산
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+	unsigned long entries;
+} ExtentCache;
+
+/**
+ * 아레나 청크 구조체 (청크 헤더 뒤에 데이터가 이어짐)
+ */
+typedef struct arena_chunk {
+	struct arena_chunk *next;
+	size_t size;					// 데이터 영역 크기
+	size_t used;					// 사용한 바이트 수
+	unsigned char data[];
+} ArenaChunk;
+
+/**
+ * 아레나 구조체 (명령어 하나 동안 트리 노드를 소유하고, 끝나면 한 번에 해제)
+ */
+typedef struct arena {
+	ArenaChunk *chunks;				// 청크 목록 (첫 번째가 현재 할당 중인 청크)
+	size_t chunk_bytes;				// 새 청크 크기
+	unsigned int chunk_count;
+	size_t reserved_bytes;			// 할당받은 청크 크기 합
+	size_t used_bytes;				// 실제로 나눠준 바이트 수
+	size_t peak_bytes;				// reserved_bytes 최대값
+} Arena;
+
+/**
+ * 디렉토리 트리 저장소 구조체 (명령어 하나 동안 아레나가 소유)
+ * 노드 배열과 이름 풀은 크기가 두 배씩 커지는 세그먼트로 나뉘어 있어서, 커져도 기존 노드가 옮겨지지 않음
+ * 여러 스레드가 인덱스 구간을 원자적으로 예약해서 동시에 채울 수 있음
+ */
+typedef struct dir_tree {
+	DirTreeNode *node_segs[TREE_NODE_SEGS];	// 노드 세그먼트 (처음 쓰일 때 할당)
+	char *name_segs[TREE_NAME_SEGS];		// 이름 세그먼트
+	unsigned long node_count;				// 예약된 노드 인덱스 수
+	unsigned long name_bytes;				// 예약된 이름 풀 바이트 수
+	unsigned int live_nodes;				// 실제로 만든 노드 수
+	Arena *arena;							// 세그먼트를 할당할 아레나
+	pthread_mutex_t lock;					// 세그먼트 할당용
+} DirTree;
+
+/**
+ * 트리 쓰기 커서 구조체 (스레드마다 하나)
+ * 미리 예약한 노드/이름 구간에서 락 없이 노드를 만들고, 디렉토리 하나의 자식을 모았다가 한 번에 옮김
+ */
+typedef struct dir_tree_cursor {
+	DirTree *tree;
+	unsigned int node_next;			// 예약 구간에서 다음에 쓸 노드 인덱스
+	unsigned int node_end;
+	unsigned int name_next;			// 예약 구간에서 다음에 쓸 이름 풀 오프셋
+	unsigned int name_end;
+	DirTreeNode *stage;				// 읽고 있는 디렉토리의 자식 노드 임시 배열
+	unsigned int stage_count;
+	unsigned int stage_capacity;
+} DirTreeCursor;
+
+/**
+ * 이미지 세션 컨텍스트 구조체
+ * main()에서 한 번 생성되어 모든 명령어에 전달됨
+ */
+typedef struct ext2_context {
+	int fd;								// 이미지 파일 디스크립터
+	struct my_ext2_super_block sb;		// 슈퍼블록
+	struct my_ext2_group_desc *gd;		// 그룹 디스크립터 테이블
+	unsigned int group_count;			// 블록 그룹 개수
+	unsigned int block_size;			// 블록 크기
+	unsigned int inode_size;			// inode 크기
+	unsigned int ptrs_per_block;		// 블록당 블록 포인터 수
+	unsigned int inodes_per_block;		// 블록당 inode 수
+	const unsigned char *map;			// mmap된 이미지 (NULL이면 pread로 읽음)
+	size_t map_size;					// 매핑된 크기
+	BlockCache cache;					// pread 경로의 블록 캐시
+	BlockCache inode_cache;				// pread 경로의 inode 테이블 캐시 (inode 테이블 블록 단위)
+	DentryCache dcache;					// 경로 탐색용 덴트리 캐시
+	ExtentCache ecache;					// print용 블록 맵 캐시
+	Uring uring;						// print 내용 읽기용 io_uring (fd < 0이면 동기 경로)
+	OutBuf out;							// tree, print 공유 출력 버퍼
+	Ext2Config config;					// 실행 옵션
+	StatsSession stats;					// 실행 통계 (stats 명령어)
+} Ext2Context;
+
+/**
+ * 블록 맵 반복자 구조체 (inode를 익스텐트 스트림으로 변환)
+ */
+typedef struct block_map_iter {
+	Ext2Context *ctx;
+	unsigned int i_block[EXT2_N_BLOCKS];	// inode의 블록 포인터 복사본
+	unsigned int next;						// 다음에 매핑할 논리 블록 번호
+	unsigned int end;						// i_size 기준 논리 블록 수
+	unsigned char *ind_scratch[3];			// 간접 단계별 임시 버퍼 (매핑 모드면 NULL)
+	const unsigned int *ind_ptrs[3];		// 간접 단계별 현재 블록 포인터 배열
+	unsigned int ind_num[3];				// 간접 단계별 현재 블록 번호
+	unsigned int prefetch_block[3];			// 간접 단계별 마지막으로 미리 읽기를 요청한 테이블 블록 번호
+	unsigned int prefetch_end[3];			// 간접 단계별 미리 읽기를 요청한 위치의 끝
+	unsigned int size_end;					// i_size 기준 논리 블록 수 (block_map_seek으로 줄지 않음)
+	unsigned int inode_num;					// 블록 맵 캐시 키 (0이면 캐시 사용 안 함)
+	unsigned int generation;				// 블록 맵 캐시 키 (i_generation)
+	unsigned int leaf;						// leaf_runs에 올려 둔 리프 구간 번호
+	bool leaf_loaded;						// leaf_runs가 유효한지 여부
+	BlockExtent *leaf_runs;					// 현재 리프 구간의 익스텐트 (캐시에서 복사)
+	unsigned int leaf_run_count;
+	unsigned int leaf_hint;					// 마지막으로 찾은 익스텐트 위치
+	bool failed;							// 간접 블록을 읽지 못했는지 여부 (이후 조회는 모두 실패)
+} BlockMapIter;
+
+/**
+ * 디렉토리 스트림에서 꺼낸 엔트리 구조체
+ */
+typedef struct dir_stream_entry {
+	unsigned int inode_num;
+	unsigned int mode;				// i_mode
+	unsigned int size;				// i_size
+	unsigned int name_len;
+	char name[MAX_FILE_NAME + 1];
+} DirStreamEntry;
+
+/**
+ * 디렉토리 스트림 구조체 (디렉토리 엔트리를 블록 단위로 읽으며 하나씩 꺼냄)
+ */
+typedef struct dir_stream {
+	Ext2Context *ctx;
+	BlockMapIter it;				// 디렉토리 블록 맵 반복자
+	BlockExtent extent;				// 현재 익스텐트
+	unsigned int extent_pos;		// 익스텐트 안에서 다음에 읽을 블록 위치
+	unsigned int block_num;			// 현재 블록 번호
+	const unsigned char *block;		// 현재 블록 데이터 (NULL이면 다음 블록을 읽어야 함)
+	unsigned int offset;			// 현재 블록 안의 다음 엔트리 위치
+	unsigned char *scratch;			// pread 경로의 블록 버퍼 (매핑 모드면 NULL)
+	unsigned long long trace_start;	// 현재 블록의 inode 읽기 구간 시작 시각 (추적 중이 아니면 0)
+	unsigned int trace_inodes;		// 현재 블록에서 읽은 inode 수
+	bool opened;
+} DirStream;
+
+/**
+ * tree 출력의 깊이별 접두사 상태 (깊이 제한 없이 필요한 만큼 늘어남)
+ */
+typedef struct tree_prefix {
+	unsigned char *open;			// 깊이별 연결선 여부 (1이면 "┃ ", 0이면 "  ")
+	unsigned int capacity;
+	bool failed;					// 접두사 배열을 늘리지 못해 더 깊이 출력하지 못했는지 여부
+} TreePrefix;
+
+/**
+ * 스트리밍 tree 출력의 깊이별 상태 (디렉토리 스트림과 미리 읽은 다음 엔트리)
+ */
+typedef struct tree_stream_level {
+	DirStream ds;
+	DirStreamEntry ahead;			// 다음에 출력할 엔트리
+	bool has_ahead;					// false면 이 디렉토리의 마지막 엔트리까지 출력함
+} TreeStreamLevel;
+
+/**
+ * print 출력 링 슬롯 상태
+ */
+#define SLOT_FREE 0
+#define SLOT_INFLIGHT 1							// io_uring 읽기 진행 중
+#define SLOT_READY 2							// 출력 대기
+
+/**
+ * print 출력 스트림 구조체
+ * 연속 블록 구간을 정렬된 링 버퍼에 읽어 논리 순서대로 출력
+ * 동기 경로는 preadv 한 번으로 여러 슬롯을 채우고, io_uring 경로는 슬롯마다 읽기 요청을 띄움
+ */
+typedef struct print_stream {
+	Ext2Context *ctx;
+	unsigned char *ring;					// slot_count * slot_bytes (매핑 모드면 NULL)
+	size_t slot_bytes;						// 슬롯 크기 (블록 크기의 배수)
+	unsigned int slot_count;				// 슬롯 수 (io_uring이면 큐 깊이)
+	size_t *slot_len;						// 슬롯별 채워진 바이트 수
+	unsigned char *slot_state;				// 슬롯별 상태 (SLOT_*)
+	struct iovec *slot_iov;					// 슬롯별 io_uring 읽기 iovec
+	struct iovec *iov;						// preadv/writev용 임시 iovec 배열
+	unsigned int head;						// 가장 먼저 채워진 슬롯
+	unsigned int count;						// 사용 중인 슬롯 수
+	bool use_uring;							// io_uring 백엔드 사용 여부
+	bool failed;							// io_uring 읽기 실패 여부
+	unsigned long long position;			// 파일 내 현재 위치 (출력 예정 바이트 포함)
+	unsigned long long file_size;			// 파일 크기 (i_size)
+	int line_count;							// 출력할 라인 수 (0 이하면 전체)
+	int line_printed;						// 출력한 라인 수
+	bool done;								// 라인 수 제한 도달 여부
+	unsigned int inflight;					// 진행 중인 읽기 수
+	unsigned int inflight_max;				// 최대 동시 읽기 수
+	unsigned long long inflight_sum;		// 읽기 제출 시점의 동시 읽기 수 합 (평균 계산용)
+	unsigned long long reads;				// 읽기 요청 수
+	unsigned long long bytes_read;			// 읽은 바이트 수
+	struct timespec start;					// 시작 시각
+} PrintStream;
+
+/**
+ * 디렉토리 탐색 작업 구조체 (하위 디렉토리 하나)
+ */
+typedef struct walk_task {
+	unsigned int inode_num;			// 디렉토리 inode 번호
+	unsigned int node;				// 자식들을 붙일 트리 노드 인덱스 (작업을 가진 스레드만 수정)
+} WalkTask;
+
+/**
+ * 스레드별 작업 덱 구조체
+ * 소유 스레드는 tail에서 넣고 빼며, 다른 스레드는 head에서 훔쳐감
+ */
+typedef struct walk_deque {
+	pthread_mutex_t lock;
+	WalkTask *tasks;
+	unsigned int head;
+	unsigned int tail;
+	unsigned int capacity;
+} WalkDeque;
+
+/**
+ * 병렬 디렉토리 탐색 공유 상태 구조체
+ */
+typedef struct walk_pool {
+	Ext2Context *ctx;
+	WalkDeque *deques;				// 스레드별 작업 덱
+	DirTreeCursor *cursors;			// 스레드별 트리 쓰기 커서
+	unsigned int thread_count;
+	unsigned long pending;			// 아직 끝나지 않은 작업 수 (0이 되면 탐색 종료)
+	unsigned long generation;		// 작업이 추가될 때마다 증가 (유휴 스레드 깨우기용)
+	unsigned int idle;				// 대기 중인 스레드 수
+	pthread_mutex_t lock;			// idle 대기용
+	pthread_cond_t cond;
+	bool failed;					// 메모리 부족 등으로 작업을 추가하지 못함
+} WalkPool;
+
+/**
+ * 탐색 스레드 인자 구조체
+ */
+typedef struct walk_worker_arg {
+	WalkPool *pool;
+	unsigned int self;				// 스레드 번호 (자신의 덱 인덱스)
+} WalkWorkerArg;
+
 extern char *img_path;
+extern __thread StatCounters stat_local;
+
+// 현재 스레드의 실행 통계 카운터 증가 (스레드 지역 변수라 락이나 원자적 연산이 필요 없음)
+#define STAT_ADD(field, n) (stat_local.field += (n))
+
+extern bool trace_enabled;
+
+// 추적 구간 시작 시각 (추적이 꺼져 있으면 예측 가능한 분기 하나만 실행하고 0)
+#define TRACE_BEGIN() (__builtin_expect(trace_enabled, 0) ? stats_now() : 0ULL)
+
+// 추적 구간 기록 (인자 이름이 NULL이면 그 인자는 기록하지 않음)
+#define TRACE_END(name, start, k0, v0, k1, v1) do { \
+	if (__builtin_expect(trace_enabled, 0)) { \
+		trace_span((name), (start), (k0), (unsigned long long)(v0), (k1), (unsigned long long)(v1)); \
+	} \
+} while (0)
+
+/* block_cache.c */
+int block_cache_init(BlockCache *cache, unsigned int slot_size, size_t budget_bytes);
+void block_cache_destroy(BlockCache *cache);
+void block_cache_clear(BlockCache *cache);
+bool block_cache_lookup(BlockCache *cache, unsigned int block_num, 
+						unsigned int offset, unsigned int len, void *buffer);
+void block_cache_insert(BlockCache *cache, unsigned int block_num, const void *data);
+void block_cache_get_stats(BlockCache *cache, BlockCacheStats *stats);
+
+/* dentry_cache.c */
+int dentry_cache_init(DentryCache *dc, unsigned int set_count);
+void dentry_cache_destroy(DentryCache *dc);
+void dentry_cache_clear(DentryCache *dc);
+bool dentry_cache_lookup(DentryCache *dc, unsigned int parent, const char *name, unsigned int *child);
+void dentry_cache_insert(DentryCache *dc, unsigned int parent, const char *name, unsigned int child);
+
+/* extent_cache.c */
+int extent_cache_init(ExtentCache *ec, size_t budget);
+void extent_cache_destroy(ExtentCache *ec);
+void extent_cache_clear(ExtentCache *ec);
+bool extent_cache_lookup(ExtentCache *ec, unsigned int inode_num, unsigned int generation, 
+						 unsigned int leaf, BlockExtent *runs, unsigned int *run_count);
+void extent_cache_insert(ExtentCache *ec, unsigned int inode_num, unsigned int generation, 
+						 unsigned int leaf, const BlockExtent *runs, unsigned int run_count);
+
+/* block_map.c */
+void block_map_init(BlockMapIter *it, Ext2Context *ctx, const struct my_ext2_inode *inode);
+void block_map_init_cached(BlockMapIter *it, Ext2Context *ctx, unsigned int inode_num, 
+						   const struct my_ext2_inode *inode);
+void block_map_destroy(BlockMapIter *it);
+bool block_map_next(BlockMapIter *it, BlockExtent *extent);
+unsigned int block_map_lookup(BlockMapIter *it, unsigned int logical);
+void block_map_seek(BlockMapIter *it, unsigned int start, unsigned int end);
 
 /* debug.c */
 void	debug_tree_cmd(Command cmd);
 void	debug_print_cmd(Command cmd);
-void	debug_directory_block(unsigned char* block_buf, unsigned int block_size);
+void	debug_directory_block(const unsigned char* block_buf, unsigned int block_size);
+
+/* stats.c */
+unsigned long long stats_now(void);
+void stats_phase_add(int phase, unsigned long long start);
+void stats_thread_flush(void);
+void stats_snapshot(Ext2Context *ctx, Ext2Stats *out);
+void stats_command_begin(Ext2Context *ctx);
+void stats_command_end(Ext2Context *ctx);
+void stats_command(Ext2Context *ctx, char *line);
+
+/* trace.c */
+int trace_open(const char *path);
+void trace_span(const char *name, unsigned long long start, 
+				const char *k0, unsigned long long v0, const char *k1, unsigned long long v1);
+void trace_thread_name(const char *name);
+void trace_thread_flush(void);
+int trace_close(void);
+
+/* ext2_context.c */
+int open_ext2_context(const char *path, const Ext2Config *config, Ext2Context *ctx);
+int refresh_ext2_context(Ext2Context *ctx);
+void close_ext2_context(Ext2Context *ctx);
 
 /* ext2_utils.c */
 int read_super_block(int fd, struct my_ext2_super_block *sb);
 unsigned int get_block_size(struct my_ext2_super_block *sb);
-int read_data_block(int fd, struct my_ext2_super_block *sb, unsigned int block_num, unsigned char *buffer);
+int read_data_block(Ext2Context *ctx, unsigned int block_num, unsigned char *buffer);
+const unsigned char *get_data_block(Ext2Context *ctx, unsigned int block_num, unsigned char *scratch);
+unsigned char *alloc_block_scratch(Ext2Context *ctx);
+void prefetch_blocks(Ext2Context *ctx, unsigned int block_num, unsigned int count);
 
 /* ext2_inode.c */
-unsigned int path_to_inode(int fd, struct my_ext2_super_block *sb, 
-						  struct my_ext2_group_desc *gd, 
-						  const char *path);
-unsigned int find_entry_in_dir(int fd, struct my_ext2_super_block *sb, 
+unsigned int path_to_inode(Ext2Context *ctx, const char *path);
+unsigned int find_entry_in_dir(Ext2Context *ctx, 
 							  struct my_ext2_inode *dir_inode, 
 							  const char *name);
-int read_inode(int fd, int inode_num, 
-			  struct my_ext2_super_block *sb, 
-			  struct my_ext2_group_desc *gd, 
+int read_inode(Ext2Context *ctx, unsigned int inode_num, 
 			  struct my_ext2_inode *inode);
 			  
 /* help.c */
@@ -76,47 +666,101 @@ void	help_tree();
 void	help_print();
 void	help_help();
 void	help_exit();
+void	help_stats();
 
 /* parse.c */
-bool	parse_tree_command(char *line, Command *cmd);
+bool	parse_tree_command(Ext2Context *ctx, char *line, Command *cmd);
 bool	parse_print_command(char *line, Command *cmd); 
+bool	parse_session_options(int argc, char *argv[], Ext2Config *config, char **image);
+
+/* out_buf.c */
+int write_all(int fd, const unsigned char *data, size_t len);
+int out_buf_init(OutBuf *out, int fd, size_t capacity);
+void out_buf_destroy(OutBuf *out);
+int out_buf_flush(OutBuf *out);
+int out_buf_write(OutBuf *out, const void *data, size_t len);
+int out_buf_char(OutBuf *out, char c);
+int out_buf_str(OutBuf *out, const char *str);
+int out_buf_uint(OutBuf *out, unsigned long long value);
+int out_buf_int(OutBuf *out, long long value);
+int out_buf_mode(OutBuf *out, unsigned int mode);
+
+/* newline_scan.c */
+size_t newline_find(const unsigned char *data, size_t len, unsigned long long *remaining);
+size_t newline_rfind(const unsigned char *data, size_t len, unsigned long long *remaining);
+const char *newline_scan_name(void);
 
 /* print.c */
-void print(Command *cmd);
-int print_file_content(int fd, struct my_ext2_super_block *sb, 
+void print(Ext2Context *ctx, Command *cmd);
+int print_file_range(Ext2Context *ctx, 
+					unsigned int inode_num, 
+					struct my_ext2_inode *inode, 
+					unsigned long long offset, 
+					unsigned long long length, 
+					int line_count);
+int print_file_content(Ext2Context *ctx, 
+					  unsigned int inode_num, 
 					  struct my_ext2_inode *inode, 
 					  int line_count);
+int print_file_tail(Ext2Context *ctx, 
+				   unsigned int inode_num, 
+				   struct my_ext2_inode *inode, 
+				   int tail_lines);
+
+/* print_stream.c */
+int print_stream_init(PrintStream *ps, Ext2Context *ctx, 
+					  unsigned long long file_size, int line_count);
+void print_stream_destroy(PrintStream *ps);
+int print_stream_run(PrintStream *ps, unsigned int physical, unsigned int count, unsigned int skip);
+int print_stream_zero(PrintStream *ps, unsigned long long len);
+int print_stream_flush(PrintStream *ps);
+void print_stream_report(PrintStream *ps);
 
 /* tree.c */
-void count_files_and_dirs(DirTreeNode* node, int* file_count, int* dir_count);
-void tree(Command *cmd);
-DirTreeNode* create_tree_node(const char* name, int inode_num, int file_type, unsigned int size, unsigned int permissions);
-void free_tree_node(DirTreeNode* node);
-int read_directory_entries(int fd, struct my_ext2_super_block *sb, 
-						  struct my_ext2_group_desc *gd,
-						  unsigned int dir_inode_num, DirTreeNode *parent_node, 
-						  int recursive);
-int process_directory_block(int fd, struct my_ext2_super_block *sb, 
-						   struct my_ext2_group_desc *gd,
-						   unsigned int block_num, DirTreeNode *parent_node,
-						   int recursive, int *dir_count, int *file_count);
-int process_indirect_block(int fd, struct my_ext2_super_block *sb, 
-						  struct my_ext2_group_desc *gd,
-						  unsigned int indirect_block_num, DirTreeNode *parent_node,
-						  int recursive, int *dir_count, int *file_count);
-int process_double_indirect_block(int fd, struct my_ext2_super_block *sb, 
-								 struct my_ext2_group_desc *gd,
-								 unsigned int double_indirect_block_num, 
-								 DirTreeNode *parent_node, int recursive, 
-								 int *dir_count, int *file_count);
-int process_triple_indirect_block(int fd, struct my_ext2_super_block *sb, 
-								 struct my_ext2_group_desc *gd,
-								 unsigned int triple_indirect_block_num, 
-								 DirTreeNode *parent_node, int recursive, 
-								 int *dir_count, int *file_count);
+void count_files_and_dirs(const DirTree *tree, unsigned int index, int* file_count, int* dir_count);
+void tree(Ext2Context *ctx, Command *cmd);
+void tree_prefix_init(TreePrefix *prefix);
+void tree_prefix_destroy(TreePrefix *prefix);
+void print_tree_node(OutBuf *out, const DirTree *tree, unsigned int index, int depth, int options, int is_last, TreePrefix *prefix);
+int read_directory_entries(Ext2Context *ctx, 
+						  unsigned int dir_inode_num, DirTreeCursor *cursor, 
+						  unsigned int parent, int recursive);
+
+/* dir_stream.c */
+int dir_stream_open(DirStream *ds, Ext2Context *ctx, unsigned int dir_inode_num);
+void dir_stream_close(DirStream *ds);
+bool dir_stream_next(DirStream *ds, DirStreamEntry *out);
+
+/* dir_tree.c */
+int dir_tree_init(DirTree *tree, Arena *arena);
+void dir_tree_destroy(DirTree *tree);
+void dir_tree_cursor_init(DirTreeCursor *cursor, DirTree *tree);
+void dir_tree_cursor_destroy(DirTreeCursor *cursor);
+int dir_tree_stage(DirTreeCursor *cursor, const char *name, unsigned int name_len, 
+				   unsigned int inode_num, unsigned int mode, unsigned int size);
+unsigned int dir_tree_commit(DirTreeCursor *cursor, unsigned int parent);
+unsigned int dir_tree_add(DirTreeCursor *cursor, const char *name, unsigned int name_len, 
+						  unsigned int inode_num, unsigned int mode, unsigned int size);
+DirTreeNode *dir_tree_node(const DirTree *tree, unsigned int index);
+const char *dir_tree_name(const DirTree *tree, const DirTreeNode *node);
+
+/* walk.c */
+int walk_directory_tree(Ext2Context *ctx, unsigned int dir_inode_num, DirTree *tree, unsigned int root);
+
+/* arena.c */
+void arena_init(Arena *arena, size_t chunk_bytes);
+void *arena_alloc(Arena *arena, size_t size);
+void arena_release(Arena *arena);
+
+/* uring.c */
+int uring_init(Uring *ring, unsigned int entries);
+void uring_destroy(Uring *ring);
+int uring_prep_readv(Uring *ring, int fd, const struct iovec *iov, off_t offset, unsigned long long user_data);
+int uring_submit(Uring *ring);
+int uring_reap(Uring *ring, bool wait, unsigned long long *user_data, int *res);
 
 /* utils */
 char	**fix_split(char const *s, char c);
 
 /* validate.c */
-int validate_tree_path(const char *path);
+int validate_tree_path(Ext2Context *ctx, const char *path);
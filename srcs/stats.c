@@ -0,0 +1,240 @@
+#include "ssu_ext2.h"
+
+/*
+ * 스레드별 카운터 (항상 컴파일되며, 증가는 스레드 지역 변수에 더하기 한 번)
+ * 탐색 스레드는 끝나기 전에 자기 카운터를 stat_flushed에 넘기고, 스냅샷은 메인 스레드 카운터와 합쳐서 만듦
+ */
+__thread StatCounters	stat_local;
+
+static StatCounters		stat_flushed;
+static pthread_mutex_t	stat_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char	*phase_names[STAT_PHASES] = { "load", "path", "walk", "render" };
+static const char	*cache_names[STAT_CACHES] = { "block", "inode", "dentry", "extent" };
+
+/**
+ * 현재 시각 (나노초, 단조 시계)
+ */
+unsigned long long	stats_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+/**
+ * 단계 시간을 더하는 함수
+ *
+ * @param phase 단계 (STAT_PHASE_*)
+ * @param start 단계 시작 시각 (stats_now)
+ */
+void	stats_phase_add(int phase, unsigned long long start)
+{
+	stat_local.phase_ns[phase] += stats_now() - start;
+	TRACE_END(phase_names[phase], start, NULL, 0, NULL, 0);
+}
+
+/**
+ * 카운터 a에 b를 더하는 함수
+ */
+static void	counters_add(StatCounters *a, const StatCounters *b)
+{
+	a->blocks_read += b->blocks_read;
+	a->bytes_read += b->bytes_read;
+	a->inodes_read += b->inodes_read;
+	a->syscalls += b->syscalls;
+	a->dirents += b->dirents;
+	a->nodes += b->nodes;
+	a->commands += b->commands;
+	a->command_ns += b->command_ns;
+	for (int i = 0; i < STAT_PHASES; i++) {
+		a->phase_ns[i] += b->phase_ns[i];
+	}
+}
+
+/**
+ * 현재 스레드의 카운터를 공유 합계로 넘기는 함수 (탐색 스레드가 끝나기 직전에 호출)
+ */
+void	stats_thread_flush(void)
+{
+	pthread_mutex_lock(&stat_lock);
+	counters_add(&stat_flushed, &stat_local);
+	pthread_mutex_unlock(&stat_lock);
+	memset(&stat_local, 0, sizeof(StatCounters));
+}
+
+/**
+ * 현재까지의 실행 통계 스냅샷을 만드는 함수 (명령어 사이에 메인 스레드에서 호출)
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param out 스냅샷을 저장할 포인터
+ */
+void	stats_snapshot(Ext2Context *ctx, Ext2Stats *out)
+{
+	BlockCacheStats cache;
+
+	memset(out, 0, sizeof(Ext2Stats));
+	pthread_mutex_lock(&stat_lock);
+	out->c = stat_flushed;
+	pthread_mutex_unlock(&stat_lock);
+	counters_add(&out->c, &stat_local);
+
+	block_cache_get_stats(&ctx->cache, &cache);
+	out->cache_hits[STAT_CACHE_BLOCK] = cache.hits;
+	out->cache_misses[STAT_CACHE_BLOCK] = cache.misses;
+	block_cache_get_stats(&ctx->inode_cache, &cache);
+	out->cache_hits[STAT_CACHE_INODE] = cache.hits;
+	out->cache_misses[STAT_CACHE_INODE] = cache.misses;
+	out->cache_hits[STAT_CACHE_DENTRY] = ctx->dcache.hits + ctx->dcache.negative_hits;
+	out->cache_misses[STAT_CACHE_DENTRY] = ctx->dcache.misses;
+	out->cache_hits[STAT_CACHE_EXTENT] = ctx->ecache.hits;
+	out->cache_misses[STAT_CACHE_EXTENT] = ctx->ecache.misses;
+}
+
+/**
+ * 두 값의 차이 (캐시를 비워서 값이 줄었으면 뒤의 값 그대로)
+ */
+static unsigned long long	delta(unsigned long long after, unsigned long long before)
+{
+	return after >= before ? after - before : after;
+}
+
+/**
+ * 두 스냅샷의 차이를 구하는 함수
+ */
+static void	stats_diff(const Ext2Stats *after, const Ext2Stats *before, Ext2Stats *out)
+{
+	const StatCounters *a = &after->c;
+	const StatCounters *b = &before->c;
+
+	out->c.blocks_read = delta(a->blocks_read, b->blocks_read);
+	out->c.bytes_read = delta(a->bytes_read, b->bytes_read);
+	out->c.inodes_read = delta(a->inodes_read, b->inodes_read);
+	out->c.syscalls = delta(a->syscalls, b->syscalls);
+	out->c.dirents = delta(a->dirents, b->dirents);
+	out->c.nodes = delta(a->nodes, b->nodes);
+	out->c.commands = delta(a->commands, b->commands);
+	out->c.command_ns = delta(a->command_ns, b->command_ns);
+	for (int i = 0; i < STAT_PHASES; i++) {
+		out->c.phase_ns[i] = delta(a->phase_ns[i], b->phase_ns[i]);
+	}
+	for (int i = 0; i < STAT_CACHES; i++) {
+		out->cache_hits[i] = delta(after->cache_hits[i], before->cache_hits[i]);
+		out->cache_misses[i] = delta(after->cache_misses[i], before->cache_misses[i]);
+	}
+}
+
+/**
+ * 명령어 시작 시점을 기록하는 함수
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ */
+void	stats_command_begin(Ext2Context *ctx)
+{
+	stats_snapshot(ctx, &ctx->stats.mark);
+	ctx->stats.mark_ns = stats_now();
+}
+
+/**
+ * 명령어가 끝난 시점의 통계로 마지막 명령어 통계를 만드는 함수
+ * --stats(또는 stats on)이면 한 줄 요약을 표준 에러로 출력
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ */
+void	stats_command_end(Ext2Context *ctx)
+{
+	Ext2Stats now;
+
+	stat_local.commands++;
+	stat_local.command_ns += stats_now() - ctx->stats.mark_ns;
+	TRACE_END("command", ctx->stats.mark_ns, NULL, 0, NULL, 0);
+	stats_snapshot(ctx, &now);
+	stats_diff(&now, &ctx->stats.mark, &ctx->stats.last);
+	ctx->stats.has_last = true;
+
+	if (!ctx->config.stats_summary) {
+		return;
+	}
+	const Ext2Stats *s = &ctx->stats.last;
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+	for (int i = 0; i < STAT_CACHES; i++) {
+		hits += s->cache_hits[i];
+		misses += s->cache_misses[i];
+	}
+	fprintf(stderr, "stats: %.3f ms (load %.3f, path %.3f, walk %.3f, render %.3f), "
+			"%llu blocks, %llu KB, %llu inodes, %llu syscalls, %llu dirents, %llu nodes, "
+			"cache %llu/%llu\n",
+			s->c.command_ns / 1e6, s->c.phase_ns[STAT_PHASE_LOAD] / 1e6, s->c.phase_ns[STAT_PHASE_PATH] / 1e6,
+			s->c.phase_ns[STAT_PHASE_WALK] / 1e6, s->c.phase_ns[STAT_PHASE_RENDER] / 1e6,
+			s->c.blocks_read, s->c.bytes_read / 1024, s->c.inodes_read, s->c.syscalls,
+			s->c.dirents, s->c.nodes, hits, misses);
+}
+
+/**
+ * 스냅샷 차이 하나를 여러 줄로 출력하는 함수
+ */
+static void	print_stats(const char *title, const Ext2Stats *s)
+{
+	printf("%s (%llu commands, %.3f ms)\n", title, s->c.commands, s->c.command_ns / 1e6);
+	printf("  phases  :");
+	for (int i = 0; i < STAT_PHASES; i++) {
+		printf(" %s %.3f ms%s", phase_names[i], s->c.phase_ns[i] / 1e6, i + 1 < STAT_PHASES ? "," : "\n");
+	}
+	printf("  read    : %llu blocks, %.2f MB, %llu inodes, %llu syscalls\n",
+		   s->c.blocks_read, s->c.bytes_read / (1024.0 * 1024.0), s->c.inodes_read, s->c.syscalls);
+	printf("  tree    : %llu dirents decoded, %llu nodes allocated\n", s->c.dirents, s->c.nodes);
+	printf("  cache   :");
+	for (int i = 0; i < STAT_CACHES; i++) {
+		printf(" %s %llu/%llu%s", cache_names[i], s->cache_hits[i], s->cache_misses[i],
+			   i + 1 < STAT_CACHES ? "," : " (hits/misses)\n");
+	}
+}
+
+/**
+ * stats 명령어 구현 함수
+ * stats: 세션 합계와 마지막 명령어 통계 출력, stats reset: 세션 합계를 0부터 다시 셈,
+ * stats on/off: 명령어마다 한 줄 요약 출력을 켜고 끔
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param line 사용자 입력 라인
+ */
+void	stats_command(Ext2Context *ctx, char *line)
+{
+	char *argv[3] = {0};
+	int argc = 0;
+
+	char *token = strtok(line, " \t");
+	while (token != NULL && argc < 3) {
+		argv[argc++] = token;
+		token = strtok(NULL, " \t");
+	}
+	if (argc < 1 || strcmp(argv[0], "stats") != 0 || argc > 2) {
+		help_all();
+		return;
+	}
+
+	if (argc == 2) {
+		if (strcmp(argv[1], "reset") == 0) {
+			stats_snapshot(ctx, &ctx->stats.base);
+			ctx->stats.has_last = false;
+		} else if (strcmp(argv[1], "on") == 0) {
+			ctx->config.stats_summary = true;
+		} else if (strcmp(argv[1], "off") == 0) {
+			ctx->config.stats_summary = false;
+		} else {
+			help_stats();
+		}
+		return;
+	}
+
+	Ext2Stats now;
+	Ext2Stats session;
+	stats_snapshot(ctx, &now);
+	stats_diff(&now, &ctx->stats.base, &session);
+	print_stats("Session", &session);
+	if (ctx->stats.has_last) {
+		print_stats("Last command", &ctx->stats.last);
+	}
+}
@@ -0,0 +1,187 @@
+#include "ssu_ext2.h"
+
+/*
+ * 추적 구간 (--trace=FILE)
+ * 구간은 스레드 지역 버퍼에 쌓고, 탐색 스레드는 끝나기 전에 버퍼를 공유 목록에 넘김
+ * 프로그램이 끝날 때 Chrome trace-event JSON으로 기록 (Perfetto, chrome://tracing에서 열 수 있음)
+ * 추적이 꺼져 있으면 TRACE_BEGIN/TRACE_END는 trace_enabled 분기 하나만 실행
+ */
+bool	trace_enabled;
+
+static __thread TraceBuf	trace_local;
+
+static FILE					*trace_fp;
+static TraceBuf				*trace_flushed;
+static unsigned int			trace_next_tid;
+static unsigned long long	trace_base;
+static pthread_mutex_t		trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * 추적을 시작하는 함수 (다른 스레드를 만들기 전에 메인 스레드에서 호출)
+ *
+ * @param path 추적 이벤트를 기록할 파일 경로
+ * @return 성공 시 0, 파일을 열지 못하면 -1
+ */
+int	trace_open(const char *path)
+{
+	trace_fp = fopen(path, "w");
+	if (trace_fp == NULL) {
+		return -1;
+	}
+	trace_base = stats_now();
+	trace_thread_name("main");
+	trace_enabled = true;
+	return 0;
+}
+
+/**
+ * 현재 스레드의 추적 버퍼에 스레드 번호와 이름을 정하는 함수
+ *
+ * @param name 추적 파일에 표시할 스레드 이름 (정적 문자열)
+ */
+void	trace_thread_name(const char *name)
+{
+	if (trace_local.tid == 0) {
+		trace_local.tid = __atomic_add_fetch(&trace_next_tid, 1, __ATOMIC_RELAXED);
+	}
+	trace_local.thread_name = name;
+}
+
+/**
+ * 현재 스레드의 추적 버퍼에 구간 하나를 넣는 함수 (TRACE_END에서 호출)
+ * 버퍼가 최대 크기에 이르면 구간을 버리고 개수만 셈
+ *
+ * @param name 구간 이름 (정적 문자열)
+ * @param start 구간 시작 시각 (TRACE_BEGIN)
+ * @param k0 첫 번째 인자 이름 (NULL이면 인자 없음)
+ * @param v0 첫 번째 인자 값
+ * @param k1 두 번째 인자 이름 (NULL이면 인자 없음)
+ * @param v1 두 번째 인자 값
+ */
+void	trace_span(const char *name, unsigned long long start,
+				   const char *k0, unsigned long long v0, const char *k1, unsigned long long v1)
+{
+	unsigned long long end = stats_now();
+	TraceBuf *buf = &trace_local;
+
+	if (buf->count == buf->capacity) {
+		size_t capacity = buf->capacity == 0 ? TRACE_BUF_INIT : buf->capacity * 2;
+		if (capacity > TRACE_MAX_EVENTS) {
+			capacity = TRACE_MAX_EVENTS;
+		}
+		TraceEvent *events = capacity > buf->capacity ?
+			(TraceEvent *)realloc(buf->events, capacity * sizeof(TraceEvent)) : NULL;
+		if (events == NULL) {
+			buf->dropped++;
+			return;
+		}
+		buf->events = events;
+		buf->capacity = capacity;
+	}
+	if (buf->tid == 0) {
+		trace_thread_name("walk worker");
+	}
+
+	TraceEvent *ev = &buf->events[buf->count++];
+	ev->name = name;
+	ev->arg_names[0] = k0;
+	ev->arg_names[1] = k1;
+	ev->args[0] = v0;
+	ev->args[1] = v1;
+	ev->start = start;
+	ev->dur = end - start;
+}
+
+/**
+ * 현재 스레드의 추적 버퍼를 공유 목록으로 넘기는 함수 (탐색 스레드가 끝나기 직전에 호출)
+ */
+void	trace_thread_flush(void)
+{
+	if (!trace_enabled || (trace_local.count == 0 && trace_local.dropped == 0)) {
+		return;
+	}
+
+	TraceBuf *buf = (TraceBuf *)malloc(sizeof(TraceBuf));
+	if (buf == NULL) {
+		free(trace_local.events);
+		memset(&trace_local, 0, sizeof(TraceBuf));
+		return;
+	}
+	*buf = trace_local;
+	pthread_mutex_lock(&trace_lock);
+	buf->next = trace_flushed;
+	trace_flushed = buf;
+	pthread_mutex_unlock(&trace_lock);
+	memset(&trace_local, 0, sizeof(TraceBuf));
+}
+
+/**
+ * 추적 버퍼 하나를 JSON 이벤트로 기록하는 함수
+ *
+ * @param fp 추적 파일 포인터
+ * @param buf 기록할 추적 버퍼
+ * @param pid 프로세스 번호
+ */
+static void	write_buf(FILE *fp, const TraceBuf *buf, int pid)
+{
+	fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+			pid, buf->tid, buf->thread_name != NULL ? buf->thread_name : "thread");
+
+	for (size_t i = 0; i < buf->count; i++) {
+		const TraceEvent *ev = &buf->events[i];
+		unsigned long long ts = ev->start >= trace_base ? ev->start - trace_base : 0;
+
+		fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"ssu_ext2\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,"
+				"\"ts\":%llu.%03llu,\"dur\":%llu.%03llu,\"args\":{",
+				ev->name, pid, buf->tid, ts / 1000, ts % 1000, ev->dur / 1000, ev->dur % 1000);
+		for (int k = 0; k < 2; k++) {
+			if (ev->arg_names[k] != NULL) {
+				fprintf(fp, "%s\"%s\":%llu", k > 0 && ev->arg_names[0] != NULL ? "," : "",
+						ev->arg_names[k], ev->args[k]);
+			}
+		}
+		fputs("}}", fp);
+	}
+}
+
+/**
+ * 추적을 끝내고 모든 스레드의 구간을 Chrome trace-event JSON으로 기록하는 함수
+ *
+ * @return 성공 시 0, 추적 중이 아니거나 기록에 실패하면 -1
+ */
+int	trace_close(void)
+{
+	if (!trace_enabled) {
+		return -1;
+	}
+	trace_enabled = false;
+
+	int pid = (int)getpid();
+	unsigned long long dropped = trace_local.dropped;
+
+	fprintf(trace_fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(trace_fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"ssu_ext2\"}}", pid);
+	write_buf(trace_fp, &trace_local, pid);
+	free(trace_local.events);
+	memset(&trace_local, 0, sizeof(TraceBuf));
+
+	while (trace_flushed != NULL) {
+		TraceBuf *buf = trace_flushed;
+		trace_flushed = buf->next;
+		write_buf(trace_fp, buf, pid);
+		dropped += buf->dropped;
+		free(buf->events);
+		free(buf);
+	}
+	fprintf(trace_fp, "\n]}\n");
+
+	int result = ferror(trace_fp) ? -1 : 0;
+	if (fclose(trace_fp) != 0) {
+		result = -1;
+	}
+	trace_fp = NULL;
+	if (dropped > 0) {
+		fprintf(stderr, "trace: %llu spans dropped (buffer full)\n", dropped);
+	}
+	return result;
+}
@@ -1,633 +1,362 @@
 #include "ssu_ext2.h"
 
 /**
-*
-*트리 노드 생성 함수
-*
-*@param name 노드 이름
-*@param inode_num inode 번호
-*@param file_type 파일 타입
-*@param size 파일 크기
-*@param permissions 파일 권한
-*@return 생성된 트리 노드 포인터
-*/
-DirTreeNode*	create_tree_node(const char* name, int inode_num, int file_type, unsigned int size, unsigned int permissions)
-{
-	DirTreeNode* node = (DirTreeNode*)malloc(sizeof(DirTreeNode));
-		
-	strncpy(node->name, name, MAX_FILE_NAME);
-	node->name[MAX_FILE_NAME] = '\0';
-	node->inode_num = inode_num;
-	node->file_type = file_type;
-	node->size = size;
-	node->permissions = permissions;
-	node->first_child = NULL;
-	node->next_sibling = NULL;
-		
-	return node;
-}
-
-/**
-*
-*디렉토리 노드에 자식 노드 추가 함수
-*
-*@param parent 부모 노드 포인터
-*@param child 추가할 자식 노드 포인터
-*/
-void	add_child_node(DirTreeNode* parent, DirTreeNode* child)
-{
-	if (parent == NULL || child == NULL) {
-		return;
-	}
-		
-	if (parent->first_child == NULL) {
-		// 첫 번째 자식이 없으면 바로 추가
-		parent->first_child = child;
-	} else {
-		// 마지막 형제 노드를 찾아서 추가
-		DirTreeNode* sibling = parent->first_child;
-		while (sibling->next_sibling != NULL) {
-			sibling = sibling->next_sibling;
-		}
-		sibling->next_sibling = child;
-	}
-}
-
-/**
-*
-*디렉토리 블록 처리 함수
-*
-*@param fd 파일 디스크립터
-*@param sb 슈퍼블록 포인터
-*@param gd 그룹 디스크립터 배열 포인터
-*@param block_num 처리할 블록 번호
-*@param parent_node 부모 트리 노드 포인터
-*@param recursive 재귀 옵션 플래그
-*@param dir_count 디렉토리 개수 포인터
-*@param file_count 파일 개수 포인터
-*@return 발견된 엔트리 수
-*/
-int	process_directory_block(int fd, struct my_ext2_super_block *sb, 
-						   struct my_ext2_group_desc *gd,
-						   unsigned int block_num, DirTreeNode *parent_node,
-						   int recursive, int *dir_count, int *file_count)
+ * 디렉토리의 모든 엔트리를 읽어서 트리 구조를 구축하는 함수
+ * 디렉토리 스트림으로 직접 블록 및 간접 블록(단일, 이중, 삼중)을 모두 처리
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param dir_inode_num 디렉토리 inode 번호
+ * @param cursor 노드를 만들 트리 쓰기 커서 포인터
+ * @param parent 부모 트리 노드 인덱스
+ * @param recursive 재귀 옵션 플래그
+ * @return 발견된 파일 및 디렉토리 수
+ */
+int	read_directory_entries(Ext2Context *ctx, 
+						  unsigned int dir_inode_num, DirTreeCursor *cursor, 
+						  unsigned int parent, int recursive)
 {
-	int entries_found = 0;
-	unsigned int block_size = get_block_size(sb);
-	unsigned char *block_buf = (unsigned char *)malloc(block_size);
+	DirStream ds;
+	DirStreamEntry entry;
+	int file_count = 0;
+	int dir_count = 0;
+	unsigned long long trace_start = TRACE_BEGIN();
 		
-	#ifdef DEBUG_TREE
-		printf("Reading directory block %u\n", block_num);
-		debug_directory_block(block_buf, block_size);
-	#endif
-
-	// 블록 데이터 읽기
-	if (read_data_block(fd, sb, block_num, block_buf) < 0) {
-		#ifdef DEBUG_TREE
-			printf("Failed to read block %u\n", block_num);
-		#endif
-		free(block_buf);
-		return 0;
+	// 디렉토리 inode 읽기
+	if (dir_stream_open(&ds, ctx, dir_inode_num) < 0) {
+		return -1;
 	}
 		
-	// 블록 내의 디렉토리 엔트리 처리
-	unsigned int offset = 0;
-	while (offset < block_size) {
-		struct my_ext2_dir_entry_2 *entry = 
-			(struct my_ext2_dir_entry_2 *)(block_buf + offset);
-		
-		// 엔트리 종료 확인
-		if (entry->inode == 0 || offset + 8 > block_size) {
-			break;
-		}
-		
-		// 엔트리 이름 추출
-		if (entry->name_len == 0 || entry->name_len > 255 || offset + 8 + entry->name_len > block_size) {
-			// 유효하지 않은 name_len 값이면 다음 위치로 이동
-			offset += 4;  // 최소 간격으로 이동
+	// 엔트리를 디스크 순서대로 꺼내 임시 자식 배열에 모음 (직접/간접 블록 모두 포함)
+	while (dir_stream_next(&ds, &entry)) {
+		if (dir_tree_stage(cursor, entry.name, entry.name_len, entry.inode_num, 
+						   entry.mode, entry.size) < 0) {
 			continue;
 		}
 		
-		char entry_name[MAX_FILE_NAME + 1];
-		memset(entry_name, 0, sizeof(entry_name));
-		strncpy(entry_name, entry->name, entry->name_len);
-		entry_name[entry->name_len] = '\0';
-		
-		#ifdef DEBUG_TREE
-			printf("Found entry in block %u at offset %u: name='%s', inode=%u, rec_len=%u, name_len=%u, file_type=%u\n", 
-			  block_num, offset, entry_name, entry->inode, entry->rec_len, entry->name_len, entry->file_type);
-		#endif
-
-		// ".", "..", "lost+found" 제외
-		if (strcmp(entry_name, ".") != 0 && 
-			strcmp(entry_name, "..") != 0 && 
-			strcmp(entry_name, "lost+found") != 0) {
-			
-			// 엔트리의 inode 정보 읽기
-			struct my_ext2_inode entry_inode;
-			if (read_inode(fd, entry->inode, sb, gd, &entry_inode) == 0) {
-				// 파일 타입 확인
-				int is_dir = S_ISDIR(entry_inode.i_mode);
-				
-				#ifdef DEBUG_TREE
-					printf("Entry %s is %s, mode: %o, size: %u\n", 
-					  entry_name, is_dir ? "directory" : "file", 
-					  entry_inode.i_mode, entry_inode.i_size);
-				#endif
-
-				// 트리 노드 생성
-				DirTreeNode *node = create_tree_node(
-					entry_name, entry->inode, entry_inode.i_mode, 
-					entry_inode.i_size, entry_inode.i_mode & 0xFFF
-				);
-				
-				if (node != NULL) {
-					// 부모 노드에 추가
-					add_child_node(parent_node, node);
-					
-					// 파일/디렉토리 카운트 증가
-					if (is_dir) {
-						(*dir_count)++;
-						
-						// 재귀 옵션이 켜져 있고 디렉토리인 경우 하위 디렉토리 처리
-						if (recursive) {
-							int sub_result = read_directory_entries(
-								fd, sb, gd, entry->inode, node, recursive);
-						}
-					} else {
-						(*file_count)++;
-					}
-					
-					entries_found++;
-				}
-			}
+		// 파일/디렉토리 카운트 증가
+		if (S_ISDIR(entry.mode)) {
+			dir_count++;
+		} else {
+			file_count++;
 		}
+	}
+	dir_stream_close(&ds);
 		
-		// 다음 엔트리로 이동
-		// 디렉토리 엔트리의 실제 필요 크기 계산
-		unsigned int real_size = 8 + entry->name_len;  // 기본 헤더(8바이트) + 이름 길이
-		real_size = (real_size + 3) & ~3;  // 4바이트 정렬
-		
-		// 다음 엔트리가 있는지 확인
-		if (entry->rec_len > real_size + 8 && offset + real_size < block_size) {
-			// 실제 크기 이후 위치에서 다음 엔트리 확인
-			struct my_ext2_dir_entry_2 *next = 
-				(struct my_ext2_dir_entry_2 *)(block_buf + offset + real_size);
-			
-			// 다음 위치에 유효한 엔트리가 있는지 확인
-			if (next->inode > 0 && next->inode < sb->s_inodes_count &&
-				next->rec_len >= 8 && next->rec_len <= block_size - (offset + real_size) &&
-				next->name_len > 0 && next->name_len <= 255) {
-				// 다음 엔트리가 유효하면 실제 크기만큼만 이동
-				#ifdef DEBUG_TREE
-					printf("Found hidden entry after %s at offset %u\n", 
-					  entry_name, offset + real_size);
-				#endif
-
-				offset += real_size;
-			} else {
-				// 다음 엔트리가 유효하지 않으면 rec_len 값 사용
-				offset += entry->rec_len;
+	// 모은 자식들을 연속된 구간으로 옮겨 부모에 연결 (자식 하나당 O(1))
+	unsigned int first_child = dir_tree_commit(cursor, parent);
+		
+	// 재귀 옵션이 켜져 있으면 하위 디렉토리 처리 (임시 배열을 비운 뒤라 재사용 가능)
+	if (recursive && first_child != TREE_NIL) {
+		unsigned int child_count = dir_tree_node(cursor->tree, parent)->child_count;
+		for (unsigned int i = 0; i < child_count; i++) {
+			const DirTreeNode *child = dir_tree_node(cursor->tree, first_child + i);
+			if (S_ISDIR(child->mode)) {
+				read_directory_entries(ctx, child->inode_num, cursor, first_child + i, recursive);
 			}
-		} else {
-			// 다음 엔트리가 없거나 rec_len이 적절한 경우
-			offset += entry->rec_len;
 		}
 	}
 		
-	free(block_buf);
-	return entries_found;
+	#ifdef DEBUG_TREE
+		printf("Directory %u total: %d directories, %d files\n", 
+		  dir_inode_num, dir_count, file_count);
+	#endif
+
+	TRACE_END("read_directory_entries", trace_start, "inode", dir_inode_num, "entries", dir_count + file_count);
+	return dir_count + file_count;
 }
 
 /**
-*단일 간접 블록 처리 함수
-*
-*@param fd 파일 디스크립터
-*@param sb 슈퍼블록 포인터
-*@param gd 그룹 디스크립터 배열 포인터
-*@param indirect_block_num 단일 간접 블록 번호
-*@param parent_node 부모 트리 노드 포인터
-*@param recursive 재귀 옵션 플래그
-*@param dir_count 디렉토리 개수 포인터
-*@param file_count 파일 개수 포인터
-*@return 발견된 엔트리 수
-*/
-int	process_indirect_block(int fd, struct my_ext2_super_block *sb, 
-						  struct my_ext2_group_desc *gd,
-						  unsigned int indirect_block_num, DirTreeNode *parent_node,
-						  int recursive, int *dir_count, int *file_count)
+ * 옵션에 따른 추가 정보 ([권한 크기]) 출력 함수
+ * 
+ * @param out 출력 버퍼 포인터
+ * @param options 출력 옵션 (TREE_OPT_S, TREE_OPT_P)
+ * @param mode 파일 모드
+ * @param size 파일 크기
+ */
+static void	print_tree_attrs(OutBuf *out, int options, unsigned int mode, unsigned int size)
 {
-	int entries_found = 0;
-	unsigned int block_size = get_block_size(sb);
-	unsigned char *block_buf = (unsigned char *)malloc(block_size);
-		
-	#ifdef DEBUG_TREE
-		printf("Processing single indirect block %u\n", indirect_block_num);
-	#endif
-
-	// 간접 블록 데이터 읽기
-	if (read_data_block(fd, sb, indirect_block_num, block_buf) < 0) {
-		free(block_buf);
-		return 0;
+	if (!(options & TREE_OPT_P) && !(options & TREE_OPT_S)) {
+		return;
 	}
 		
-	// 간접 블록에서 블록 번호 배열 읽기
-	unsigned int *block_ptrs = (unsigned int *)block_buf;
-	unsigned int ptrs_per_block = block_size / sizeof(unsigned int);
+	out_buf_char(out, '[');
+		
+	// -p 옵션: 파일 타입과 권한 정보 출력 (권한 테이블에서 복사)
+	if (options & TREE_OPT_P) {
+		out_buf_mode(out, mode);
 		
-	// 각 블록 번호에 대해 디렉토리 블록 처리
-	for (unsigned int i = 0; i < ptrs_per_block; i++) {
-		if (block_ptrs[i] == 0) {
-			continue;  // 빈 포인터 건너뛰기
+		// 권한과 크기 사이 공백
+		if (options & TREE_OPT_S) {
+			out_buf_char(out, ' ');
 		}
+	}
 		
-		entries_found += process_directory_block(fd, sb, gd, block_ptrs[i], 
-											   parent_node, recursive, dir_count, file_count);
+	// -s 옵션: 크기 정보 출력
+	if (options & TREE_OPT_S) {
+		out_buf_uint(out, size);
 	}
 		
-	free(block_buf);
-	return entries_found;
+	out_buf_write(out, "] ", 2);
 }
 
 /**
-*이중 간접 블록 처리 함수
-*
-*@param fd 파일 디스크립터
-*@param sb 슈퍼블록 포인터
-*@param gd 그룹 디스크립터 배열 포인터
-*@param double_indirect_block_num 이중 간접 블록 번호
-*@param parent_node 부모 트리 노드 포인터
-*@param recursive 재귀 옵션 플래그
-*@param dir_count 디렉토리 개수 포인터
-*@param file_count 파일 개수 포인터
-*@return 발견된 엔트리 수
-*/
-int	process_double_indirect_block(int fd, struct my_ext2_super_block *sb, 
-								 struct my_ext2_group_desc *gd,
-								 unsigned int double_indirect_block_num, 
-								 DirTreeNode *parent_node, int recursive, 
-								 int *dir_count, int *file_count)
+ * 접두사 상태 초기화 함수
+ * 
+ * @param prefix 초기화할 접두사 상태 포인터
+ */
+void	tree_prefix_init(TreePrefix *prefix)
 {
-	int entries_found = 0;
-	unsigned int block_size = get_block_size(sb);
-	unsigned char *block_buf = (unsigned char *)malloc(block_size);
-		
-	#ifdef DEBUG_TREE
-		printf("Processing double indirect block %u\n", double_indirect_block_num);
-	#endif
-
-	// 이중 간접 블록 데이터 읽기
-	if (read_data_block(fd, sb, double_indirect_block_num, block_buf) < 0) {
-		free(block_buf);
-		return 0;
-	}
-		
-	// 이중 간접 블록에서 단일 간접 블록 번호 배열 읽기
-	unsigned int *indirect_block_ptrs = (unsigned int *)block_buf;
-	unsigned int ptrs_per_block = block_size / sizeof(unsigned int);
-		
-	// 각 단일 간접 블록 번호에 대해 처리
-	for (unsigned int i = 0; i < ptrs_per_block; i++) {
-		if (indirect_block_ptrs[i] == 0) {
-			continue;  // 빈 포인터 건너뛰기
-		}
-		
-		entries_found += process_indirect_block(fd, sb, gd, indirect_block_ptrs[i], 
-											  parent_node, recursive, dir_count, file_count);
-	}
-		
-	free(block_buf);
-	return entries_found;
+	memset(prefix, 0, sizeof(TreePrefix));
 }
 
 /**
-*삼중 간접 블록 처리 함수
-*
-*@param fd 파일 디스크립터
-*@param sb 슈퍼블록 포인터
-*@param gd 그룹 디스크립터 배열 포인터
-*@param triple_indirect_block_num 삼중 간접 블록 번호
-*@param parent_node 부모 트리 노드 포인터
-*@param recursive 재귀 옵션 플래그
-*@param dir_count 디렉토리 개수 포인터
-*@param file_count 파일 개수 포인터
-*@return 발견된 엔트리 수
-*/
-int	process_triple_indirect_block(int fd, struct my_ext2_super_block *sb, 
-								 struct my_ext2_group_desc *gd,
-								 unsigned int triple_indirect_block_num, 
-								 DirTreeNode *parent_node, int recursive, 
-								 int *dir_count, int *file_count)
+ * 접두사 상태 정리 함수
+ * 
+ * @param prefix 정리할 접두사 상태 포인터
+ */
+void	tree_prefix_destroy(TreePrefix *prefix)
 {
-	int entries_found = 0;
-	unsigned int block_size = get_block_size(sb);
-	unsigned char *block_buf = (unsigned char *)malloc(block_size);
-		
-	#ifdef DEBUG_TREE
-		printf("Processing triple indirect block %u\n", triple_indirect_block_num);
-	#endif
+	free(prefix->open);
+	prefix->open = NULL;
+	prefix->capacity = 0;
+}
 
-	// 삼중 간접 블록 데이터 읽기
-	if (read_data_block(fd, sb, triple_indirect_block_num, block_buf) < 0) {
-		free(block_buf);
+/**
+ * 접두사 배열이 depth 깊이까지 담을 수 있도록 늘리는 함수 (두 배씩)
+ * 
+ * @param prefix 접두사 상태 포인터
+ * @param depth 기록할 깊이
+ * @return 성공 시 0, 메모리 부족 시 -1 (prefix->failed 설정)
+ */
+static int	tree_prefix_reserve(TreePrefix *prefix, unsigned int depth)
+{
+	if (depth < prefix->capacity) {
 		return 0;
 	}
-		
-	// 삼중 간접 블록에서 이중 간접 블록 번호 배열 읽기
-	unsigned int *double_indirect_block_ptrs = (unsigned int *)block_buf;
-	unsigned int ptrs_per_block = block_size / sizeof(unsigned int);
-		
-	// 각 이중 간접 블록 번호에 대해 처리
-	for (unsigned int i = 0; i < ptrs_per_block; i++) {
-		if (double_indirect_block_ptrs[i] == 0) {
-			continue;  // 빈 포인터 건너뛰기
-		}
-		
-		entries_found += process_double_indirect_block(fd, sb, gd, double_indirect_block_ptrs[i], 
-													 parent_node, recursive, dir_count, file_count);
+
+	unsigned int capacity = prefix->capacity == 0 ? TREE_PREFIX_INIT_DEPTH : prefix->capacity;
+	while (capacity <= depth) {
+		capacity *= 2;
 	}
-		
-	free(block_buf);
-	return entries_found;
+	unsigned char *grown = (unsigned char *)realloc(prefix->open, capacity);
+	if (grown == NULL) {
+		prefix->failed = true;
+		return -1;
+	}
+	prefix->open = grown;
+	prefix->capacity = capacity;
+	return 0;
 }
 
 /**
- * 디렉토리의 모든 엔트리를 읽어서 트리 구조를 구축하는 함수
- * 직접 블록 및 간접 블록(단일, 이중, 삼중)을 모두 처리
+ * 트리 한 줄 (접두사, 연결 기호, 추가 정보, 이름) 출력 함수
+ * 출력 후 다음 레벨을 위해 prefix의 depth 칸을 갱신 (호출 전에 tree_prefix_reserve로 확보)
  * 
- * @param fd 파일 디스크립터
- * @param sb 슈퍼블록 포인터
- * @param gd 그룹 디스크립터 포인터
- * @param dir_inode_num 디렉토리 inode 번호
- * @param parent_node 부모 트리 노드 포인터
- * @param recursive 재귀 옵션 플래그
- * @return 발견된 파일 및 디렉토리 수
+ * @param out 출력 버퍼 포인터
+ * @param depth 항목의 깊이 (들여쓰기 수준)
+ * @param options 출력 옵션
+ * @param is_last 현재 항목이 부모의 마지막 자식인지 여부
+ * @param prefix 들여쓰기 및 연결선을 위한 접두사 상태
+ * @param mode 파일 모드
+ * @param size 파일 크기
+ * @param name 이름 (NUL 종료되지 않아도 됨)
+ * @param name_len 이름 길이
  */
-int	read_directory_entries(int fd, struct my_ext2_super_block *sb, 
-						  struct my_ext2_group_desc *gd,
-						  unsigned int dir_inode_num, DirTreeNode *parent_node, 
-						  int recursive)
+static void	print_tree_line(OutBuf *out, int depth, int options, int is_last, TreePrefix *prefix,
+							unsigned int mode, unsigned int size, const char *name, unsigned int name_len)
 {
-	struct my_ext2_inode dir_inode;
-	int file_count = 0;
-	int dir_count = 0;
-		
-	// 디렉토리 inode 읽기
-	if (read_inode(fd, dir_inode_num, sb, gd, &dir_inode) < 0) {
-		return -1;
+	// 들여쓰기와 트리 라인 출력
+	for (int i = 0; i < depth; i++) {
+		out_buf_str(out, prefix->open[i] ? "┃ " : "  ");
 	}
 		
-	#ifdef DEBUG_TREE
-		printf("Processing directory inode %u with %u blocks\n", dir_inode_num, dir_inode.i_blocks);
-	#endif
-
-	// 직접 블록 처리 (i_block[0] ~ i_block[11])
-	int direct_entries = 0;
-	for (int i = 0; i < EXT2_NDIR_BLOCKS; i++) {
-		if (dir_inode.i_block[i] == 0) {
-			continue;  // 빈 블록 건너뛰기
-		}
-		
-		direct_entries += process_directory_block(fd, sb, gd, dir_inode.i_block[i], 
-												parent_node, recursive, &dir_count, &file_count);
-	}
-
-	#ifdef DEBUG_TREE
-		printf("Found %d entries in direct blocks\n", direct_entries);
-	#endif
-
-	// 단일 간접 블록 처리 (i_block[12])
-	int single_indirect_entries = 0;
-	if (dir_inode.i_block[EXT2_IND_BLOCK] != 0) {
-		single_indirect_entries = process_indirect_block(fd, sb, gd, dir_inode.i_block[EXT2_IND_BLOCK], 
-													   parent_node, recursive, &dir_count, &file_count);
-		#ifdef DEBUG_TREE
-			printf("Found %d entries in single indirect block\n", single_indirect_entries);
-		#endif
-	}
+	// 현재 항목 연결 기호 (마지막이면 ┗, 아니면 ┣)
+	out_buf_str(out, is_last ? "┗ " : "┣ ");
 		
-	// 이중 간접 블록 처리 (i_block[13])
-	int double_indirect_entries = 0;
-	if (dir_inode.i_block[EXT2_DIND_BLOCK] != 0) {
-		double_indirect_entries = process_double_indirect_block(fd, sb, gd, dir_inode.i_block[EXT2_DIND_BLOCK], 
-															  parent_node, recursive, &dir_count, &file_count);
-		#ifdef DEBUG_TREE
-			printf("Found %d entries in double indirect blocks\n", double_indirect_entries);
-		#endif
-	}
+	// 옵션에 따른 추가 정보 출력
+	print_tree_attrs(out, options, mode, size);
 		
-	// 삼중 간접 블록 처리 (i_block[14])
-	int triple_indirect_entries = 0;
-	if (dir_inode.i_block[EXT2_TIND_BLOCK] != 0) {
-		triple_indirect_entries = process_triple_indirect_block(fd, sb, gd, dir_inode.i_block[EXT2_TIND_BLOCK], 
-															  parent_node, recursive, &dir_count, &file_count);
-		#ifdef DEBUG_TREE
-			printf("Found %d entries in triple indirect blocks\n", triple_indirect_entries);
-		#endif
-	}
+	// 이름 출력
+	out_buf_write(out, name, name_len);
+	out_buf_char(out, '\n');
 		
-	#ifdef DEBUG_TREE
-		printf("Directory %u total: %d directories, %d files\n", 
-		  dir_inode_num, dir_count, file_count);
-	#endif
-
-	return dir_count + file_count;
+	// 다음 레벨의 자식 노드들에 대한 접두사 업데이트
+	// 마지막 항목이면 다음 레벨은 "  " (빈 공간), 아니면 "┃ " (수직선)
+	prefix->open[depth] = is_last ? 0 : 1;
 }
 
 /**
  * 트리 노드 출력 함수
  * 
- * @param node 출력할 노드
+ * @param out 출력 버퍼 포인터
+ * @param tree 트리 저장소 포인터
+ * @param index 출력할 노드 인덱스
  * @param depth 노드의 깊이 (들여쓰기 수준)
  * @param options 출력 옵션 (TREE_OPT_R, TREE_OPT_S, TREE_OPT_P)
  * @param is_last 현재 노드가 부모의 마지막 자식인지 여부
- * @param prefix 들여쓰기 및 연결선을 위한 접두사 배열
+ * @param prefix 들여쓰기 및 연결선을 위한 접두사 상태 (깊이에 맞춰 늘어남)
  */
-void	print_tree_node(DirTreeNode* node, int depth, int options, int is_last, char prefix[1024][10])
+void	print_tree_node(OutBuf *out, const DirTree *tree, unsigned int index, int depth, int options, int is_last, TreePrefix *prefix)
 {
-	if (node == NULL) {
+	if (index == TREE_NIL || tree_prefix_reserve(prefix, (unsigned int)depth) < 0) {
 		return;
 	}
+	const DirTreeNode* node = dir_tree_node(tree, index);
 		
-	// 들여쓰기와 트리 라인 출력
-	for (int i = 0; i < depth; i++) {
-		printf("%s", prefix[i]);
-	}
+	// 노드 한 줄 출력 (이름 풀의 이름은 NUL 종료되지 않음)
+	print_tree_line(out, depth, options, is_last, prefix, node->mode, node->size,
+					dir_tree_name(tree, node), node->name_len);
 		
-	// 현재 항목 연결 기호 (마지막이면 ┗, 아니면 ┣)
-	printf("%s ", is_last ? "┗" : "┣");
+	// 재귀 옵션이 꺼져 있고 루트 노드가 아니면 자식 노드를 출력하지 않음
+	if (!(options & TREE_OPT_R) && depth > 0) {
+		return;
+	}
 		
-	// 옵션에 따른 추가 정보 출력
-	if ((options & TREE_OPT_P) || (options & TREE_OPT_S)) {
-		printf("[");
-		
-		// -p 옵션: 권한 정보 출력
-		if (options & TREE_OPT_P) {
-			// 파일 타입
-			if (S_ISDIR(node->file_type)) printf("d");
-			else if (S_ISLNK(node->file_type)) printf("l");
-			else printf("-");
-			
-			// 소유자 권한
-			printf("%c%c%c", 
-				(node->permissions & S_IRUSR) ? 'r' : '-',
-				(node->permissions & S_IWUSR) ? 'w' : '-',
-				(node->permissions & S_IXUSR) ? 'x' : '-'
-			);
-			
-			// 그룹 권한
-			printf("%c%c%c", 
-				(node->permissions & S_IRGRP) ? 'r' : '-',
-				(node->permissions & S_IWGRP) ? 'w' : '-',
-				(node->permissions & S_IXGRP) ? 'x' : '-'
-			);
-			
-			// 기타 사용자 권한
-			printf("%c%c%c", 
-				(node->permissions & S_IROTH) ? 'r' : '-',
-				(node->permissions & S_IWOTH) ? 'w' : '-',
-				(node->permissions & S_IXOTH) ? 'x' : '-'
-			);
-			
-			// 권한과 크기 사이 공백
-			if (options & TREE_OPT_S) {
-				printf(" ");
-			}
+	// 자식 노드 출력
+	if (S_ISDIR(node->mode)) {
+		// 자식은 연속된 구간이고 개수가 저장되어 있으므로 바로 출력
+		unsigned int first_child = node->first_child;
+		unsigned int child_count = node->child_count;
+		for (unsigned int i = 0; i < child_count; i++) {
+			print_tree_node(out, tree, first_child + i, depth + 1, options, (i + 1 == child_count), prefix);
 		}
+	}
+}
+
+/**
+ * 트리를 만들지 않고 엔트리를 읽는 대로 출력하는 함수 (--tree-stream)
+ * 깊이마다 디렉토리 스트림 하나와 미리 읽은 엔트리 하나만 유지하므로 메모리는 트리 깊이에 비례
+ * 미리 읽은 다음 엔트리가 없으면 현재 엔트리가 마지막 자식 (┗)
+ * 
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param dir_inode_num 시작 디렉토리 inode 번호
+ * @param options 출력 옵션 (TREE_OPT_R, TREE_OPT_S, TREE_OPT_P)
+ * @param prefix 들여쓰기 및 연결선을 위한 접두사 상태 (깊이 상태 배열과 함께 늘어남)
+ * @param file_count 파일 개수를 저장할 포인터
+ * @param dir_count 디렉토리 개수를 저장할 포인터
+ * @return 성공 시 0, 메모리 부족 시 음수 값 반환
+ */
+static int	print_tree_stream(Ext2Context *ctx, unsigned int dir_inode_num, int options, TreePrefix *prefix,
+							  int *file_count, int *dir_count)
+{
+	unsigned int capacity = TREE_STREAM_INIT_DEPTH;
+	unsigned int depth = 0;
+	DirStreamEntry cur;
 		
-		// -s 옵션: 크기 정보 출력
-		if (options & TREE_OPT_S) {
-			printf("%u", node->size);
-		}
+	TreeStreamLevel *levels = (TreeStreamLevel *)malloc(capacity * sizeof(TreeStreamLevel));
+	if (levels == NULL) {
+		return -1;
+	}
 		
-		printf("] ");
+	// 시작 디렉토리 스트림을 열고 첫 엔트리를 미리 읽음
+	if (dir_stream_open(&levels[0].ds, ctx, dir_inode_num) < 0) {
+		free(levels);
+		return 0;
+	}
+	levels[0].has_ahead = dir_stream_next(&levels[0].ds, &levels[0].ahead);
+	depth = 1;
+	if (tree_prefix_reserve(prefix, capacity) < 0) {
+		dir_stream_close(&levels[0].ds);
+		free(levels);
+		return -1;
 	}
 		
-	// 노드 이름 출력
-	printf("%s\n", node->name);
+	while (depth > 0) {
+		TreeStreamLevel *level = &levels[depth - 1];
 		
-	// 다음 레벨의 자식 노드들에 대한 접두사 업데이트
-	if (is_last) {
-		// 마지막 항목이면 다음 레벨은 "  " (빈 공간)
-		strcpy(prefix[depth], "  ");
-	} else {
-		// 마지막 항목이 아니면 다음 레벨은 "┃ " (수직선)
-		strcpy(prefix[depth], "┃ ");
-	}
+		// 이 디렉토리의 엔트리를 다 출력했으면 상위 디렉토리로 복귀
+		if (!level->has_ahead) {
+			dir_stream_close(&level->ds);
+			depth--;
+			continue;
+		}
 		
-	// 재귀 옵션이 꺼져 있고 루트 노드가 아니면 자식 노드를 출력하지 않음
-	if (!(options & TREE_OPT_R) && depth > 0) {
-		// 접두사 원복
-		prefix[depth][0] = '\0';
-		return;
-	}
+		// 현재 엔트리를 꺼내고 다음 엔트리를 미리 읽어서 마지막 자식인지 판단
+		cur = level->ahead;
+		level->has_ahead = dir_stream_next(&level->ds, &level->ahead);
+		print_tree_line(&ctx->out, depth - 1, options, !level->has_ahead, prefix,
+						cur.mode, cur.size, cur.name, cur.name_len);
 		
-	// 자식 노드 출력
-	if (S_ISDIR(node->file_type)) {
-		DirTreeNode* child = node->first_child;
-		DirTreeNode* next;
-		
-		// 자식 노드 개수 계산
-		int child_count = 0;
-		DirTreeNode* temp = child;
-		while (temp != NULL) {
-			child_count++;
-			temp = temp->next_sibling;
+		// 파일/디렉토리 카운트 증가
+		if (!S_ISDIR(cur.mode)) {
+			(*file_count)++;
+			continue;
 		}
+		(*dir_count)++;
 		
-		// 각 자식 노드 처리
-		int current = 0;
-		while (child != NULL) {
-			current++;
-			next = child->next_sibling;
-			print_tree_node(child, depth + 1, options, (current == child_count), prefix);
-			child = next;
+		// 재귀 옵션이 켜져 있으면 하위 디렉토리로 내려감 (깊이 상태와 접두사 배열을 함께 늘림)
+		if (!(options & TREE_OPT_R)) {
+			continue;
+		}
+		if (depth == capacity) {
+			TreeStreamLevel *grown = (TreeStreamLevel *)realloc(levels, capacity * 2 * sizeof(TreeStreamLevel));
+			if (grown != NULL) {
+				levels = grown;
+			}
+			if (grown == NULL || tree_prefix_reserve(prefix, capacity * 2) < 0) {
+				while (depth > 0) {
+					dir_stream_close(&levels[--depth].ds);
+				}
+				free(levels);
+				return -1;
+			}
+			capacity *= 2;
+		}
+		if (dir_stream_open(&levels[depth].ds, ctx, cur.inode_num) < 0) {
+			continue;
 		}
+		levels[depth].has_ahead = dir_stream_next(&levels[depth].ds, &levels[depth].ahead);
+		depth++;
 	}
 		
-	// 접두사 원복 (함수를 빠져나갈 때)
-	prefix[depth][0] = '\0';
+	free(levels);
+	return 0;
 }
 
 /**
-*트리 노드 메모리 해제 함수
-*
-*@param node 메모리를 해제할 트리 노드 포인터
-*/
-void	free_tree_node(DirTreeNode* node)
+ * 디렉토리/파일 개수 요약 줄을 출력하고 출력 버퍼를 비우는 함수 (tree 출력의 끝)
+ * 
+ * @param out 출력 버퍼 포인터
+ * @param dir_count 디렉토리 개수 (시작 디렉토리 포함)
+ * @param file_count 파일 개수
+ */
+static void	print_tree_summary(OutBuf *out, int dir_count, int file_count)
 {
-	if (node == NULL) {
-		return;
-	}
-		
-	// 자식 노드 메모리 해제
-	DirTreeNode* child = node->first_child;
-	while (child != NULL) {
-		DirTreeNode* next = child->next_sibling;
-		free_tree_node(child);
-		child = next;
-	}
-		
-	// 자신의 메모리 해제
-	free(node);
+	out_buf_char(out, '\n');
+	out_buf_int(out, dir_count);
+	out_buf_str(out, " directories, ");
+	out_buf_int(out, file_count);
+	out_buf_str(out, " files\n\n");
+	out_buf_flush(out);
 }
 
 /**
  * 트리 구조 출력을 위한 주 함수
  *
+ * @param ctx 이미지 컨텍스트 포인터
  * @param cmd 명령어 구조체 포인터
  */
-void	tree(Command *cmd)
+void	tree(Ext2Context *ctx, Command *cmd)
 {
-	int fd = open(img_path, O_RDONLY);
-		
-	struct my_ext2_super_block sb;
-	if (read_super_block(fd, &sb) < 0) {
-		#ifdef DEBUG_TREE
-			fprintf(stderr, "Error reading superblock\n");
-		#endif
-		close(fd);
-		return;
-	}
-		
-	// 블록 그룹 디스크립터 읽기
-	int block_size = get_block_size(&sb);
-	int block_groups_count = (sb.s_blocks_count + sb.s_blocks_per_group - 1) 
-							/ sb.s_blocks_per_group;
-		
-	int gdt_size = block_groups_count * sizeof(struct my_ext2_group_desc);
-	struct my_ext2_group_desc *gd = (struct my_ext2_group_desc *)malloc(gdt_size);
-		
-	off_t gdt_offset = (sb.s_first_data_block + 1) * block_size;
-	lseek(fd, gdt_offset, SEEK_SET);
-		
-	read(fd, gd, gdt_size);
-		
 	// 경로의 inode 번호 찾기
-	unsigned int inode_num = path_to_inode(fd, &sb, gd, cmd->path);
+	unsigned int inode_num = path_to_inode(ctx, cmd->path);
 	if (inode_num == 0) {
 		help_all();
-		free(gd);
-		close(fd);
 		return;
 	}
 		
 	// inode 정보 읽기
 	struct my_ext2_inode inode;
-	if (read_inode(fd, inode_num, &sb, gd, &inode) < 0) {
+	if (read_inode(ctx, inode_num, &inode) < 0) {
 		#ifdef DEBUG_TREE
 			fprintf(stderr, "Error: Failed to read inode\n");
 		#endif
-		free(gd);
-		close(fd);
 		return;
 	}
 		
 	// 디렉토리 확인
 	if (!S_ISDIR(inode.i_mode)) {
 		fprintf(stdout, "Error: '%s' is not directory\n", cmd->path);
-		free(gd);
-		close(fd);
 		return;
 	}
 		
@@ -637,130 +366,135 @@ void	tree(Command *cmd)
 	if (strcmp(cmd->path, ".") == 0) {
 		root_name = ".";
 	}
-		
-	DirTreeNode* root = create_tree_node(root_name, inode_num, inode.i_mode, inode.i_size, inode.i_mode & 0xFFF);
-	if (root == NULL) {
+
+	// --tree-stream: 트리를 만들지 않고 읽는 대로 출력 (스레드 수, 아레나 설정은 사용하지 않음)
+	if (ctx->config.tree_stream) {
+		print_tree_attrs(&ctx->out, cmd->options, inode.i_mode, inode.i_size);
+		out_buf_str(&ctx->out, root_name);
+		out_buf_char(&ctx->out, '\n');
+		out_buf_flush(&ctx->out);
+
+		// 읽기와 출력이 섞여 있으므로 요약 줄 전까지는 walk 단계로 잡음
+		// 메모리가 모자라 끝까지 내려가지 못했으면 개수가 틀리므로 요약 줄 대신 오류를 알림
+		TreePrefix prefix;
+		int file_count = 0;
+		int dir_count = 0;
+		tree_prefix_init(&prefix);
+		unsigned long long phase_start = stats_now();
+		int result = print_tree_stream(ctx, inode_num, cmd->options, &prefix, &file_count, &dir_count);
+		stats_phase_add(STAT_PHASE_WALK, phase_start);
+		tree_prefix_destroy(&prefix);
+		if (result < 0) {
+			out_buf_flush(&ctx->out);
+			fprintf(stderr, "Error: out of memory while printing '%s'\n", cmd->path);
+			return;
+		}
+		phase_start = stats_now();
+		print_tree_summary(&ctx->out, dir_count + 1, file_count);
+		stats_phase_add(STAT_PHASE_RENDER, phase_start);
+		return;
+	}
+
+	// 이 명령어의 노드 세그먼트와 이름 풀은 아레나 하나가 소유 (출력 후 한 번에 해제)
+	Arena arena;
+	DirTree dir_tree;
+	DirTreeCursor cursor;
+	arena_init(&arena, ctx->config.arena_chunk_bytes);
+	dir_tree_init(&dir_tree, &arena);
+	dir_tree_cursor_init(&cursor, &dir_tree);
+		
+	unsigned int root_index = dir_tree_add(&cursor, root_name, strlen(root_name), inode_num, inode.i_mode, inode.i_size);
+	if (root_index == TREE_NIL) {
 		#ifdef DEBUG_TREE
 			fprintf(stderr, "Error: Failed to create root tree node\n");
 		#endif
-		free(gd);
-		close(fd);
+		dir_tree_cursor_destroy(&cursor);
+		dir_tree_destroy(&dir_tree);
+		arena_release(&arena);
 		return;
 	}
 		
-	// 디렉토리 내용 읽기
-	read_directory_entries(fd, &sb, gd, inode_num, root, cmd->options & TREE_OPT_R);
-		
-	 // 루트 경로 출력 (옵션에 따라 추가 정보 포함)
-	if ((cmd->options & TREE_OPT_P) || (cmd->options & TREE_OPT_S)) {
-		printf("[");
-		
-		// -p 옵션: 권한 정보 출력
-		if (cmd->options & TREE_OPT_P) {
-			// 파일 타입
-			if (S_ISDIR(root->file_type)) printf("d");
-			else if (S_ISLNK(root->file_type)) printf("l");
-			else printf("-");
-			
-			// 소유자 권한
-			printf("%c%c%c", 
-				(root->permissions & S_IRUSR) ? 'r' : '-',
-				(root->permissions & S_IWUSR) ? 'w' : '-',
-				(root->permissions & S_IXUSR) ? 'x' : '-'
-			);
-			
-			// 그룹 권한
-			printf("%c%c%c", 
-				(root->permissions & S_IRGRP) ? 'r' : '-',
-				(root->permissions & S_IWGRP) ? 'w' : '-',
-				(root->permissions & S_IXGRP) ? 'x' : '-'
-			);
-			
-			// 기타 사용자 권한
-			printf("%c%c%c", 
-				(root->permissions & S_IROTH) ? 'r' : '-',
-				(root->permissions & S_IWOTH) ? 'w' : '-',
-				(root->permissions & S_IXOTH) ? 'x' : '-'
-			);
-			
-			// 권한과 크기 사이 공백
-			if (cmd->options & TREE_OPT_S) {
-				printf(" ");
-			}
-		}
-		
-		// -s 옵션: 크기 정보 출력
-		if (cmd->options & TREE_OPT_S) {
-			printf("%u", root->size);
-		}
-		
-		printf("] ");
+	// 디렉토리 내용 읽기 (-r이면 설정된 스레드 수로 하위 디렉토리까지 탐색)
+	unsigned long long phase_start = stats_now();
+	if (cmd->options & TREE_OPT_R) {
+		walk_directory_tree(ctx, inode_num, &dir_tree, root_index);
+	} else {
+		read_directory_entries(ctx, inode_num, &cursor, root_index, 0);
 	}
+	stats_phase_add(STAT_PHASE_WALK, phase_start);
+	phase_start = stats_now();
+	const DirTreeNode* root = dir_tree_node(&dir_tree, root_index);
 		
-	printf("%s\n", root_name);
+	 // 루트 경로 출력 (옵션에 따라 추가 정보 포함)
+	print_tree_attrs(&ctx->out, cmd->options, root->mode, root->size);
+	out_buf_str(&ctx->out, root_name);
+	out_buf_char(&ctx->out, '\n');
 		
-	// 트리 접두사 배열 초기화
-	char prefix[1024][10] = {{0}};
+	// 트리 접두사 상태 초기화 (트리 깊이만큼 늘어남)
+	TreePrefix prefix;
+	tree_prefix_init(&prefix);
 		
 	// 자식 노드 출력
-	DirTreeNode* child = root->first_child;
-	DirTreeNode* next;
-		
-	// 자식 노드 개수 계산
-	int child_count = 0;
-	DirTreeNode* temp = child;
-	while (temp != NULL) {
-		child_count++;
-		temp = temp->next_sibling;
-	}
-		
-	// 각 자식 노드 처리
-	int current = 0;
-	while (child != NULL) {
-		current++;
-		next = child->next_sibling;
-		print_tree_node(child, 0, cmd->options, (current == child_count), prefix);
-		child = next;
+	unsigned int first_child = root->first_child;
+	unsigned int child_count = root->child_count;
+	for (unsigned int i = 0; i < child_count; i++) {
+		print_tree_node(&ctx->out, &dir_tree, first_child + i, 0, cmd->options, (i + 1 == child_count), &prefix);
 	}
 		
 	// 파일과 디렉토리 개수 계산
 	int file_count = 0;
 	int dir_count = 0;
-	count_files_and_dirs(root, &file_count, &dir_count);
+	count_files_and_dirs(&dir_tree, root_index, &file_count, &dir_count);
 		
-	// 결과 출력
-	printf("\n%d directories, %d files\n\n", dir_count + 1, file_count);
+	// 결과 출력 (접두사 배열을 늘리지 못해 일부를 출력하지 못했으면 요약 줄 대신 오류를 알림)
+	if (prefix.failed) {
+		out_buf_flush(&ctx->out);
+		fprintf(stderr, "Error: out of memory while printing '%s'\n", cmd->path);
+	} else {
+		print_tree_summary(&ctx->out, dir_count + 1, file_count);
+	}
+	tree_prefix_destroy(&prefix);
+	stats_phase_add(STAT_PHASE_RENDER, phase_start);
+		
+	// 아레나 사용량 보고 (출력 내용과 섞이지 않도록 표준 에러로)
+	if (ctx->config.arena_stats) {
+		fprintf(stderr, "arena: peak %.2f MB in %u chunks of %zu KB, %.2f MB used by %u nodes (%zu bytes each)\n",
+				arena.peak_bytes / (1024.0 * 1024.0), arena.chunk_count, arena.chunk_bytes / 1024,
+				arena.used_bytes / (1024.0 * 1024.0), dir_tree.live_nodes, sizeof(DirTreeNode));
+	}
 		
-	// 메모리 해제
-	free_tree_node(root);
-	free(gd);
-	close(fd);
+	// 메모리 해제 (노드를 하나씩 따라가지 않고 청크만 해제)
+	dir_tree_cursor_destroy(&cursor);
+	dir_tree_destroy(&dir_tree);
+	arena_release(&arena);
 }
 
 /**
  * 트리 내 파일과 디렉토리 개수 계산 함수
  * 
- * @param node 개수를 세기 시작할 트리 노드 포인터
+ * @param tree 트리 저장소 포인터
+ * @param index 개수를 세기 시작할 트리 노드 인덱스
  * @param file_count 파일 개수를 저장할 포인터
  * @param dir_count 디렉토리 개수를 저장할 포인터
  */
-void	count_files_and_dirs(DirTreeNode* node, int* file_count, int* dir_count)
+void	count_files_and_dirs(const DirTree *tree, unsigned int index, int* file_count, int* dir_count)
 {
-	if (node == NULL) {
+	if (index == TREE_NIL) {
 		return;
 	}
 		
-	DirTreeNode* child = node->first_child;
-	while (child != NULL) {
-		if (S_ISDIR(child->file_type)) {
+	const DirTreeNode* node = dir_tree_node(tree, index);
+	for (unsigned int i = 0; i < node->child_count; i++) {
+		const DirTreeNode* child_node = dir_tree_node(tree, node->first_child + i);
+		if (S_ISDIR(child_node->mode)) {
 			(*dir_count)++;
 		} else {
 			(*file_count)++;
 		}
 		
-		// 자식 노드의 자식들도 재귀적으로 세기
-		count_files_and_dirs(child, file_count, dir_count);
-		
-		child = child->next_sibling;
+		// 하위 디렉토리의 자식들도 재귀적으로 세기
+		if (child_node->child_count > 0) {
+			count_files_and_dirs(tree, node->first_child + i, file_count, dir_count);
+		}
 	}
 }
@@ -0,0 +1,246 @@
+#include "ssu_ext2.h"
+
+#ifdef HAVE_IO_URING
+
+#include <sys/syscall.h>
+
+/**
+ * io_uring_setup 시스템 콜 래퍼 (liburing 없이 직접 호출)
+ */
+static int	sys_io_uring_setup(unsigned int entries, struct io_uring_params *params)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+/**
+ * io_uring_enter 시스템 콜 래퍼
+ */
+static int	sys_io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+{
+	STAT_ADD(syscalls, 1);
+	return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+/**
+ * io_uring 인스턴스를 만드는 함수
+ * 제출 큐(SQ), 완료 큐(CQ), SQE 배열을 매핑하고 각 포인터를 준비
+ *
+ * @param ring 초기화할 링 포인터
+ * @param entries 큐 깊이
+ * @return 성공 시 0, 커널이 지원하지 않거나 실패하면 음수 값 반환
+ */
+int	uring_init(Uring *ring, unsigned int entries)
+{
+	struct io_uring_params params;
+
+	memset(ring, 0, sizeof(Uring));
+	memset(&params, 0, sizeof(params));
+	ring->fd = -1;
+
+	int fd = sys_io_uring_setup(entries, &params);
+	if (fd < 0) {
+		return -1;
+	}
+	ring->fd = fd;
+
+	ring->sq_map_len = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	ring->cq_map_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_map_len > ring->sq_map_len) {
+			ring->sq_map_len = ring->cq_map_len;
+		}
+		ring->cq_map_len = 0;
+	}
+
+	ring->sq_map = mmap(NULL, ring->sq_map_len, PROT_READ | PROT_WRITE,
+						MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (ring->sq_map == MAP_FAILED) {
+		ring->sq_map = NULL;
+		uring_destroy(ring);
+		return -2;
+	}
+
+	if (ring->cq_map_len == 0) {
+		ring->cq_map = ring->sq_map;
+	} else {
+		ring->cq_map = mmap(NULL, ring->cq_map_len, PROT_READ | PROT_WRITE,
+							MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (ring->cq_map == MAP_FAILED) {
+			ring->cq_map = NULL;
+			uring_destroy(ring);
+			return -3;
+		}
+	}
+
+	ring->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE,
+					  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		uring_destroy(ring);
+		return -4;
+	}
+
+	unsigned char *sq = (unsigned char *)ring->sq_map;
+	unsigned char *cq = (unsigned char *)ring->cq_map;
+	ring->sq_head = (unsigned int *)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned int *)(sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned int *)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned int *)(sq + params.sq_off.array);
+	ring->cq_head = (unsigned int *)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned int *)(cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned int *)(cq + params.cq_off.ring_mask);
+	ring->cqes = cq + params.cq_off.cqes;
+	ring->entries = params.sq_entries;
+	return 0;
+}
+
+/**
+ * io_uring 인스턴스를 정리하는 함수
+ *
+ * @param ring 정리할 링 포인터
+ */
+void	uring_destroy(Uring *ring)
+{
+	if (ring->sqes != NULL) {
+		munmap(ring->sqes, ring->sqes_len);
+	}
+	if (ring->cq_map != NULL && ring->cq_map != ring->sq_map) {
+		munmap(ring->cq_map, ring->cq_map_len);
+	}
+	if (ring->sq_map != NULL) {
+		munmap(ring->sq_map, ring->sq_map_len);
+	}
+	if (ring->fd >= 0) {
+		close(ring->fd);
+	}
+	memset(ring, 0, sizeof(Uring));
+	ring->fd = -1;
+}
+
+/**
+ * 읽기 요청 하나를 제출 큐에 넣는 함수 (실제 제출은 uring_submit)
+ *
+ * @param ring 링 포인터
+ * @param fd 읽을 파일 디스크립터
+ * @param iov 읽은 데이터를 받을 iovec (완료될 때까지 유지되어야 함)
+ * @param offset 파일 오프셋
+ * @param user_data 완료 시 돌려받을 값
+ * @return 성공 시 0, 제출 큐가 가득 차면 -1
+ */
+int	uring_prep_readv(Uring *ring, int fd, const struct iovec *iov, off_t offset, unsigned long long user_data)
+{
+	unsigned int tail = *ring->sq_tail;
+	unsigned int head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+	if (tail - head >= ring->entries) {
+		return -1;
+	}
+
+	unsigned int index = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = &((struct io_uring_sqe *)ring->sqes)[index];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = IORING_OP_READV;
+	sqe->fd = fd;
+	sqe->addr = (unsigned long long)(uintptr_t)iov;
+	sqe->len = 1;
+	sqe->off = (unsigned long long)offset;
+	sqe->user_data = user_data;
+
+	ring->sq_array[index] = index;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->pending++;
+	return 0;
+}
+
+/**
+ * 제출 큐에 쌓인 요청을 커널에 제출하는 함수
+ *
+ * @param ring 링 포인터
+ * @return 제출한 요청 수, 실패 시 음수 값
+ */
+int	uring_submit(Uring *ring)
+{
+	while (ring->pending > 0) {
+		int submitted = sys_io_uring_enter(ring->fd, ring->pending, 0, 0);
+		if (submitted < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		ring->pending -= (unsigned int)submitted;
+		return submitted;
+	}
+	return 0;
+}
+
+/**
+ * 완료 큐에서 완료된 요청 하나를 꺼내는 함수
+ *
+ * @param ring 링 포인터
+ * @param wait 완료된 요청이 없으면 기다릴지 여부
+ * @param user_data 완료된 요청의 user_data를 저장할 포인터
+ * @param res 완료 결과 (읽은 바이트 수 또는 -errno)를 저장할 포인터
+ * @return 꺼냈으면 1, 없으면 0, 실패 시 음수 값
+ */
+int	uring_reap(Uring *ring, bool wait, unsigned long long *user_data, int *res)
+{
+	while (true) {
+		unsigned int head = *ring->cq_head;
+		unsigned int tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+		if (head != tail) {
+			struct io_uring_cqe *cqe = &((struct io_uring_cqe *)ring->cqes)[head & *ring->cq_mask];
+			*user_data = cqe->user_data;
+			*res = cqe->res;
+			__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+			return 1;
+		}
+		if (!wait) {
+			return 0;
+		}
+
+		if (sys_io_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+			return -1;
+		}
+	}
+}
+
+#else
+
+/**
+ * io_uring을 지원하지 않는 빌드에서는 항상 실패 (동기 경로로 동작)
+ */
+int	uring_init(Uring *ring, unsigned int entries)
+{
+	(void)entries;
+	memset(ring, 0, sizeof(Uring));
+	ring->fd = -1;
+	return -1;
+}
+
+void	uring_destroy(Uring *ring)
+{
+	(void)ring;
+}
+
+int	uring_prep_readv(Uring *ring, int fd, const struct iovec *iov, off_t offset, unsigned long long user_data)
+{
+	(void)ring; (void)fd; (void)iov; (void)offset; (void)user_data;
+	return -1;
+}
+
+int	uring_submit(Uring *ring)
+{
+	(void)ring;
+	return -1;
+}
+
+int	uring_reap(Uring *ring, bool wait, unsigned long long *user_data, int *res)
+{
+	(void)ring; (void)wait; (void)user_data; (void)res;
+	return -1;
+}
+
+#endif
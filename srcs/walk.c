@@ -0,0 +1,286 @@
+#include "ssu_ext2.h"
+
+/**
+ * 덱의 tail에 작업을 넣는 함수 (용량이 모자라면 늘림)
+ *
+ * @param deque 작업 덱 포인터
+ * @param task 넣을 작업
+ * @return 성공 시 0, 메모리 부족 시 -1
+ */
+static int	deque_push(WalkDeque *deque, WalkTask task)
+{
+	pthread_mutex_lock(&deque->lock);
+
+	// 앞쪽이 비어 있으면 당겨서 공간 확보
+	if (deque->tail == deque->capacity && deque->head > 0) {
+		memmove(deque->tasks, deque->tasks + deque->head,
+				(deque->tail - deque->head) * sizeof(WalkTask));
+		deque->tail -= deque->head;
+		deque->head = 0;
+	}
+	if (deque->tail == deque->capacity) {
+		unsigned int capacity = deque->capacity ? deque->capacity * 2 : WALK_DEQUE_INIT;
+		WalkTask *tasks = (WalkTask *)realloc(deque->tasks, capacity * sizeof(WalkTask));
+		if (tasks == NULL) {
+			pthread_mutex_unlock(&deque->lock);
+			return -1;
+		}
+		deque->tasks = tasks;
+		deque->capacity = capacity;
+	}
+
+	deque->tasks[deque->tail++] = task;
+	pthread_mutex_unlock(&deque->lock);
+	return 0;
+}
+
+/**
+ * 덱에서 작업을 꺼내는 함수
+ * 소유 스레드는 tail(가장 최근에 넣은 작업)에서, 다른 스레드는 head(가장 오래된 작업)에서 꺼냄
+ *
+ * @param deque 작업 덱 포인터
+ * @param steal 다른 스레드가 훔쳐가는 경우 true
+ * @param task 꺼낸 작업을 저장할 포인터
+ * @return 꺼냈으면 true, 비어 있으면 false
+ */
+static bool	deque_pop(WalkDeque *deque, bool steal, WalkTask *task)
+{
+	pthread_mutex_lock(&deque->lock);
+	if (deque->head == deque->tail) {
+		pthread_mutex_unlock(&deque->lock);
+		return false;
+	}
+
+	if (steal) {
+		*task = deque->tasks[deque->head++];
+	} else {
+		*task = deque->tasks[--deque->tail];
+	}
+	if (deque->head == deque->tail) {
+		deque->head = 0;
+		deque->tail = 0;
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return true;
+}
+
+/**
+ * 유휴 스레드를 깨우는 함수 (작업이 추가되었거나 탐색이 끝났을 때)
+ *
+ * @param pool 탐색 공유 상태 포인터
+ */
+static void	pool_notify(WalkPool *pool)
+{
+	__atomic_add_fetch(&pool->generation, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&pool->idle, __ATOMIC_SEQ_CST) > 0) {
+		pthread_mutex_lock(&pool->lock);
+		pthread_cond_broadcast(&pool->cond);
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+/**
+ * 디렉토리 하나를 읽어서 자식 노드를 디스크 순서대로 붙이고, 하위 디렉토리를 작업으로 추가하는 함수
+ *
+ * @param pool 탐색 공유 상태 포인터
+ * @param self 현재 스레드 번호
+ * @param task 처리할 작업
+ */
+static void	run_task(WalkPool *pool, unsigned int self, WalkTask task)
+{
+	// 자식 목록은 이 작업만 수정하므로 락 없이 구축 (디스크 순서 유지)
+	DirTreeCursor *cursor = &pool->cursors[self];
+	read_directory_entries(pool->ctx, task.inode_num, cursor, task.node, 0);
+
+	unsigned int pushed = 0;
+
+	// 하위 디렉토리를 작업으로 추가 (다른 스레드는 먼저 넣은 쪽부터 훔쳐감)
+	const DirTreeNode *node = dir_tree_node(cursor->tree, task.node);
+	for (unsigned int i = 0; i < node->child_count; i++) {
+		unsigned int child = node->first_child + i;
+		const DirTreeNode *child_node = dir_tree_node(cursor->tree, child);
+		if (!S_ISDIR(child_node->mode)) {
+			continue;
+		}
+
+		WalkTask sub = { child_node->inode_num, child };
+		__atomic_add_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+		if (deque_push(&pool->deques[self], sub) < 0) {
+			__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST);
+			__atomic_store_n(&pool->failed, true, __ATOMIC_RELAXED);
+			continue;
+		}
+		pushed++;
+	}
+
+	if (pushed > 0) {
+		pool_notify(pool);
+	}
+
+	// 현재 작업 완료 (마지막 작업이면 대기 중인 스레드들을 모두 깨워 종료시킴)
+	if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_SEQ_CST) == 0) {
+		pool_notify(pool);
+	}
+}
+
+/**
+ * 작업을 하나 구하는 함수
+ * 자신의 덱을 먼저 보고, 비어 있으면 다른 스레드의 덱에서 훔쳐옴
+ *
+ * @param pool 탐색 공유 상태 포인터
+ * @param self 현재 스레드 번호
+ * @param task 구한 작업을 저장할 포인터
+ * @return 구했으면 true, 모든 덱이 비어 있으면 false
+ */
+static bool	find_task(WalkPool *pool, unsigned int self, WalkTask *task)
+{
+	if (deque_pop(&pool->deques[self], false, task)) {
+		return true;
+	}
+	for (unsigned int i = 1; i < pool->thread_count; i++) {
+		unsigned int victim = (self + i) % pool->thread_count;
+		if (deque_pop(&pool->deques[victim], true, task)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * 탐색 스레드 루프
+ * 남은 작업이 없을 때까지 작업을 꺼내 처리하고, 훔칠 작업도 없으면 새 작업이 추가될 때까지 대기
+ *
+ * @param pool 탐색 공유 상태 포인터
+ * @param self 현재 스레드 번호
+ */
+static void	worker_loop(WalkPool *pool, unsigned int self)
+{
+	WalkTask task;
+
+	while (__atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) > 0) {
+		unsigned long seen = __atomic_load_n(&pool->generation, __ATOMIC_SEQ_CST);
+
+		if (find_task(pool, self, &task)) {
+			run_task(pool, self, task);
+			continue;
+		}
+
+		// 덱을 훑은 뒤로 작업이 추가되지 않았으면 대기
+		pthread_mutex_lock(&pool->lock);
+		__atomic_add_fetch(&pool->idle, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&pool->generation, __ATOMIC_SEQ_CST) == seen &&
+			__atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) > 0) {
+			pthread_cond_wait(&pool->cond, &pool->lock);
+		}
+		__atomic_sub_fetch(&pool->idle, 1, __ATOMIC_SEQ_CST);
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+/**
+ * pthread 시작 함수
+ */
+static void	*worker_main(void *arg)
+{
+	WalkWorkerArg *worker = (WalkWorkerArg *)arg;
+	worker_loop(worker->pool, worker->self);
+	stats_thread_flush();
+	trace_thread_flush();
+	return NULL;
+}
+
+/**
+ * 하위 디렉토리까지 모두 읽어서 트리를 구축하는 함수 (tree -r)
+ * 하위 디렉토리 하나가 작업 하나가 되어 스레드별 덱에 들어가고, 놀고 있는 스레드는 다른 덱에서 훔쳐감
+ * 각 디렉토리의 자식 목록은 그 디렉토리를 처리한 스레드가 디스크 순서대로 만들기 때문에
+ * 스레드 수와 관계없이 결과 트리는 단일 스레드 탐색과 같음
+ *
+ * @param ctx 이미지 컨텍스트 포인터
+ * @param dir_inode_num 시작 디렉토리 inode 번호
+ * @param tree 노드를 만들 트리 저장소 포인터 (스레드마다 커서를 두고 동시에 채움)
+ * @param root 시작 디렉토리 트리 노드 인덱스
+ * @return 성공 시 0, 실패 시 음수 값 반환
+ */
+int	walk_directory_tree(Ext2Context *ctx, unsigned int dir_inode_num, DirTree *tree, unsigned int root)
+{
+	unsigned int thread_count = ctx->config.walk_threads;
+	DirTreeCursor single;
+
+	// 단일 스레드면 기존 재귀 탐색 사용
+	if (thread_count <= 1) {
+		dir_tree_cursor_init(&single, tree);
+		int result = read_directory_entries(ctx, dir_inode_num, &single, root, 1);
+		dir_tree_cursor_destroy(&single);
+		return result < 0 ? -1 : 0;
+	}
+
+	WalkPool pool;
+	memset(&pool, 0, sizeof(WalkPool));
+	pool.ctx = ctx;
+	pool.thread_count = thread_count;
+	pool.deques = (WalkDeque *)calloc(thread_count, sizeof(WalkDeque));
+	pthread_t *threads = (pthread_t *)calloc(thread_count, sizeof(pthread_t));
+	WalkWorkerArg *args = (WalkWorkerArg *)calloc(thread_count, sizeof(WalkWorkerArg));
+	pool.cursors = (DirTreeCursor *)calloc(thread_count, sizeof(DirTreeCursor));
+	if (pool.deques == NULL || threads == NULL || args == NULL || pool.cursors == NULL) {
+		free(pool.deques);
+		free(threads);
+		free(args);
+		free(pool.cursors);
+		dir_tree_cursor_init(&single, tree);
+		int result = read_directory_entries(ctx, dir_inode_num, &single, root, 1);
+		dir_tree_cursor_destroy(&single);
+		return result < 0 ? -1 : 0;
+	}
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.cond, NULL);
+	for (unsigned int i = 0; i < thread_count; i++) {
+		pthread_mutex_init(&pool.deques[i].lock, NULL);
+		dir_tree_cursor_init(&pool.cursors[i], tree);
+	}
+
+	// 시작 디렉토리를 0번 스레드(호출한 스레드)의 덱에 넣음
+	WalkTask first = { dir_inode_num, root };
+	pool.pending = 1;
+	if (deque_push(&pool.deques[0], first) < 0) {
+		pool.pending = 0;
+		pool.failed = true;
+	}
+
+	unsigned int started = 1;
+	for (unsigned int i = 1; i < thread_count; i++) {
+		args[i].pool = &pool;
+		args[i].self = i;
+		if (pthread_create(&threads[i], NULL, worker_main, &args[i]) != 0) {
+			#ifdef DEBUG_TREE
+				fprintf(stderr, "pthread_create failed, walking with %u threads\n", started);
+			#endif
+			break;
+		}
+		started++;
+	}
+
+	worker_loop(&pool, 0);
+
+	for (unsigned int i = 1; i < started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	#ifdef DEBUG_TREE
+		fprintf(stderr, "Parallel walk finished with %u threads%s\n",
+				started, pool.failed ? " (some directories skipped)" : "");
+	#endif
+
+	for (unsigned int i = 0; i < thread_count; i++) {
+		pthread_mutex_destroy(&pool.deques[i].lock);
+		dir_tree_cursor_destroy(&pool.cursors[i]);
+		free(pool.deques[i].tasks);
+	}
+	pthread_mutex_destroy(&pool.lock);
+	pthread_cond_destroy(&pool.cond);
+	free(pool.deques);
+	free(pool.cursors);
+	free(threads);
+	free(args);
+	return pool.failed ? -2 : 0;
+}